@@ -15,6 +15,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include "AI.h"
 
+#include "Attribute.h"
 #include "audio/Audio.h"
 #include "Command.h"
 #include "DistanceMap.h"
@@ -266,7 +267,7 @@ namespace {
 	bool ShouldRefuel(const Ship &ship, const DistanceMap &route, double fuelCapacity = 0.)
 	{
 		if(!fuelCapacity)
-			fuelCapacity = ship.Attributes().Get("fuel capacity");
+			fuelCapacity = ship.Attributes().Get(Attribute("fuel capacity"));
 
 		const System *from = ship.GetSystem();
 		const bool systemHasFuel = from->HasFuelFor(ship) && fuelCapacity;
@@ -358,6 +359,10 @@ namespace {
 
 	// The minimum speed advantage a ship has to have to consider running away.
 	const double SAFETY_MULTIPLIER = 1.1;
+
+	// The number of ships whose aiming and firing is decided by each task.
+	// This is fixed so that the results do not depend on the CPU.
+	constexpr size_t SHIPS_PER_FIRE_CONTROL_CHUNK = 16;
 }
 
 
@@ -696,6 +701,7 @@ void AI::Step(Command &activeCommands)
 	bool opportunisticEscorts = !Preferences::Has("Turrets focus fire");
 	bool fightersRetreat = Preferences::Has("Damaged fighters retreat");
 	const int npcMaxMiningTime = GameData::GetGamerules().NPCMaxMiningTime();
+	fireControlCount = 0;
 	for(const auto &it : ships)
 	{
 		// A destroyed ship can't do anything.
@@ -749,6 +755,7 @@ void AI::Step(Command &activeCommands)
 
 		Command command;
 		firingCommands.SetHardpoints(it->Weapons().size());
+		FireControl *fireControl = nullptr;
 		if(it->IsYours())
 		{
 			if(it->HasBays() && thisIsLaunching)
@@ -796,8 +803,8 @@ void AI::Step(Command &activeCommands)
 			// government to this ship, and this ship has scanning capabilities
 			// then it was attempting to scan the target. This isn't a perfect
 			// assumption, but should be good enough for now.
-			bool cargoScan = it->Attributes().Get("cargo scan power");
-			bool outfitScan = it->Attributes().Get("outfit scan power");
+			bool cargoScan = it->Attributes().Get(Attribute("cargo scan power"));
+			bool outfitScan = it->Attributes().Get(Attribute("outfit scan power"));
 			if((cargoScan || outfitScan) && target && !target->IsDisabled()
 				&& !target->GetGovernment()->IsEnemy(gov) && target->GetGovernment() != gov)
 			{
@@ -821,21 +828,17 @@ void AI::Step(Command &activeCommands)
 				it->SetTargetShip(target);
 			}
 		}
+		// Aiming and firing only reads the state of other ships, so it is decided
+		// for every ship at once after this loop, using the targets chosen so far.
 		if(isPresent)
-		{
-			AimTurrets(*it, firingCommands, it->IsYours() ? opportunisticEscorts : personality.IsOpportunistic());
-			if(targetAsteroid)
-				AutoFire(*it, firingCommands, *targetAsteroid);
-			else
-				AutoFire(*it, firingCommands);
-		}
+			fireControl = &DeferFireControl(*it, it->IsYours() ? opportunisticEscorts : personality.IsOpportunistic());
 
 		// If this ship is hyperspacing, or in the act of
 		// launching or landing, it can't do anything else.
 		if(it->IsHyperspacing() || it->Zoom() < 1.)
 		{
 			it->SetCommands(command);
-			it->SetCommands(firingCommands);
+			SetFiringCommands(*it, fireControl);
 			continue;
 		}
 
@@ -910,7 +913,7 @@ void AI::Step(Command &activeCommands)
 			{
 				it->SetTargetShip(shipToAssist);
 				it->SetCommands(command);
-				it->SetCommands(firingCommands);
+				SetFiringCommands(*it, fireControl);
 				continue;
 			}
 		}
@@ -942,7 +945,7 @@ void AI::Step(Command &activeCommands)
 			// Flock between allied, in-system ships.
 			DoSwarming(*it, command, target);
 			it->SetCommands(command);
-			it->SetCommands(firingCommands);
+			SetFiringCommands(*it, fireControl);
 			continue;
 		}
 
@@ -962,7 +965,7 @@ void AI::Step(Command &activeCommands)
 		{
 			DoSurveillance(*it, command, target);
 			it->SetCommands(command);
-			it->SetCommands(firingCommands);
+			SetFiringCommands(*it, fireControl);
 			continue;
 		}
 
@@ -970,7 +973,7 @@ void AI::Step(Command &activeCommands)
 		if(isPresent && personality.Harvests() && DoHarvesting(*it, command))
 		{
 			it->SetCommands(command);
-			it->SetCommands(firingCommands);
+			SetFiringCommands(*it, fireControl);
 			continue;
 		}
 
@@ -989,7 +992,7 @@ void AI::Step(Command &activeCommands)
 				}
 				DoMining(*it, command);
 				it->SetCommands(command);
-				it->SetCommands(firingCommands);
+				SetFiringCommands(*it, fireControl);
 				continue;
 			}
 			// Fighters and drones should assist their parent's mining operation if they cannot
@@ -1003,7 +1006,7 @@ void AI::Step(Command &activeCommands)
 					MoveToAttack(*it, command, *minable);
 					AutoFire(*it, firingCommands, *minable);
 					it->SetCommands(command);
-					it->SetCommands(firingCommands);
+					SetFiringCommands(*it, fireControl);
 					continue;
 				}
 			}
@@ -1098,7 +1101,7 @@ void AI::Step(Command &activeCommands)
 				MoveTo(*it, command, parent->Position(), parent->Velocity(), 40., .8);
 				command |= Command::BOARD;
 				it->SetCommands(command);
-				it->SetCommands(firingCommands);
+				SetFiringCommands(*it, fireControl);
 				continue;
 			}
 			// If we get here, it means that the ship has not decided to return
@@ -1147,7 +1150,7 @@ void AI::Step(Command &activeCommands)
 			MoveIndependent(*it, command);
 		else if(parent->GetSystem() != it->GetSystem())
 		{
-			if(personality.IsStaying() || !it->Attributes().Get("fuel capacity"))
+			if(personality.IsStaying() || !it->Attributes().Get(Attribute("fuel capacity")))
 				MoveIndependent(*it, command);
 			else
 				MoveEscort(*it, command);
@@ -1199,7 +1202,109 @@ void AI::Step(Command &activeCommands)
 		DoScatter(*it, command);
 
 		it->SetCommands(command);
-		it->SetCommands(firingCommands);
+		SetFiringCommands(*it, fireControl);
+	}
+
+	DoFireControl();
+}
+
+
+
+// Record that the given ship is ready to aim and fire at its current targets.
+AI::FireControl &AI::DeferFireControl(Ship &ship, bool opportunistic)
+{
+	if(fireControlCount == fireControls.size())
+		fireControls.emplace_back();
+	FireControl &fireControl = fireControls[fireControlCount++];
+	fireControl.ship = &ship;
+	fireControl.target = ship.GetTargetShip();
+	fireControl.targetAsteroid = ship.GetTargetAsteroid();
+	fireControl.opportunistic = opportunistic;
+	fireControl.isCommitted = false;
+	return fireControl;
+}
+
+
+
+// Apply the firing commands the given ship has decided on, unless its aiming
+// and firing is yet to be decided, in which case they are applied afterwards.
+void AI::SetFiringCommands(Ship &ship, FireControl *fireControl)
+{
+	if(!fireControl)
+		ship.SetCommands(firingCommands);
+	else
+	{
+		fireControl->command = firingCommands;
+		fireControl->isCommitted = true;
+	}
+}
+
+
+
+// Decide how every ship that was ready to do so this step should aim and fire,
+// using the worker threads, and then apply those firing commands in order.
+void AI::DoFireControl()
+{
+	// Masks are updated lazily, which must not happen in several threads at
+	// once, so bring every possible target up to date first.
+	for(const auto &roster : governmentRosters)
+		for(const Ship *ship : roster.second)
+			ship->GetMask(step);
+	for(size_t i = 0; i < fireControlCount; ++i)
+	{
+		const FireControl &fireControl = fireControls[i];
+		if(fireControl.target)
+			fireControl.target->GetMask(step);
+		if(fireControl.targetAsteroid)
+			fireControl.targetAsteroid->GetMask(step);
+	}
+
+	auto decide = [this](size_t begin, size_t end)
+	{
+		for(size_t i = begin; i < end; ++i)
+		{
+			FireControl &fireControl = fireControls[i];
+			if(!fireControl.isCommitted)
+				continue;
+			const Ship &ship = *fireControl.ship;
+			AimTurrets(ship, fireControl.command, fireControl.target.get(), fireControl.targetAsteroid.get(),
+				fireControl.opportunistic);
+			if(fireControl.targetAsteroid)
+				AutoFire(ship, fireControl.command, *fireControl.targetAsteroid);
+			else
+				AutoFire(ship, fireControl.command, fireControl.target);
+		}
+	};
+	if(fireControlCount <= SHIPS_PER_FIRE_CONTROL_CHUNK)
+		decide(0, fireControlCount);
+	else
+	{
+		for(size_t begin = 0; begin < fireControlCount; begin += SHIPS_PER_FIRE_CONTROL_CHUNK)
+		{
+			size_t end = min(begin + SHIPS_PER_FIRE_CONTROL_CHUNK, fireControlCount);
+			uint64_t seed = (static_cast<uint64_t>(Random::Int()) << 32) | Random::Int();
+			queue.Run([&decide, begin, end, seed]
+			{
+				// Every thread has its own generator. Seeding it here means that
+				// which worker picks up this chunk does not change its decisions.
+				Random::Seed(seed);
+				decide(begin, end);
+			});
+		}
+		queue.Wait();
+		// Rethrow any exception thrown by one of the tasks.
+		queue.ProcessSyncTasks();
+	}
+
+	for(size_t i = 0; i < fireControlCount; ++i)
+	{
+		FireControl &fireControl = fireControls[i];
+		if(fireControl.isCommitted)
+			fireControl.ship->SetCommands(fireControl.command);
+		// Don't keep the ships or their targets alive until the next step.
+		fireControl.ship = nullptr;
+		fireControl.target.reset();
+		fireControl.targetAsteroid.reset();
 	}
 }
 
@@ -1469,8 +1574,18 @@ shared_ptr<Ship> AI::FindTarget(const Ship &ship) const
 	if(!person.IsDaring() && strengthIt != shipStrength.end())
 		maxStrength = 2 * strengthIt->second;
 
-	// Get a list of all targetable, hostile ships in this system.
-	const auto enemies = GetShipsList(ship, true);
+	// Get a list of the targetable, hostile ships in this system that could be
+	// chosen. Nemesis ships prefer the player's ships at any range, and hunting
+	// ships search the whole system. Any other ship only picks a foe whose range
+	// below ends up less than the starting value of "closest," and the bonuses
+	// subtracted from that range add up to at most 3500 (500 for a previous
+	// target, 1000 for scorn, and 2000 for a ship to plunder). A second from
+	// now, both ships may also have moved by up to their speed times 60.
+	double searchRange = -1.;
+	if(!person.IsHunting() && !person.IsNemesis())
+		searchRange = closest + 500. + 1000. + 2000. * canPlunder
+			+ 60. * (ship.Velocity().Length() + maxRosterSpeed);
+	const auto enemies = GetShipsList(ship, true, searchRange);
 	for(const auto &foe : enemies)
 	{
 		// If this is a "nemesis" ship and it has found one of the player's
@@ -1569,8 +1684,8 @@ shared_ptr<Ship> AI::FindNonHostileTarget(const Ship &ship) const
 	// additional minute.
 	int forfeitTime = searchTime + 3600;
 
-	double cargoScan = ship.Attributes().Get("cargo scan power");
-	double outfitScan = ship.Attributes().Get("outfit scan power");
+	double cargoScan = ship.Attributes().Get(Attribute("cargo scan power"));
+	double outfitScan = ship.Attributes().Get(Attribute("outfit scan power"));
 	auto cargoScansIt = cargoScans.find(&ship);
 	auto outfitScansIt = outfitScans.find(&ship);
 	auto scanTimeIt = scanTime.find(&ship);
@@ -1648,11 +1763,25 @@ vector<Ship *> AI::GetShipsList(const Ship &ship, bool targetEnemies, double max
 	const auto it = rosters.find(ship.GetGovernment());
 	if(it != rosters.end() && !it->second.empty())
 	{
-		targets.reserve(it->second.size());
-
 		const System *here = ship.GetSystem();
 		const Point &p = ship.Position();
-		for(const auto &target : it->second)
+
+		// For a limited range, only consider the ships in nearby cells of each
+		// roster's grid. The grids are visited in the same order as the cached
+		// list was assembled, so the result is the same as scanning the list.
+		const vector<Ship *> *candidates = &it->second;
+		thread_local vector<Ship *> nearby;
+		if(maxRange < numeric_limits<double>::infinity())
+		{
+			const auto &grids = targetEnemies ? enemyGrids : allyGrids;
+			nearby.clear();
+			for(const ShipGrid *grid : grids.at(ship.GetGovernment()))
+				grid->Query(p, maxRange, nearby);
+			candidates = &nearby;
+		}
+
+		targets.reserve(candidates->size());
+		for(const auto &target : *candidates)
 			if(target->IsTargetable() && target->GetSystem() == here
 					&& !(target->IsHyperspacing() && target->Velocity().Length() > 10.)
 					&& p.Distance(target->Position()) < maxRange
@@ -1868,8 +1997,8 @@ void AI::MoveIndependent(Ship &ship, Command &command) const
 	else if(target)
 	{
 		// An AI ship that is targeting a non-hostile ship should scan it, or move on.
-		bool cargoScan = ship.Attributes().Get("cargo scan power");
-		bool outfitScan = ship.Attributes().Get("outfit scan power");
+		bool cargoScan = ship.Attributes().Get(Attribute("cargo scan power"));
+		bool outfitScan = ship.Attributes().Get(Attribute("outfit scan power"));
 		// De-target if the target left my system.
 		if(ship.GetSystem() != target->GetSystem())
 		{
@@ -2003,7 +2132,7 @@ void AI::MoveIndependent(Ship &ship, Command &command) const
 	else if(ship.GetTargetStellar())
 	{
 		MoveToPlanet(ship, command);
-		if(!shouldStay && ship.Attributes().Get("fuel capacity") && ship.GetTargetStellar()->HasSprite()
+		if(!shouldStay && ship.Attributes().Get(Attribute("fuel capacity")) && ship.GetTargetStellar()->HasSprite()
 				&& ship.GetTargetStellar()->GetPlanet() && ship.GetTargetStellar()->GetPlanet()->CanLand(ship))
 			command |= Command::LAND;
 		else if(ship.Position().Distance(ship.GetTargetStellar()->Position()) < 100.)
@@ -2026,7 +2155,7 @@ void AI::MoveEscort(Ship &ship, Command &command)
 {
 	const Ship &parent = *ship.GetParent();
 	const System *currentSystem = ship.GetSystem();
-	bool hasFuelCapacity = ship.Attributes().Get("fuel capacity");
+	bool hasFuelCapacity = ship.Attributes().Get(Attribute("fuel capacity"));
 	bool needsFuel = ship.NeedsFuel();
 	bool isStaying = ship.GetPersonality().IsStaying() || !hasFuelCapacity;
 	bool parentIsHere = (currentSystem == parent.GetSystem());
@@ -2307,9 +2436,9 @@ bool AI::ShouldDock(const Ship &ship, const Ship &parent, const System *playerSy
 
 	// If a carried ship has fuel capacity but is very low, it should return if
 	// the parent can refuel it.
-	double maxFuel = ship.Attributes().Get("fuel capacity");
+	double maxFuel = ship.Attributes().Get(Attribute("fuel capacity"));
 	if(maxFuel && ship.Fuel() < .005 && parent.JumpNavigation().JumpFuel() < parent.Fuel() *
-			parent.Attributes().Get("fuel capacity") - maxFuel)
+			parent.Attributes().Get(Attribute("fuel capacity")) - maxFuel)
 		return true;
 
 	// NPC ships should always transfer cargo. Player ships should only
@@ -2453,7 +2582,7 @@ bool AI::Stop(Ship &ship, Command &command, double maxSpeed, const Point directi
 
 	// If you have a reverse thruster, figure out whether using it is faster
 	// than turning around and using your main thruster.
-	if(ship.Attributes().Get("reverse thrust"))
+	if(ship.Attributes().Get(Attribute("reverse thrust")))
 	{
 		// Figure out your stopping time using your main engine:
 		double degreesToTurn = TO_DEG * acos(min(1., max(-1., -velocity.Unit().Dot(angle.Unit()))));
@@ -2499,7 +2628,7 @@ bool AI::Stop(Ship &ship, Command &command, double maxSpeed, const Point directi
 void AI::PrepareForHyperspace(Ship &ship, Command &command)
 {
 	bool hasHyperdrive = ship.JumpNavigation().HasHyperdrive();
-	double scramThreshold = ship.Attributes().Get("scram drive");
+	double scramThreshold = ship.Attributes().Get(Attribute("scram drive"));
 	bool hasJumpDrive = ship.JumpNavigation().HasJumpDrive();
 	if(!hasHyperdrive && !hasJumpDrive)
 		return;
@@ -2549,9 +2678,9 @@ void AI::PrepareForHyperspace(Ship &ship, Command &command)
 	}
 	// If we're a jump drive, just stop.
 	else if(isJump)
-		Stop(ship, command, ship.Attributes().Get("jump speed"));
+		Stop(ship, command, ship.Attributes().Get(Attribute("jump speed")));
 	// Else stop in the fastest way to end facing in the right direction
-	else if(Stop(ship, command, ship.Attributes().Get("jump speed"), direction))
+	else if(Stop(ship, command, ship.Attributes().Get(Attribute("jump speed")), direction))
 		command.SetTurn(TurnToward(ship, direction));
 }
 
@@ -2663,11 +2792,11 @@ void AI::KeepStation(Ship &ship, Command &command, const Body &target)
 
 	// Determine whether to apply thrust.
 	Point drag = ship.Velocity() * ship.DragForce();
-	if(ship.Attributes().Get("reverse thrust"))
+	if(ship.Attributes().Get(Attribute("reverse thrust")))
 	{
 		// Don't take drag into account when reverse thrusting, because this
 		// estimate of how it will be applied can be quite inaccurate.
-		Point a = (unit * (-ship.Attributes().Get("reverse thrust") / mass)).Unit();
+		Point a = (unit * (-ship.Attributes().Get(Attribute("reverse thrust")) / mass)).Unit();
 		double direction = positionWeight * positionDelta.Dot(a) / POSITION_DEADBAND
 			+ velocityWeight * velocityDelta.Dot(a) / VELOCITY_DEADBAND;
 		if(direction > THRUST_DEADBAND)
@@ -2791,7 +2920,7 @@ void AI::MoveToAttack(Ship &ship, Command &command, const Body &target)
 	const auto facing = ship.Facing().Unit().Dot(direction.Unit());
 	// If the ship has reverse thrusters and the target is behind it, we can
 	// use them to reach the target more quickly.
-	if(facing < -.75 && ship.Attributes().Get("reverse thrust"))
+	if(facing < -.75 && ship.Attributes().Get(Attribute("reverse thrust")))
 		command |= Command::BACK;
 	// This isn't perfect, but it works well enough.
 	else if((facing >= 0. && direction.Length() > diameter)
@@ -2840,18 +2969,18 @@ void AI::PickUp(Ship &ship, Command &command, const Body &target)
 // energy strain, or undue thermal loads if almost overheated.
 bool AI::ShouldUseAfterburner(Ship &ship)
 {
-	if(!ship.Attributes().Get("afterburner thrust"))
+	if(!ship.Attributes().Get(Attribute("afterburner thrust")))
 		return false;
 
-	double fuel = ship.Fuel() * ship.Attributes().Get("fuel capacity");
-	double neededFuel = ship.Attributes().Get("afterburner fuel");
-	double energy = ship.Energy() * ship.Attributes().Get("energy capacity");
-	double neededEnergy = ship.Attributes().Get("afterburner energy");
+	double fuel = ship.Fuel() * ship.Attributes().Get(Attribute("fuel capacity"));
+	double neededFuel = ship.Attributes().Get(Attribute("afterburner fuel"));
+	double energy = ship.Energy() * ship.Attributes().Get(Attribute("energy capacity"));
+	double neededEnergy = ship.Attributes().Get(Attribute("afterburner energy"));
 	if(energy == 0.)
-		energy = ship.Attributes().Get("energy generation")
-				+ 0.2 * ship.Attributes().Get("solar collection")
-				- ship.Attributes().Get("energy consumption");
-	double outputHeat = ship.Attributes().Get("afterburner heat") / (100 * ship.Mass());
+		energy = ship.Attributes().Get(Attribute("energy generation"))
+				+ 0.2 * ship.Attributes().Get(Attribute("solar collection"))
+				- ship.Attributes().Get(Attribute("energy consumption"));
+	double outputHeat = ship.Attributes().Get(Attribute("afterburner heat")) / (100 * ship.Mass());
 	if((!neededFuel || fuel - neededFuel > ship.JumpNavigation().JumpFuel())
 			&& (!neededEnergy || neededEnergy / energy < 0.25)
 			&& (!outputHeat || ship.Heat() + outputHeat < .9))
@@ -2976,7 +3105,7 @@ void AI::DoSurveillance(Ship &ship, Command &command, shared_ptr<Ship> &target)
 	{
 		// Approach the planet and "land" on it (i.e. scan it).
 		MoveToPlanet(ship, command);
-		double atmosphereScan = ship.Attributes().Get("atmosphere scan");
+		double atmosphereScan = ship.Attributes().Get(Attribute("atmosphere scan"));
 		double distance = ship.Position().Distance(ship.GetTargetStellar()->Position());
 		if(distance < atmosphereScan && !Random::Int(100))
 			ship.SetTargetStellar(nullptr);
@@ -2986,8 +3115,8 @@ void AI::DoSurveillance(Ship &ship, Command &command, shared_ptr<Ship> &target)
 	else if(target)
 	{
 		// Approach and scan the targeted, friendly ship's cargo or outfits.
-		bool cargoScan = ship.Attributes().Get("cargo scan power");
-		bool outfitScan = ship.Attributes().Get("outfit scan power");
+		bool cargoScan = ship.Attributes().Get(Attribute("cargo scan power"));
+		bool outfitScan = ship.Attributes().Get(Attribute("outfit scan power"));
 		// If the pointer to the target ship exists, it is targetable and in-system.
 		const Government *gov = ship.GetGovernment();
 		bool mustScanCargo = cargoScan && !Has(gov, target, ShipEvent::SCAN_CARGO);
@@ -3015,8 +3144,8 @@ void AI::DoSurveillance(Ship &ship, Command &command, shared_ptr<Ship> &target)
 		// ships in high spawn rate systems don't build up over time, as they always have
 		// a new ship they can try to scan.
 		vector<Ship *> targetShips;
-		bool cargoScan = ship.Attributes().Get("cargo scan power");
-		bool outfitScan = ship.Attributes().Get("outfit scan power");
+		bool cargoScan = ship.Attributes().Get(Attribute("cargo scan power"));
+		bool outfitScan = ship.Attributes().Get(Attribute("outfit scan power"));
 		auto cargoScansIt = cargoScans.find(&ship);
 		auto outfitScansIt = outfitScans.find(&ship);
 		auto scanTimeIt = scanTime.find(&ship);
@@ -3040,7 +3169,7 @@ void AI::DoSurveillance(Ship &ship, Command &command, shared_ptr<Ship> &target)
 
 		// Consider scanning any planetary object in the system, if able.
 		vector<const StellarObject *> targetPlanets;
-		double atmosphereScan = ship.Attributes().Get("atmosphere scan");
+		double atmosphereScan = ship.Attributes().Get(Attribute("atmosphere scan"));
 		if(atmosphereScan)
 			for(const StellarObject &object : system->Objects())
 				if(object.HasSprite() && !object.IsStar() && !object.IsStation())
@@ -3210,12 +3339,12 @@ bool AI::DoCloak(Ship &ship, Command &command)
 		return false;
 	// Never cloak if it will cause you to be stranded.
 	const Outfit &attributes = ship.Attributes();
-	double cloakingFuel = attributes.Get("cloaking fuel");
+	double cloakingFuel = attributes.Get(Attribute("cloaking fuel"));
 	double fuelCost = cloakingFuel
-		+ attributes.Get("fuel consumption") - attributes.Get("fuel generation");
-	if(cloakingFuel && !attributes.Get("ramscoop"))
+		+ attributes.Get(Attribute("fuel consumption")) - attributes.Get(Attribute("fuel generation"));
+	if(cloakingFuel && !attributes.Get(Attribute("ramscoop")))
 	{
-		double fuel = ship.Fuel() * attributes.Get("fuel capacity");
+		double fuel = ship.Fuel() * attributes.Get(Attribute("fuel capacity"));
 		int steps = ceil((1. - ship.Cloaking()) / cloakingSpeed);
 		// Only cloak if you will be able to fully cloak and also maintain it
 		// for as long as it will take you to reach full cloak.
@@ -3271,7 +3400,7 @@ bool AI::DoCloak(Ship &ship, Command &command)
 	bool cloakFreely = (fuelCost <= 0.) && !ship.GetShipToAssist() && !ship.IsYours();
 	// If this ship is injured / repairing, it should cloak while under threat.
 	bool cloakToRepair = (ship.Health() < RETREAT_HEALTH + hysteresis)
-			&& (attributes.Get("shield generation") || attributes.Get("hull repair rate"));
+			&& (attributes.Get(Attribute("shield generation")) || attributes.Get(Attribute("hull repair rate")));
 	if(cloakToRepair && (cloakFreely || range < 2000. * (1. + hysteresis)))
 	{
 		command |= Command::CLOAK;
@@ -3398,8 +3527,8 @@ bool AI::DoSecretive(Ship &ship, Command &command)
 		Point scanningPos = scanningShip->Position();
 		Point pos = ship.Position();
 
-		double cargoDistance = scanningShip->Attributes().Get("cargo scan power");
-		double outfitDistance = scanningShip->Attributes().Get("outfit scan power");
+		double cargoDistance = scanningShip->Attributes().Get(Attribute("cargo scan power"));
+		double outfitDistance = scanningShip->Attributes().Get(Attribute("outfit scan power"));
 
 		double maxScanRange = max(cargoDistance, outfitDistance);
 		double distance = scanningPos.DistanceSquared(pos) * .0001;
@@ -3456,10 +3585,10 @@ Point AI::StoppingPoint(const Ship &ship, const Point &targetVelocity, bool &sho
 	// The average term's value will be v / 2. So:
 	stopDistance += .5 * v * v / acceleration;
 
-	if(ship.Attributes().Get("reverse thrust"))
+	if(ship.Attributes().Get(Attribute("reverse thrust")))
 	{
 		// Figure out your reverse thruster stopping distance:
-		double reverseAcceleration = ship.Attributes().Get("reverse thrust") / ship.InertialMass();
+		double reverseAcceleration = ship.Attributes().Get(Attribute("reverse thrust")) / ship.InertialMass();
 		double reverseDistance = v * (180. - degreesToTurn) / turnRate;
 		reverseDistance += .5 * v * v / reverseAcceleration;
 
@@ -3522,12 +3651,12 @@ Point AI::TargetAim(const Ship &ship, const Body &target)
 
 
 
-// Aim the given ship's turrets.
-void AI::AimTurrets(const Ship &ship, FireCommand &command, bool opportunistic) const
+// Aim the given ship's turrets, at the given targets or at any nearby enemy.
+void AI::AimTurrets(const Ship &ship, FireCommand &command, const Ship *currentTarget,
+	const Minable *targetAsteroid, bool opportunistic) const
 {
 	// First, get the set of potential hostile ships.
 	auto targets = vector<const Body *>();
-	const Ship *currentTarget = ship.GetTargetShip().get();
 	if(opportunistic || !currentTarget || !currentTarget->IsTargetable())
 	{
 		// Find the maximum range of any of this ship's turrets.
@@ -3557,8 +3686,8 @@ void AI::AimTurrets(const Ship &ship, FireCommand &command, bool opportunistic)
 	else
 		targets.push_back(currentTarget);
 	// If this ship is mining, consider aiming at its target asteroid.
-	if(ship.GetTargetAsteroid())
-		targets.push_back(ship.GetTargetAsteroid().get());
+	if(targetAsteroid)
+		targets.push_back(targetAsteroid);
 
 	// If there are no targets to aim at, opportunistic turrets should sweep
 	// back and forth at random, with the sweep centered on the "outward-facing"
@@ -3702,7 +3831,8 @@ void AI::AimTurrets(const Ship &ship, FireCommand &command, bool opportunistic)
 
 
 // Fire whichever of the given ship's weapons can hit a hostile target.
-void AI::AutoFire(const Ship &ship, FireCommand &command, bool secondary, bool isFlagship) const
+void AI::AutoFire(const Ship &ship, FireCommand &command, shared_ptr<Ship> currentTarget,
+	bool secondary, bool isFlagship) const
 {
 	const Personality &person = ship.GetPersonality();
 	if(person.IsPacifist() || ship.CannotAct(Ship::ActionType::FIRE))
@@ -3726,7 +3856,6 @@ void AI::AutoFire(const Ship &ship, FireCommand &command, bool secondary, bool i
 	// Special case: your target is not your enemy. Do not fire, because you do
 	// not want to risk damaging that target. Ships will target friendly ships
 	// while assisting and performing surveillance.
-	shared_ptr<Ship> currentTarget = ship.GetTargetShip();
 	const Government *gov = ship.GetGovernment();
 	bool friendlyOverride = false;
 	bool disabledOverride = false;
@@ -3814,7 +3943,7 @@ void AI::AutoFire(const Ship &ship, FireCommand &command, bool secondary, bool i
 		// fuel that you cannot leave the system if necessary.
 		if(weapon->FiringFuel())
 		{
-			double fuel = ship.Fuel() * ship.Attributes().Get("fuel capacity");
+			double fuel = ship.Fuel() * ship.Attributes().Get(Attribute("fuel capacity"));
 			fuel -= weapon->FiringFuel();
 			// If the ship is not ever leaving this system, it does not need to
 			// reserve any fuel.
@@ -3996,7 +4125,7 @@ double AI::RendezvousTime(const Point &p, const Point &v, double vp)
 // on the player's preferences.
 bool AI::TargetMinable(Ship &ship) const
 {
-	double scanRangeMetric = 10000. * ship.Attributes().Get("asteroid scan power");
+	double scanRangeMetric = 10000. * ship.Attributes().Get(Attribute("asteroid scan power"));
 	if(!scanRangeMetric)
 		return false;
 	const bool findClosest = Preferences::Has("Target asteroid based on");
@@ -4509,12 +4638,13 @@ void AI::MovePlayer(Ship &ship, Command &activeCommands)
 		TargetMinable(ship);
 	}
 
-	const shared_ptr<const Ship> target = ship.GetTargetShip();
-	AimTurrets(ship, firingCommands, !Preferences::Has("Turrets focus fire"));
+	const shared_ptr<Ship> target = ship.GetTargetShip();
+	AimTurrets(ship, firingCommands, target.get(), ship.GetTargetAsteroid().get(),
+		!Preferences::Has("Turrets focus fire"));
 	if(Preferences::GetAutoFire() != Preferences::AutoFire::OFF && !ship.IsBoarding()
 			&& !(autoPilot | activeCommands).Has(Command::LAND | Command::JUMP | Command::FLEET_JUMP | Command::BOARD)
 			&& (!target || target->GetGovernment()->IsEnemy()))
-		AutoFire(ship, firingCommands, false, true);
+		AutoFire(ship, firingCommands, target, false, true);
 
 	const bool mouseTurning = activeCommands.Has(Command::MOUSE_TURNING_HOLD);
 	if(mouseTurning && !ship.IsBoarding() && !ship.IsReversing())
@@ -4528,7 +4658,7 @@ void AI::MovePlayer(Ship &ship, Command &activeCommands)
 			command.SetTurn(activeCommands.Has(Command::RIGHT) - activeCommands.Has(Command::LEFT));
 		if(activeCommands.Has(Command::BACK))
 		{
-			if(!activeCommands.Has(Command::FORWARD) && ship.Attributes().Get("reverse thrust"))
+			if(!activeCommands.Has(Command::FORWARD) && ship.Attributes().Get(Attribute("reverse thrust")))
 				command |= Command::BACK;
 			else if(!activeCommands.Has(Command::RIGHT | Command::LEFT | Command::AUTOSTEER))
 				command.SetTurn(TurnBackward(ship));
@@ -4809,17 +4939,33 @@ void AI::CacheShipLists()
 {
 	allyLists.clear();
 	enemyLists.clear();
+	allyGrids.clear();
+	enemyGrids.clear();
+	// Each roster's grid is kept for the next step unless its government has
+	// left the system, to avoid reallocating it.
+	erase_if(rosterGrids, [this](const auto &it) { return !governmentRosters.contains(it.first); });
+	maxRosterSpeed = 0.;
+	for(const auto &git : governmentRosters)
+	{
+		rosterGrids[git.first].Build(git.second);
+		for(const Ship *ship : git.second)
+			maxRosterSpeed = max(maxRosterSpeed, ship->Velocity().Length());
+	}
+
 	for(const auto &git : governmentRosters)
 	{
 		allyLists.emplace(git.first, vector<Ship *>());
 		allyLists.at(git.first).reserve(ships.size());
 		enemyLists.emplace(git.first, vector<Ship *>());
 		enemyLists.at(git.first).reserve(ships.size());
+		auto &enemies = enemyGrids[git.first];
+		auto &allies = allyGrids[git.first];
 		for(const auto &oit : governmentRosters)
 		{
-			auto &list = git.first->IsEnemy(oit.first)
-					? enemyLists[git.first] : allyLists[git.first];
+			const bool isEnemy = git.first->IsEnemy(oit.first);
+			auto &list = isEnemy ? enemyLists[git.first] : allyLists[git.first];
 			list.insert(list.end(), oit.second.begin(), oit.second.end());
+			(isEnemy ? enemies : allies).push_back(&rosterGrids.at(oit.first));
 		}
 	}
 }
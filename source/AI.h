@@ -20,6 +20,8 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "FormationPositioner.h"
 #include "Orders.h"
 #include "Point.h"
+#include "ShipGrid.h"
+#include "TaskQueue.h"
 
 #include <cstdint>
 #include <list>
@@ -151,11 +153,13 @@ private:
 	// returns the direction to the target.
 	static Point TargetAim(const Ship &ship);
 	static Point TargetAim(const Ship &ship, const Body &target);
-	// Aim the given ship's turrets.
-	void AimTurrets(const Ship &ship, FireCommand &command, bool opportunistic = false) const;
-	// Fire whichever of the given ship's weapons can hit a hostile target.
-	// Return a bitmask giving the weapons to fire.
-	void AutoFire(const Ship &ship, FireCommand &command, bool secondary = true, bool isFlagship = false) const;
+	// Aim the given ship's turrets, at the given targets or at any nearby enemy.
+	void AimTurrets(const Ship &ship, FireCommand &command, const Ship *currentTarget,
+		const Minable *targetAsteroid, bool opportunistic = false) const;
+	// Fire whichever of the given ship's weapons can hit a hostile target,
+	// preferring the given target ship.
+	void AutoFire(const Ship &ship, FireCommand &command, std::shared_ptr<Ship> currentTarget,
+		bool secondary = true, bool isFlagship = false) const;
 	void AutoFire(const Ship &ship, FireCommand &command, const Body &target) const;
 
 	// Calculate how long it will take a projectile to reach a target given the
@@ -174,6 +178,25 @@ private:
 	// True if the ship has performed the indicated event against any member of the government.
 	bool Has(const Ship &ship, const Government *government, int type) const;
 
+	// Aiming and firing of the ships controlled by the AI is decided in parallel,
+	// after every ship has otherwise decided what to do during this step.
+	class FireControl {
+	public:
+		Ship *ship = nullptr;
+		// The targets the ship had when it was ready to aim and fire.
+		std::shared_ptr<Ship> target;
+		std::shared_ptr<Minable> targetAsteroid;
+		bool opportunistic = false;
+		// Whether the ship's decision ended by applying its firing commands.
+		bool isCommitted = false;
+		// The firing commands the ship decided on by itself, to be combined
+		// with those for aiming and firing at its targets.
+		FireCommand command;
+	};
+	FireControl &DeferFireControl(Ship &ship, bool opportunistic);
+	void SetFiringCommands(Ship &ship, FireControl *fireControl);
+	void DoFireControl();
+
 	// Functions to classify ships based on government and system.
 	void UpdateStrengths(std::map<const Government *, int64_t> &strength, const System *playerSystem);
 	void CacheShipLists();
@@ -205,6 +228,12 @@ private:
 	// thrashing the heap, since we can reuse the storage for
 	// each ship.
 	FireCommand firingCommands;
+	// Aiming and firing decisions that are made after all other decisions.
+	// This is reused between steps to avoid reallocating the commands.
+	std::vector<FireControl> fireControls;
+	size_t fireControlCount = 0;
+	// The queue used to decide aiming and firing in parallel.
+	TaskQueue queue;
 
 	bool isCloaking = false;
 
@@ -247,4 +276,12 @@ private:
 	std::map<const Government *, std::vector<Ship *>> governmentRosters;
 	std::map<const Government *, std::vector<Ship *>> enemyLists;
 	std::map<const Government *, std::vector<Ship *>> allyLists;
+	// Spatial indices of each government's roster, and the rosters that are
+	// hostile or friendly to each government, for range-limited searches.
+	std::map<const Government *, ShipGrid> rosterGrids;
+	std::map<const Government *, std::vector<const ShipGrid *>> enemyGrids;
+	std::map<const Government *, std::vector<const ShipGrid *>> allyGrids;
+	// The speed of the fastest ship in any roster, which limits how far a ship
+	// that a search estimates the future position of can move in the meantime.
+	double maxRosterSpeed = 0.;
 };
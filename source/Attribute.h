@@ -0,0 +1,253 @@
+/* Attribute.h
+Copyright (c) 2026 by the Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <string_view>
+
+
+
+// The name of an outfit attribute that the game engine knows about at compile
+// time, such as "thrust" or "shield generation". Each known attribute has a
+// fixed slot, so that a Dictionary can find its value without searching for
+// the name. Attributes that are only defined by the game data are still looked
+// up by name. Using a name that is not in the list below is a compile error.
+class Attribute {
+public:
+	// The slot of a name that is not a known attribute.
+	static constexpr size_t NONE = static_cast<size_t>(-1);
+
+
+public:
+	consteval explicit Attribute(const char *name) : slot(Find(name))
+	{
+		if(slot == NONE)
+			throw "This attribute must be added to the list of known attributes.";
+	}
+
+	// Get the slot of the given attribute name, or NONE if it is not known.
+	static constexpr size_t Find(std::string_view name)
+	{
+		const auto it = std::lower_bound(std::begin(NAMES), std::end(NAMES), name);
+		return (it != std::end(NAMES) && *it == name) ? static_cast<size_t>(it - std::begin(NAMES)) : NONE;
+	}
+	// The number of known attributes.
+	static constexpr size_t Count()
+	{
+		return std::size(NAMES);
+	}
+
+	constexpr size_t Slot() const
+	{
+		return slot;
+	}
+	constexpr const char *Name() const
+	{
+		return NAMES[slot].data();
+	}
+
+
+private:
+	// Every known attribute, in sorted order.
+	static constexpr std::string_view NAMES[] = {
+		"absolute threshold",
+		"acceleration multiplier",
+		"active cooling",
+		"afterburner burn",
+		"afterburner corrosion",
+		"afterburner discharge",
+		"afterburner disruption",
+		"afterburner energy",
+		"afterburner fuel",
+		"afterburner heat",
+		"afterburner hull",
+		"afterburner ion",
+		"afterburner leakage",
+		"afterburner scramble",
+		"afterburner shields",
+		"afterburner slowing",
+		"afterburner thrust",
+		"asteroid scan power",
+		"atmosphere scan",
+		"automaton",
+		"bunks",
+		"burn resistance",
+		"burn resistance energy",
+		"burn resistance fuel",
+		"burn resistance heat",
+		"cargo scan efficiency",
+		"cargo scan opacity",
+		"cargo scan power",
+		"cargo space",
+		"cloak",
+		"cloak by mass",
+		"cloak hull threshold",
+		"cloak phasing",
+		"cloaked afterburner",
+		"cloaked boarding",
+		"cloaked communication",
+		"cloaked deployment",
+		"cloaked firing",
+		"cloaked pickup",
+		"cloaked scanning",
+		"cloaking energy",
+		"cloaking fuel",
+		"cloaking heat",
+		"cloaking hull",
+		"cloaking repair delay",
+		"cloaking shield delay",
+		"cloaking shields",
+		"cooling",
+		"cooling energy",
+		"cooling inefficiency",
+		"corrosion resistance",
+		"corrosion resistance energy",
+		"corrosion resistance fuel",
+		"corrosion resistance heat",
+		"crew equivalent",
+		"delayed hull energy",
+		"delayed hull fuel",
+		"delayed hull heat",
+		"delayed hull repair rate",
+		"delayed shield energy",
+		"delayed shield fuel",
+		"delayed shield generation",
+		"delayed shield heat",
+		"depleted shield delay",
+		"disabled recovery burning",
+		"disabled recovery corrosion",
+		"disabled recovery discharge",
+		"disabled recovery disruption",
+		"disabled recovery energy",
+		"disabled recovery fuel",
+		"disabled recovery heat",
+		"disabled recovery ionization",
+		"disabled recovery leak",
+		"disabled recovery scrambling",
+		"disabled recovery slowing",
+		"disabled recovery time",
+		"disabled repair delay",
+		"discharge resistance",
+		"discharge resistance energy",
+		"discharge resistance fuel",
+		"discharge resistance heat",
+		"disruption resistance",
+		"disruption resistance energy",
+		"disruption resistance fuel",
+		"disruption resistance heat",
+		"drag",
+		"drag reduction",
+		"energy capacity",
+		"energy consumption",
+		"energy generation",
+		"flotsam chance",
+		"fuel capacity",
+		"fuel consumption",
+		"fuel energy",
+		"fuel generation",
+		"fuel heat",
+		"heat capacity",
+		"heat dissipation",
+		"heat generation",
+		"hull",
+		"hull energy",
+		"hull energy multiplier",
+		"hull fuel",
+		"hull fuel multiplier",
+		"hull heat",
+		"hull heat multiplier",
+		"hull multiplier",
+		"hull repair multiplier",
+		"hull repair rate",
+		"hull threshold",
+		"hyperdrive",
+		"inertia reduction",
+		"inscrutable",
+		"ion resistance",
+		"ion resistance energy",
+		"ion resistance fuel",
+		"ion resistance heat",
+		"jump drive",
+		"jump speed",
+		"landing speed",
+		"leak resistance",
+		"leak resistance energy",
+		"leak resistance fuel",
+		"leak resistance heat",
+		"minable",
+		"outfit scan efficiency",
+		"outfit scan opacity",
+		"outfit scan power",
+		"outfit space",
+		"overheat damage rate",
+		"overheat damage threshold",
+		"ramscoop",
+		"repair delay",
+		"required crew",
+		"reverse thrust",
+		"scram drive",
+		"scramble resistance",
+		"scramble resistance energy",
+		"scramble resistance fuel",
+		"scramble resistance heat",
+		"self destruct",
+		"shield delay",
+		"shield energy",
+		"shield energy multiplier",
+		"shield fuel",
+		"shield fuel multiplier",
+		"shield generation",
+		"shield generation multiplier",
+		"shield heat",
+		"shield heat multiplier",
+		"shield multiplier",
+		"shields",
+		"slowing resistance",
+		"slowing resistance energy",
+		"slowing resistance fuel",
+		"slowing resistance heat",
+		"solar collection",
+		"solar heat",
+		"tactical scan power",
+		"threshold percentage",
+		"thrust",
+		"thrusting energy",
+		"turn",
+		"turn multiplier",
+		"turning burn",
+		"turning corrosion",
+		"turning discharge",
+		"turning disruption",
+		"turning energy",
+		"turning fuel",
+		"turning heat",
+		"turning hull",
+		"turning ion",
+		"turning leakage",
+		"turning scramble",
+		"turning shields",
+		"turning slowing",
+		"turret mounts",
+		"use crew equivalent as crew",
+	};
+	static_assert(std::is_sorted(std::begin(NAMES), std::end(NAMES)), "Known attributes must be sorted.");
+
+
+private:
+	size_t slot;
+};
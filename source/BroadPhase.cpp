@@ -0,0 +1,155 @@
+/* BroadPhase.cpp
+Copyright (c) 2026 by the Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "BroadPhase.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+// SSE2 is part of the x86-64 instruction set, so it is always available there.
+#if defined(__SSE2__) || defined(_M_X64)
+#define ES_BROAD_PHASE_SSE
+#include <emmintrin.h>
+#endif
+
+using namespace std;
+
+namespace {
+	// Allow for some rounding error, both absolute and relative to the size of
+	// the coordinates, so that no object the exact test would hit is rejected.
+	constexpr float SLACK = 1.f;
+	constexpr float RELATIVE_SLACK = 1e-4f;
+
+	// Add the indices of the set bits of the given mask to the candidates.
+	inline void AddCandidates(unsigned bits, unsigned first, vector<unsigned> &result)
+	{
+		while(bits)
+		{
+			result.push_back(first + countr_zero(bits));
+			bits &= bits - 1;
+		}
+	}
+}
+
+
+
+// Whether this build tests several objects at once.
+bool BroadPhase::IsVectorized()
+{
+#ifdef ES_BROAD_PHASE_SSE
+	return true;
+#else
+	return false;
+#endif
+}
+
+
+
+// Find which of the given objects might touch the line segment from (x, y)
+// to (x + dx, y + dy).
+void BroadPhase::Line(const float *px, const float *py, const float *radius, unsigned count,
+	float x, float y, float dx, float dy, vector<unsigned> &result, bool vectorized)
+{
+	result.clear();
+	const float lengthSquared = dx * dx + dy * dy;
+	const float scale = (lengthSquared > 0.f ? 1.f / lengthSquared : 0.f);
+	const float slack = SLACK + RELATIVE_SLACK * (abs(x) + abs(y) + abs(dx) + abs(dy));
+
+	unsigned i = 0;
+#ifdef ES_BROAD_PHASE_SSE
+	if(vectorized)
+	{
+		const __m128 vx = _mm_set1_ps(x);
+		const __m128 vy = _mm_set1_ps(y);
+		const __m128 vdx = _mm_set1_ps(dx);
+		const __m128 vdy = _mm_set1_ps(dy);
+		const __m128 vscale = _mm_set1_ps(scale);
+		const __m128 vslack = _mm_set1_ps(slack);
+		const __m128 zero = _mm_setzero_ps();
+		const __m128 one = _mm_set1_ps(1.f);
+		for( ; i + 4 <= count; i += 4)
+		{
+			const __m128 ox = _mm_sub_ps(_mm_loadu_ps(px + i), vx);
+			const __m128 oy = _mm_sub_ps(_mm_loadu_ps(py + i), vy);
+			__m128 t = _mm_mul_ps(_mm_add_ps(_mm_mul_ps(ox, vdx), _mm_mul_ps(oy, vdy)), vscale);
+			t = _mm_min_ps(_mm_max_ps(t, zero), one);
+			const __m128 ex = _mm_sub_ps(ox, _mm_mul_ps(t, vdx));
+			const __m128 ey = _mm_sub_ps(oy, _mm_mul_ps(t, vdy));
+			const __m128 limit = _mm_add_ps(_mm_loadu_ps(radius + i), vslack);
+			const __m128 distance = _mm_add_ps(_mm_mul_ps(ex, ex), _mm_mul_ps(ey, ey));
+			const __m128 isNear = _mm_cmple_ps(distance, _mm_mul_ps(limit, limit));
+			AddCandidates(_mm_movemask_ps(isNear), i, result);
+		}
+	}
+#endif
+	for( ; i < count; ++i)
+	{
+		const float ox = px[i] - x;
+		const float oy = py[i] - y;
+		const float t = clamp((ox * dx + oy * dy) * scale, 0.f, 1.f);
+		const float ex = ox - t * dx;
+		const float ey = oy - t * dy;
+		const float limit = radius[i] + slack;
+		if(ex * ex + ey * ey <= limit * limit)
+			result.push_back(i);
+	}
+}
+
+
+
+// Find which of the given objects might touch the ring centered on (x, y)
+// with the given inner and outer radius.
+void BroadPhase::Ring(const float *px, const float *py, const float *radius, unsigned count,
+	float x, float y, float inner, float outer, vector<unsigned> &result, bool vectorized)
+{
+	result.clear();
+	const float slack = SLACK + RELATIVE_SLACK * (abs(x) + abs(y) + outer);
+
+	unsigned i = 0;
+#ifdef ES_BROAD_PHASE_SSE
+	if(vectorized)
+	{
+		const __m128 vx = _mm_set1_ps(x);
+		const __m128 vy = _mm_set1_ps(y);
+		const __m128 vinner = _mm_set1_ps(inner - slack);
+		const __m128 vouter = _mm_set1_ps(outer + slack);
+		const __m128 zero = _mm_setzero_ps();
+		for( ; i + 4 <= count; i += 4)
+		{
+			const __m128 ox = _mm_sub_ps(_mm_loadu_ps(px + i), vx);
+			const __m128 oy = _mm_sub_ps(_mm_loadu_ps(py + i), vy);
+			const __m128 r = _mm_loadu_ps(radius + i);
+			const __m128 low = _mm_max_ps(_mm_sub_ps(vinner, r), zero);
+			const __m128 high = _mm_add_ps(vouter, r);
+			const __m128 distance = _mm_add_ps(_mm_mul_ps(ox, ox), _mm_mul_ps(oy, oy));
+			const __m128 isNear = _mm_and_ps(
+				_mm_cmpge_ps(distance, _mm_mul_ps(low, low)),
+				_mm_cmple_ps(distance, _mm_mul_ps(high, high)));
+			AddCandidates(_mm_movemask_ps(isNear), i, result);
+		}
+	}
+#endif
+	for( ; i < count; ++i)
+	{
+		const float ox = px[i] - x;
+		const float oy = py[i] - y;
+		const float low = max(inner - slack - radius[i], 0.f);
+		const float high = outer + slack + radius[i];
+		const float distance = ox * ox + oy * oy;
+		if(distance >= low * low && distance <= high * high)
+			result.push_back(i);
+	}
+}
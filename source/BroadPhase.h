@@ -0,0 +1,45 @@
+/* BroadPhase.h
+Copyright (c) 2026 by the Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <vector>
+
+
+
+// The first, coarse phase of the CollisionSet's queries. Given the positions
+// and radii of the objects in a grid cell, packed into arrays, these functions
+// find which of those objects might touch a line or a ring, so that only those
+// objects have to be tested exactly. The tests are done in single precision
+// with some slack, so they never reject an object that the exact test would
+// have hit. On x86-64, several objects are tested at once using SSE, which
+// every x86-64 processor has. That gives exactly the same results as testing
+// them one at a time, which is done on other processors.
+class BroadPhase {
+public:
+	// Whether this build tests several objects at once.
+	static bool IsVectorized();
+
+	// Find which of the given objects might touch the line segment from (x, y)
+	// to (x + dx, y + dy). The indices of those objects are stored, in
+	// increasing order, in the result. If vectorized is false, the objects are
+	// tested one at a time even if they could be tested several at once.
+	static void Line(const float *px, const float *py, const float *radius, unsigned count,
+		float x, float y, float dx, float dy, std::vector<unsigned> &result, bool vectorized = true);
+	// Find which of the given objects might touch the ring centered on (x, y)
+	// with the given inner and outer radius.
+	static void Ring(const float *px, const float *py, const float *radius, unsigned count,
+		float x, float y, float inner, float outer, std::vector<unsigned> &result, bool vectorized = true);
+};
@@ -60,6 +60,8 @@ void CargoHold::Clear()
 	outfits.clear();
 	missionCargo.clear();
 	passengers.clear();
+	commoditiesSize = 0;
+	missionCargoSize = 0;
 }
 
 
@@ -78,6 +80,7 @@ void CargoHold::Load(const DataNode &node)
 				{
 					int tons = grand.Value(1);
 					commodities[grand.Token(0)] += tons;
+					commoditiesSize += tons;
 				}
 		}
 		else if(child.Token(0) == "outfits")
@@ -204,10 +207,7 @@ double CargoHold::UsedPrecise() const
 // Get the total number of tons of commodities.
 int CargoHold::CommoditiesSize() const
 {
-	int size = 0;
-	for(const auto &it : commodities)
-		size += it.second;
-	return size;
+	return commoditiesSize;
 }
 
 
@@ -248,10 +248,7 @@ bool CargoHold::HasOutfits() const
 // Get the total mass of mission cargo.
 int CargoHold::MissionCargoSize() const
 {
-	int size = 0;
-	for(const auto &it : missionCargo)
-		size += it.second;
-	return size;
+	return missionCargoSize;
 }
 
 
@@ -383,6 +380,7 @@ int CargoHold::Transfer(const string &commodity, int amount, CargoHold &to)
 	int removed = Remove(commodity, amount);
 	int added = to.Add(commodity, removed);
 	commodities[commodity] += removed - added;
+	commoditiesSize += removed - added;
 
 	return added;
 }
@@ -428,7 +426,9 @@ int CargoHold::Transfer(const Mission *mission, int amount, CargoHold &to)
 		return 0;
 
 	missionCargo[mission] -= amount;
+	missionCargoSize -= amount;
 	to.missionCargo[mission] += amount;
+	to.missionCargoSize += amount;
 
 	return amount;
 }
@@ -495,6 +495,7 @@ int CargoHold::Add(const string &commodity, int amount)
 	if(size >= 0)
 		amount = max(0, min(amount, Free()));
 	commodities[commodity] += amount;
+	commoditiesSize += amount;
 	return amount;
 }
 
@@ -524,6 +525,7 @@ int CargoHold::Remove(const string &commodity, int amount)
 
 	amount = min(amount, commodities[commodity]);
 	commodities[commodity] -= amount;
+	commoditiesSize -= amount;
 	return amount;
 }
 
@@ -549,7 +551,10 @@ void CargoHold::AddMissionCargo(const Mission *mission)
 	// cargo size is zero. This is so that, for example, your cargo listing can
 	// show "important documents" even if the documents take up no cargo space.
 	if(mission && !mission->Cargo().empty())
+	{
 		missionCargo[mission] += mission->CargoSize();
+		missionCargoSize += mission->CargoSize();
+	}
 	if(mission && mission->Passengers())
 		passengers[mission] += mission->Passengers();
 }
@@ -559,7 +564,12 @@ void CargoHold::AddMissionCargo(const Mission *mission)
 // Remove all the cargo and passengers (if any) associated with the given mission.
 void CargoHold::RemoveMissionCargo(const Mission *mission)
 {
-	missionCargo.erase(mission);
+	auto it = missionCargo.find(mission);
+	if(it != missionCargo.end())
+	{
+		missionCargoSize -= it->second;
+		missionCargo.erase(it);
+	}
 	passengers.erase(mission);
 }
 
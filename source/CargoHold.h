@@ -126,4 +126,8 @@ private:
 	std::map<const Outfit *, int> outfits;
 	std::map<const Mission *, int> missionCargo;
 	std::map<const Mission *, int> passengers;
+	// The total tons of commodities and of mission cargo, which are kept up
+	// to date as cargo is added and removed, since ships ask for their mass often.
+	int commoditiesSize = 0;
+	int missionCargoSize = 0;
 };
@@ -16,6 +16,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "CollisionSet.h"
 
 #include "Body.h"
+#include "BroadPhase.h"
 #include "Collision.h"
 #include "Government.h"
 #include "Logger.h"
@@ -25,6 +26,9 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "Ship.h"
 
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
 #include <cstdlib>
 #include <numeric>
 #include <set>
@@ -38,29 +42,33 @@ namespace {
 	// Velocity used for any projectiles with v > MAX_VELOCITY
 	constexpr int USED_MAX_VELOCITY = MAX_VELOCITY - 1;
 	// Warn the user only once about too-large projectile velocities.
-	bool warned = false;
+	atomic<bool> warned = false;
 
 	thread_local vector<bool> seen;
+	thread_local vector<unsigned> candidates;
+
+	// Each collision set gets a new ID each time it is cleared. Each thread
+	// remembers where its tallies of the queries of the last few sets it has
+	// used are. A thread rarely uses more than a few sets in one step, and if
+	// it does, it just starts another tally.
+	atomic<uint64_t> nextTallyID = 1;
+	thread_local array<pair<uint64_t, void *>, 8> localTallies;
+	thread_local size_t nextLocalTally = 0;
+
+	// Limits on the grid size when it is picked based on the objects in the set.
+	constexpr unsigned MIN_ADAPTIVE_CELL_SIZE = 64;
+	constexpr unsigned MAX_ADAPTIVE_CELL_SIZE = 4096;
+	constexpr unsigned MIN_ADAPTIVE_CELL_COUNT = 8;
+	constexpr unsigned MAX_ADAPTIVE_CELL_COUNT = 128;
 }
 
 
 // Initialize a collision set. The cell size and cell count should both be
 // powers of two; otherwise, they are rounded down to a power of two.
 CollisionSet::CollisionSet(unsigned cellSize, unsigned cellCount, CollisionType collisionType)
-	: collisionType(collisionType)
+	: collisionType(collisionType), fixedCellSize(cellSize), fixedCellCount(cellCount)
 {
-	// Right shift amount to convert from (x, y) location to grid (x, y).
-	SHIFT = 0u;
-	while(cellSize >>= 1u)
-		++SHIFT;
-	CELL_SIZE = (1u << SHIFT);
-	CELL_MASK = CELL_SIZE - 1u;
-
-	// Number of grid rows and columns.
-	CELLS = 1u;
-	while(cellCount >>= 1u)
-		CELLS <<= 1;
-	WRAP_MASK = CELLS - 1u;
+	SetGrid(cellSize, cellCount);
 
 	// Just in case Clear() isn't called before objects are added:
 	Clear(0);
@@ -68,6 +76,17 @@ CollisionSet::CollisionSet(unsigned cellSize, unsigned cellCount, CollisionType
 
 
 
+// Choose whether the grid's cell size and count should be picked based on the
+// objects in the set each time Finish() is called, rather than fixed.
+void CollisionSet::SetAdaptive(bool adaptive)
+{
+	isAdaptive = adaptive;
+	if(!isAdaptive)
+		SetGrid(fixedCellSize, fixedCellCount);
+}
+
+
+
 // Clear all objects in the set.
 void CollisionSet::Clear(int step)
 {
@@ -77,9 +96,16 @@ void CollisionSet::Clear(int step)
 	sorted.clear();
 	counts.clear();
 	all.clear();
+	sortedX.clear();
+	sortedY.clear();
+	sortedRadius.clear();
+	sortedGovernment.clear();
 	// The counts vector starts with two sentinel slots that will be used in the
 	// course of performing the radix sort.
 	counts.resize(CELLS * CELLS + 2u, 0u);
+
+	tallyID = nextTallyID++;
+	tallies.clear();
 }
 
 
@@ -87,25 +113,8 @@ void CollisionSet::Clear(int step)
 // Add an object to the set.
 void CollisionSet::Add(Body &body)
 {
-	// Calculate the range of (x, y) grid coordinates this object covers.
-	int minX = static_cast<int>(body.Position().X() - body.Radius()) >> SHIFT;
-	int minY = static_cast<int>(body.Position().Y() - body.Radius()) >> SHIFT;
-	int maxX = static_cast<int>(body.Position().X() + body.Radius()) >> SHIFT;
-	int maxY = static_cast<int>(body.Position().Y() + body.Radius()) >> SHIFT;
-
-	// Add a pointer to this object in every grid cell it occupies.
-	for(int y = minY; y <= maxY; ++y)
-	{
-		auto gy = y & WRAP_MASK;
-		for(int x = minX; x <= maxX; ++x)
-		{
-			auto gx = x & WRAP_MASK;
-			added.emplace_back(&body, all.size(), x, y);
-			++counts[gy * CELLS + gx + 2];
-		}
-	}
-
-	// Also save a pointer to this object irrespective of its grid location.
+	// The object is only placed in the grid once all objects have been added,
+	// because the grid may be sized to fit them.
 	all.emplace_back(&body);
 }
 
@@ -114,6 +123,33 @@ void CollisionSet::Add(Body &body)
 // Finish adding objects (and organize them into the final lookup table).
 void CollisionSet::Finish()
 {
+	if(isAdaptive)
+		FitGrid();
+
+	// The grid may have been resized, so reset the counts to match.
+	counts.assign(CELLS * CELLS + 2u, 0u);
+	for(unsigned index = 0; index < all.size(); ++index)
+	{
+		const Body &body = *all[index];
+		// Calculate the range of (x, y) grid coordinates this object covers.
+		int minX = static_cast<int>(body.Position().X() - body.Radius()) >> SHIFT;
+		int minY = static_cast<int>(body.Position().Y() - body.Radius()) >> SHIFT;
+		int maxX = static_cast<int>(body.Position().X() + body.Radius()) >> SHIFT;
+		int maxY = static_cast<int>(body.Position().Y() + body.Radius()) >> SHIFT;
+
+		// Add a pointer to this object in every grid cell it occupies.
+		for(int y = minY; y <= maxY; ++y)
+		{
+			auto gy = y & WRAP_MASK;
+			for(int x = minX; x <= maxX; ++x)
+			{
+				auto gx = x & WRAP_MASK;
+				added.emplace_back(all[index], index, x, y);
+				++counts[gy * CELLS + gx + 2];
+			}
+		}
+	}
+
 	// Perform a partial sum to convert the counts of items in each bin into the
 	// index of the output element where that bin begins.
 	partial_sum(counts.begin(), counts.end(), counts.begin());
@@ -131,6 +167,24 @@ void CollisionSet::Finish()
 		sorted[counts[index]++] = entry;
 	}
 	// Now, counts[index] is where a certain bin begins.
+
+	// Pack the position, mask radius, and government of each entry for the broad
+	// phase tests. Looking up the masks here also calculates each object's
+	// animation frame for this step, rather than on demand, so that queries do
+	// not modify the objects and can be safely made from multiple threads at once.
+	sortedX.resize(sorted.size());
+	sortedY.resize(sorted.size());
+	sortedRadius.resize(sorted.size());
+	sortedGovernment.resize(sorted.size());
+	for(size_t i = 0; i < sorted.size(); ++i)
+	{
+		const Body &body = *sorted[i].body;
+		const Mask &mask = body.GetMask(step);
+		sortedX[i] = body.Position().X();
+		sortedY[i] = body.Position().Y();
+		sortedRadius[i] = mask.IsLoaded() ? mask.Radius() : 0.;
+		sortedGovernment[i] = body.GetGovernment();
+	}
 }
 
 
@@ -170,12 +224,16 @@ void CollisionSet::Line(const Point &from, const Point &to, vector<Collision> &l
 	// In this case, all the complicated code below can be skipped.
 	if(gx == endGX && gy == endGY)
 	{
-		// Examine all objects in the current grid cell.
+		// Examine all objects in the current grid cell that are close enough to
+		// the line to possibly be hit by it.
 		const auto index = (gy & WRAP_MASK) * CELLS + (gx & WRAP_MASK);
-		vector<Entry>::const_iterator it = sorted.begin() + counts[index];
-		vector<Entry>::const_iterator end = sorted.begin() + counts[index + 1];
-		for( ; it != end; ++it)
+		const unsigned first = counts[index];
+		CountQuery(counts[index + 1] - first);
+		BroadPhase::Line(sortedX.data() + first, sortedY.data() + first, sortedRadius.data() + first,
+			counts[index + 1] - first, from.X(), from.Y(), to.X() - from.X(), to.Y() - from.Y(), candidates);
+		for(unsigned candidate : candidates)
 		{
+			const Entry *it = &sorted[first + candidate];
 			// Skip objects that were put in this same grid cell only because
 			// of the cell coordinates wrapping around.
 			if(it->x != gx || it->y != gy)
@@ -183,7 +241,7 @@ void CollisionSet::Line(const Point &from, const Point &to, vector<Collision> &l
 
 			// Check if this projectile can hit this object. If either the
 			// projectile or the object has no government, it will always hit.
-			const Government *iGov = it->body->GetGovernment();
+			const Government *iGov = sortedGovernment[first + candidate];
 			if(it->body != target && iGov && pGov && !iGov->IsEnemy(pGov))
 				continue;
 
@@ -202,11 +260,8 @@ void CollisionSet::Line(const Point &from, const Point &to, vector<Collision> &l
 	if(pVelocity.Length() > MAX_VELOCITY)
 	{
 		// Cap projectile velocity to prevent integer overflows.
-		if(!warned)
-		{
+		if(!warned.exchange(true))
 			Logger::LogError("Warning: maximum projectile velocity is " + to_string(MAX_VELOCITY));
-			warned = true;
-		}
 		Point newEnd = from + pVelocity.Unit() * USED_MAX_VELOCITY;
 
 		Line(from, newEnd, lineResult, pGov, target);
@@ -237,14 +292,21 @@ void CollisionSet::Line(const Point &from, const Point &to, vector<Collision> &l
 	seen.clear();
 	seen.resize(all.size());
 
+	uint64_t checked = 0;
 	while(true)
 	{
-		// Examine all objects in the current grid cell.
+		// Examine all objects in the current grid cell that are close enough to
+		// the line to possibly be hit by it. An object that is rejected here
+		// will also be rejected in any other cell it is in, so it does not need
+		// to be marked as seen.
 		auto i = (gy & WRAP_MASK) * CELLS + (gx & WRAP_MASK);
-		vector<Entry>::const_iterator it = sorted.begin() + counts[i];
-		vector<Entry>::const_iterator end = sorted.begin() + counts[i + 1];
-		for( ; it != end; ++it)
+		const unsigned first = counts[i];
+		checked += counts[i + 1] - first;
+		BroadPhase::Line(sortedX.data() + first, sortedY.data() + first, sortedRadius.data() + first,
+			counts[i + 1] - first, from.X(), from.Y(), to.X() - from.X(), to.Y() - from.Y(), candidates);
+		for(unsigned candidate : candidates)
 		{
+			const Entry *it = &sorted[first + candidate];
 			// Skip objects that were put in this same grid cell only because
 			// of the cell coordinates wrapping around.
 			if(it->x != gx || it->y != gy)
@@ -256,7 +318,7 @@ void CollisionSet::Line(const Point &from, const Point &to, vector<Collision> &l
 
 			// Check if this projectile can hit this object. If either the
 			// projectile or the object has no government, it will always hit.
-			const Government *iGov = it->body->GetGovernment();
+			const Government *iGov = sortedGovernment[first + candidate];
 			if(it->body != target && iGov && pGov && !iGov->IsEnemy(pGov))
 				continue;
 
@@ -304,6 +366,7 @@ void CollisionSet::Line(const Point &from, const Point &to, vector<Collision> &l
 			gy += stepY;
 		}
 	}
+	CountQuery(checked);
 }
 
 
@@ -329,6 +392,7 @@ void CollisionSet::Ring(const Point &center, double inner, double outer, vector<
 	seen.clear();
 	seen.resize(all.size());
 
+	uint64_t checked = 0;
 	for(int y = minY; y <= maxY; ++y)
 	{
 		const auto gy = y & WRAP_MASK;
@@ -336,11 +400,14 @@ void CollisionSet::Ring(const Point &center, double inner, double outer, vector<
 		{
 			const auto gx = x & WRAP_MASK;
 			const auto index = gy * CELLS + gx;
-			vector<Entry>::const_iterator it = sorted.begin() + counts[index];
-			vector<Entry>::const_iterator end = sorted.begin() + counts[index + 1];
+			const unsigned first = counts[index];
+			checked += counts[index + 1] - first;
+			BroadPhase::Ring(sortedX.data() + first, sortedY.data() + first, sortedRadius.data() + first,
+				counts[index + 1] - first, center.X(), center.Y(), inner, outer, candidates);
 
-			for( ; it != end; ++it)
+			for(unsigned candidate : candidates)
 			{
+				const Entry *it = &sorted[first + candidate];
 				// Skip objects that were put in this same grid cell only because
 				// of the cell coordinates wrapping around.
 				if(it->x != x || it->y != y)
@@ -359,6 +426,7 @@ void CollisionSet::Ring(const Point &center, double inner, double outer, vector<
 			}
 		}
 	}
+	CountQuery(checked);
 }
 
 
@@ -367,3 +435,107 @@ const vector<Body *> &CollisionSet::All() const
 {
 	return all;
 }
+
+
+
+// Get the average number of grid entries that were examined by each query
+// since this set was last cleared.
+double CollisionSet::CandidatesPerQuery() const
+{
+	uint64_t count = 0;
+	uint64_t checked = 0;
+	lock_guard<mutex> lock(tallyMutex);
+	for(const auto &tally : tallies)
+	{
+		count += tally->queries;
+		checked += tally->checked;
+	}
+	return count ? static_cast<double>(checked) / count : 0.;
+}
+
+
+
+// Get the current size of each grid cell.
+unsigned CollisionSet::CellSize() const
+{
+	return CELL_SIZE;
+}
+
+
+
+// Record that a query examined the given number of grid entries.
+void CollisionSet::CountQuery(uint64_t checked) const
+{
+	// Look for this thread's tally for this set. If there is none, because
+	// this thread has not queried the set since it was cleared, start one.
+	Tally *tally = nullptr;
+	for(const auto &it : localTallies)
+		if(it.first == tallyID)
+			tally = static_cast<Tally *>(it.second);
+	if(!tally)
+	{
+		lock_guard<mutex> lock(tallyMutex);
+		tally = tallies.emplace_back(make_unique<Tally>()).get();
+		localTallies[nextLocalTally] = make_pair(tallyID, tally);
+		nextLocalTally = (nextLocalTally + 1) % localTallies.size();
+	}
+	++tally->queries;
+	tally->checked += checked;
+}
+
+
+
+// Set the size and number of the grid cells, rounding both down to a power of two.
+void CollisionSet::SetGrid(unsigned cellSize, unsigned cellCount)
+{
+	// Right shift amount to convert from (x, y) location to grid (x, y).
+	SHIFT = 0u;
+	while(cellSize >>= 1u)
+		++SHIFT;
+	CELL_SIZE = (1u << SHIFT);
+	CELL_MASK = CELL_SIZE - 1u;
+
+	// Number of grid rows and columns.
+	CELLS = 1u;
+	while(cellCount >>= 1u)
+		CELLS <<= 1;
+	WRAP_MASK = CELLS - 1u;
+}
+
+
+
+// Pick a cell size based on how densely packed the objects in this set are,
+// and enough cells to cover the area they are spread over, so that objects far
+// apart from each other are less likely to wrap around into the same cell.
+void CollisionSet::FitGrid()
+{
+	if(all.empty())
+		return;
+
+	Point low = all.front()->Position();
+	Point high = low;
+	double radiusSum = 0.;
+	for(const Body *body : all)
+	{
+		low = min(low, body->Position());
+		high = max(high, body->Position());
+		radiusSum += body->Radius();
+	}
+	const Point extent = high - low;
+
+	// Aim for each cell to hold a few objects if they were evenly spread out,
+	// but never make a cell smaller than an average object, or objects will
+	// end up being added to too many cells.
+	const double spacing = sqrt(max(extent.X() * extent.Y(), 1.) / all.size());
+	const double target = max(2. * spacing, 2. * radiusSum / all.size());
+	unsigned cellSize = MIN_ADAPTIVE_CELL_SIZE;
+	while(cellSize < target && cellSize < MAX_ADAPTIVE_CELL_SIZE)
+		cellSize <<= 1;
+
+	const double span = max(extent.X(), extent.Y()) / cellSize + 1.;
+	unsigned cellCount = MIN_ADAPTIVE_CELL_COUNT;
+	while(cellCount < span && cellCount < MAX_ADAPTIVE_CELL_COUNT)
+		cellCount <<= 1;
+
+	SetGrid(cellSize, cellCount);
+}
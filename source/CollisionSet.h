@@ -18,6 +18,9 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "Collision.h"
 #include "CollisionType.h"
 
+#include <cstdint>
+#include <memory>
+#include <mutex>
 #include <vector>
 
 class Body;
@@ -36,12 +39,18 @@ public:
 	// powers of two; otherwise, they are rounded down to a power of two.
 	CollisionSet(unsigned cellSize, unsigned cellCount, CollisionType collisionType);
 
+	// If adaptive, the cell size and count given above are ignored. Instead,
+	// each call to Finish() picks them based on how densely packed the objects
+	// in the set are and how far they are spread out.
+	void SetAdaptive(bool adaptive);
+
 	// Clear all objects in the set. Specify which engine step we are on, so we
 	// know what animation frame each object is on.
 	void Clear(int step);
 	// Add an object to the set.
 	void Add(Body &body);
 	// Finish adding objects (and organize them into the final lookup table).
+	// After this, any number of threads may query the set at the same time.
 	void Finish();
 
 	// Get all possible collisions for the given projectile. Collisions are not necessarily
@@ -62,6 +71,19 @@ public:
 	// Get all objects within this collision set.
 	const std::vector<Body *> &All() const;
 
+	// Get the average number of grid entries each query has had to examine
+	// since the set was last cleared. The fewer, the better the grid fits.
+	// This must not be called while other threads are querying the set.
+	double CandidatesPerQuery() const;
+	// Get the current size of each grid cell.
+	unsigned CellSize() const;
+
+
+private:
+	void CountQuery(uint64_t checked) const;
+	void SetGrid(unsigned cellSize, unsigned cellCount);
+	void FitGrid();
+
 
 private:
 	class Entry {
@@ -80,6 +102,11 @@ private:
 	// The type of collisions this CollisionSet is responsible for.
 	CollisionType collisionType;
 
+	// The grid size given to the constructor, and whether to use it.
+	unsigned fixedCellSize;
+	unsigned fixedCellCount;
+	bool isAdaptive = false;
+
 	// The size of individual cells of the grid.
 	unsigned CELL_SIZE;
 	unsigned SHIFT;
@@ -98,4 +125,26 @@ private:
 	std::vector<Entry> sorted;
 	// After Finish(), counts[index] is where a certain bin begins.
 	std::vector<unsigned> counts;
+
+	// A copy of the position, mask radius, and government of each entry in
+	// the sorted vector, packed so that whole cells can be tested at once
+	// before looking at the objects themselves.
+	std::vector<float> sortedX;
+	std::vector<float> sortedY;
+	std::vector<float> sortedRadius;
+	std::vector<const Government *> sortedGovernment;
+
+	// Statistics on how many grid entries the queries have examined. Each thread
+	// that queries the set keeps its own tally, on its own cache line, so that
+	// the threads do not slow each other down. The tallies are only added up
+	// when the statistics are asked for. Each time the set is cleared, it gets
+	// a new ID, so that the threads know to start new tallies.
+	class alignas(64) Tally {
+	public:
+		uint64_t queries = 0;
+		uint64_t checked = 0;
+	};
+	uint64_t tallyID = 0;
+	mutable std::mutex tallyMutex;
+	mutable std::vector<std::unique_ptr<Tally>> tallies;
 };
@@ -141,6 +141,9 @@ public:
 
 
 private:
+	// Recordings store the raw state of each command.
+	friend class Recording;
+
 	explicit Command(uint64_t state);
 	Command(uint64_t state, const std::string &text);
 
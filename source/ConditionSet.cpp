@@ -151,37 +151,6 @@ namespace {
 		return false;
 	}
 
-	// Converts the given vector of condition tokens (like "reputation: Republic",
-	// "random", or "4") into the integral values they have at runtime.
-	vector<int64_t> SubstituteValues(const vector<string> &side, const ConditionsStore &conditions,
-		const ConditionsStore &created)
-	{
-		auto result = vector<int64_t>();
-		result.reserve(side.size());
-		for(const string &str : side)
-		{
-			int64_t value = 0;
-			if(str == "random")
-				value = Random::Int(100);
-			else if(DataNode::IsNumber(str))
-				value = static_cast<int64_t>(DataNode::Value(str));
-			else
-			{
-				const auto temp = created.Get(str);
-				if(temp)
-					value = temp;
-				else
-				{
-					const auto perm = conditions.Get(str);
-					if(perm)
-						value = perm;
-				}
-			}
-			result.emplace_back(value);
-		}
-		return result;
-	}
-
 	bool UsedAll(const vector<bool> &status)
 	{
 		for(auto v : status)
@@ -600,6 +569,7 @@ ConditionSet::Expression::SubExpression::SubExpression(const vector<string> &sid
 
 	ParseSide(side);
 	GenerateSequence();
+	CompileOperands();
 }
 
 
@@ -609,6 +579,7 @@ ConditionSet::Expression::SubExpression::SubExpression(const vector<string> &sid
 ConditionSet::Expression::SubExpression::SubExpression(const string &side)
 {
 	tokens.emplace_back(side.empty() ? "'" : side);
+	CompileOperands();
 }
 
 
@@ -673,20 +644,23 @@ int64_t ConditionSet::Expression::SubExpression::Evaluate(const ConditionsStore
 	const ConditionsStore &created) const
 {
 	// Sanity check.
-	if(tokens.empty())
+	if(operands.empty())
 		return 0;
 
-	// For SubExpressions with no Operations (i.e. simple conditions), tokens will consist
-	// of only the condition or numeric value to be returned as-is after substitution.
-	auto data = SubstituteValues(tokens, conditions, created);
+	// For SubExpressions with no Operations (i.e. simple conditions), there is
+	// only the condition or numeric value to be returned as-is.
+	if(operands.size() == 1 && sequence.empty())
+		return operands.front().Evaluate(conditions, created);
 
-	if(!sequence.empty())
-	{
-		// Each Operation adds to the end of the data vector.
-		data.reserve(operatorCount + data.size());
-		for(const Operation &op : sequence)
-			data.emplace_back(op.fun(data[op.a], data[op.b]));
-	}
+	// Substitute the values of all the tokens, in order.
+	auto data = vector<int64_t>();
+	data.reserve(operatorCount + operands.size());
+	for(const Operand &operand : operands)
+		data.emplace_back(operand.Evaluate(conditions, created));
+
+	// Each Operation adds to the end of the data vector.
+	for(const Operation &op : sequence)
+		data.emplace_back(op.fun(data[op.a], data[op.b]));
 
 	return data.back();
 }
@@ -843,9 +817,51 @@ bool ConditionSet::Expression::SubExpression::AddOperation(vector<int> &data, si
 
 
 
+// Converts each of the tokens (like "reputation: Republic", "random", or "4")
+// into an Operand that can quickly find the integral value it has at runtime.
+void ConditionSet::Expression::SubExpression::CompileOperands()
+{
+	operands.clear();
+	operands.reserve(tokens.size());
+	for(const string &token : tokens)
+		operands.emplace_back(token);
+}
+
+
+
 // Constructor for an Operation, indicating the binary function and the
 // indices of its operands within the evaluation-time data vector.
 ConditionSet::Expression::SubExpression::Operation::Operation(const string &op, size_t &a, size_t &b)
 	: fun(Op(op)), a(a), b(b)
 {
 }
+
+
+
+ConditionSet::Expression::SubExpression::Operand::Operand(const string &token)
+{
+	if(token == "random")
+		isRandom = true;
+	else if(DataNode::IsNumber(token))
+		value = static_cast<int64_t>(DataNode::Value(token));
+	else
+	{
+		isCondition = true;
+		condition = ConditionsStore::Handle(token);
+	}
+}
+
+
+
+// Get the value of this operand, from the temporary conditions if it is set there.
+int64_t ConditionSet::Expression::SubExpression::Operand::Evaluate(const ConditionsStore &conditions,
+	const ConditionsStore &created) const
+{
+	if(isRandom)
+		return Random::Int(100);
+	if(!isCondition)
+		return value;
+
+	const int64_t temp = created.Get(condition);
+	return temp ? temp : conditions.Get(condition);
+}
@@ -15,13 +15,14 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #pragma once
 
+#include "ConditionsStore.h"
+
 #include <cstdint>
 #include <map>
 #include <set>
 #include <string>
 #include <vector>
 
-class ConditionsStore;
 class DataNode;
 class DataWriter;
 
@@ -125,6 +126,8 @@ private:
 			void ParseSide(const std::vector<std::string> &side);
 			void GenerateSequence();
 			bool AddOperation(std::vector<int> &data, size_t &index, const size_t &opIndex);
+			// Convert each token into an Operand, once the tokens are final.
+			void CompileOperands();
 
 
 		private:
@@ -140,12 +143,31 @@ private:
 			};
 
 
+			// An Operand is a token that has been converted in advance into what is
+			// needed to find its value: a number, a random value, or the handle of a
+			// condition, so that no strings need to be parsed or compared at runtime.
+			class Operand {
+			public:
+				explicit Operand(const std::string &token);
+
+				int64_t Evaluate(const ConditionsStore &conditions, const ConditionsStore &created) const;
+
+			private:
+				bool isRandom = false;
+				bool isCondition = false;
+				int64_t value = 0;
+				ConditionsStore::Handle condition;
+			};
+
+
 		private:
 			// Iteration of the sequence vector yields the result.
 			std::vector<Operation> sequence;
-			// The tokens vector converts into a data vector of numeric values during evaluation.
+			// The tokens and operators are kept for saving and logging.
 			std::vector<std::string> tokens;
 			std::vector<std::string> operators;
+			// The tokens, converted into the values they stand for.
+			std::vector<Operand> operands;
 			// The number of true (non-parentheses) operators.
 			int operatorCount = 0;
 		};
@@ -19,10 +19,34 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "DataWriter.h"
 #include "Logger.h"
 
+#include <algorithm>
+#include <atomic>
+#include <mutex>
 #include <utility>
+#include <vector>
 
 using namespace std;
 
+namespace {
+	// Every interned condition name, and the slot it was given. Names are
+	// never removed, so pointers to them remain valid.
+	mutex internMutex;
+	map<string, size_t> internedSlots;
+	vector<const string *> internedNames;
+	atomic<size_t> internedCount = 0;
+
+	// Find the slot of the given name, if it has been interned.
+	bool FindSlot(const string &name, size_t &slot)
+	{
+		lock_guard<mutex> lock(internMutex);
+		auto it = internedSlots.find(name);
+		if(it == internedSlots.end())
+			return false;
+		slot = it->second;
+		return true;
+	}
+}
+
 
 
 // Default constructor
@@ -135,6 +159,30 @@ ConditionsStore::ConditionEntry &ConditionsStore::ConditionEntry::operator-=(int
 
 
 
+// Intern the given condition name, giving it a slot if it does not have one yet.
+ConditionsStore::Handle::Handle(const string &name)
+{
+	lock_guard<mutex> lock(internMutex);
+	auto it = internedSlots.emplace(name, internedNames.size()).first;
+	if(it->second == internedNames.size())
+	{
+		internedNames.push_back(&it->first);
+		++internedCount;
+	}
+	slot = it->second;
+	this->name = &it->first;
+}
+
+
+
+const string &ConditionsStore::Handle::Name() const
+{
+	static const string EMPTY;
+	return name ? *name : EMPTY;
+}
+
+
+
 // Constructor with loading primary conditions from datanode.
 ConditionsStore::ConditionsStore(const DataNode &node)
 {
@@ -173,19 +221,19 @@ void ConditionsStore::Save(DataWriter &out) const
 {
 	out.Write("conditions");
 	out.BeginChild();
-	for(const auto &it : storage)
+	for(const EntryTable::Node *node : storage.Sorted())
 	{
 		// We don't need to save derived conditions that have a provider.
-		if(it.second.provider)
+		if(node->entry.provider)
 			continue;
 		// If the condition's value is 0, don't write it at all.
-		if(!it.second.value)
+		if(!node->entry.value)
 			continue;
 		// If the condition's value is 1, don't bother writing the 1.
-		if(it.second.value == 1)
-			out.Write(it.first);
+		if(node->entry.value == 1)
+			out.Write(node->name);
 		else
-			out.Write(it.first, it.second.value);
+			out.Write(node->name, node->entry.value);
 	}
 	out.EndChild();
 }
@@ -209,6 +257,25 @@ int64_t ConditionsStore::Get(const string &name) const
 
 
 
+// Get a condition using a name that was looked up in advance.
+int64_t ConditionsStore::Get(const Handle &condition) const
+{
+	if(!condition.name || condition.slot >= slotCount)
+		return Get(condition.Name());
+
+	auto it = slots.find(condition.slot);
+	if(it == slots.end())
+		return 0;
+
+	const ConditionEntry *ce = it->second;
+	if(!ce->provider)
+		return ce->value;
+
+	return ce->provider->getFunction(*condition.name);
+}
+
+
+
 // Add a value to a condition. Returns true on success, false on failure.
 bool ConditionsStore::Add(const string &name, int64_t value)
 {
@@ -224,10 +291,11 @@ bool ConditionsStore::Add(const string &name, int64_t value)
 // a set on the provider.
 bool ConditionsStore::Set(const string &name, int64_t value)
 {
+	UpdateSlots();
 	ConditionEntry *ce = GetEntry(name);
 	if(!ce)
 	{
-		(storage[name]).value = value;
+		CreateEntry(name).value = value;
 		return true;
 	}
 	if(!ce->provider)
@@ -244,13 +312,17 @@ bool ConditionsStore::Set(const string &name, int64_t value)
 // an erase on the provider.
 bool ConditionsStore::Erase(const string &name)
 {
+	UpdateSlots();
 	ConditionEntry *ce = GetEntry(name);
 	if(!ce)
 		return true;
 
 	if(!(ce->provider))
 	{
-		storage.erase(name);
+		size_t slot;
+		if(FindSlot(name, slot))
+			slots.erase(slot);
+		storage.Erase(name);
 		return true;
 	}
 	return ce->provider->eraseFunction(name);
@@ -260,23 +332,24 @@ bool ConditionsStore::Erase(const string &name)
 
 ConditionsStore::ConditionEntry &ConditionsStore::operator[](const string &name)
 {
+	UpdateSlots();
 	// Search for an exact match and return it if it exists.
-	auto it = storage.find(name);
-	if(it != storage.end())
-		return it->second;
+	ConditionEntry *ce = storage.Find(name);
+	if(ce)
+		return *ce;
 
 	// Check for a prefix provider.
 	ConditionEntry *ceprov = GetEntry(name);
 	// If no prefix provider is found, then just create a new value entry.
 	if(ceprov == nullptr)
-		return storage[name];
+		return CreateEntry(name);
 
 	// Found a matching prefixed entry provider, but no exact match for the entry itself,
 	// let's create the exact match based on the prefix provider.
-	ConditionEntry &ce = storage[name];
-	ce.provider = ceprov->provider;
-	ce.fullKey = name;
-	return ce;
+	ConditionEntry &entry = CreateEntry(name);
+	entry.provider = ceprov->provider;
+	entry.fullKey = name;
+	return entry;
 }
 
 
@@ -284,6 +357,7 @@ ConditionsStore::ConditionEntry &ConditionsStore::operator[](const string &name)
 // Build a provider for a given prefix.
 ConditionsStore::DerivedProvider &ConditionsStore::GetProviderPrefixed(const string &prefix)
 {
+	UpdateSlots();
 	auto it = providers.emplace(std::piecewise_construct,
 		std::forward_as_tuple(prefix),
 		std::forward_as_tuple(prefix, true));
@@ -295,20 +369,33 @@ ConditionsStore::DerivedProvider &ConditionsStore::GetProviderPrefixed(const str
 	}
 	if(VerifyProviderLocation(prefix, provider))
 	{
-		storage[prefix].provider = provider;
-		// Check if any matching later entries within the prefixed range use the same provider.
-		auto checkIt = storage.find(prefix);
-		while(checkIt != storage.end() && (0 == checkIt->first.compare(0, prefix.length(), prefix)))
-		{
-			ConditionEntry &ce = checkIt->second;
-			if(ce.provider != provider)
+		ConditionEntry &prefixEntry = CreateEntry(prefix);
+		prefixEntry.provider = provider;
+		prefixes.Add(prefix, &prefixEntry);
+		// Check if any entries within the prefixed range use a different provider.
+		for(const auto &node : storage.Nodes())
+			if(node->entry.provider != provider && !node->name.compare(0, prefix.length(), prefix))
 			{
-				ce.provider = provider;
-				ce.fullKey = checkIt->first;
+				node->entry.provider = provider;
+				node->entry.fullKey = node->name;
 				throw runtime_error("Replacing condition entries matching prefixed provider \""
 						+ prefix + "\".");
 			}
-			++checkIt;
+
+		// Interned names within the prefixed range get their own entries, just
+		// like names accessed through operator[], so they can be found by slot.
+		lock_guard<mutex> lock(internMutex);
+		auto nameIt = internedSlots.lower_bound(prefix);
+		while(nameIt != internedSlots.end() && !nameIt->first.compare(0, prefix.length(), prefix))
+		{
+			if(nameIt->second < slotCount && !slots.contains(nameIt->second))
+			{
+				ConditionEntry &ce = storage.Insert(nameIt->first);
+				ce.provider = provider;
+				ce.fullKey = nameIt->first;
+				slots[nameIt->second] = &ce;
+			}
+			++nameIt;
 		}
 	}
 	return *provider;
@@ -319,6 +406,7 @@ ConditionsStore::DerivedProvider &ConditionsStore::GetProviderPrefixed(const str
 // Build a provider for the condition identified by the given name.
 ConditionsStore::DerivedProvider &ConditionsStore::GetProviderNamed(const string &name)
 {
+	UpdateSlots();
 	auto it = providers.emplace(std::piecewise_construct,
 		std::forward_as_tuple(name),
 		std::forward_as_tuple(name, false));
@@ -326,7 +414,7 @@ ConditionsStore::DerivedProvider &ConditionsStore::GetProviderNamed(const string
 	if(provider->isPrefixProvider)
 		Logger::LogError("Error: Retrieving prefixed provider \"" + name + "\" as named provider.");
 	else if(VerifyProviderLocation(name, provider))
-		storage[name].provider = provider;
+		CreateEntry(name).provider = provider;
 	return *provider;
 }
 
@@ -335,8 +423,11 @@ ConditionsStore::DerivedProvider &ConditionsStore::GetProviderNamed(const string
 // Helper to completely remove all data and linked condition-providers from the store.
 void ConditionsStore::Clear()
 {
-	storage.clear();
+	storage.Clear();
+	prefixes.Clear();
 	providers.clear();
+	slots.clear();
+	slotCount = 0;
 }
 
 
@@ -345,10 +436,10 @@ void ConditionsStore::Clear()
 int64_t ConditionsStore::PrimariesSize() const
 {
 	int64_t result = 0;
-	for(const auto &it : storage)
+	for(const auto &node : storage.Nodes())
 	{
 		// We only count primary conditions; conditions that don't have a provider.
-		if(it.second.provider)
+		if(node->entry.provider)
 			continue;
 		++result;
 	}
@@ -367,26 +458,16 @@ ConditionsStore::ConditionEntry *ConditionsStore::GetEntry(const string &name)
 
 const ConditionsStore::ConditionEntry *ConditionsStore::GetEntry(const string &name) const
 {
-	if(storage.empty())
-		return nullptr;
-
-	// Perform a single search for values, named providers, and prefixed providers.
-	auto it = storage.upper_bound(name);
-	if(it == storage.begin())
+	if(storage.IsEmpty())
 		return nullptr;
 
-	--it;
 	// The entry is matching if we have an exact string match.
-	if(name == it->first)
-		return &(it->second);
+	const ConditionEntry *ce = storage.Find(name);
+	if(ce)
+		return ce;
 
-	// The entry is also matching when we have a prefix entry and the prefix part in the provider matches.
-	DerivedProvider *provider = it->second.provider;
-	if(provider && provider->isPrefixProvider && !name.compare(0, provider->name.length(), provider->name))
-		return &(it->second);
-
-	// And otherwise we don't have a match.
-	return nullptr;
+	// The entry is also matching when the name is in the range of a prefixed provider.
+	return prefixes.Find(name);
 }
 
 
@@ -394,26 +475,259 @@ const ConditionsStore::ConditionEntry *ConditionsStore::GetEntry(const string &n
 // Helper function to check if we can safely add a provider with the given name.
 bool ConditionsStore::VerifyProviderLocation(const string &name, DerivedProvider *provider) const
 {
-	auto it = storage.upper_bound(name);
-	if(it == storage.begin())
-		return true;
+	const ConditionEntry *ce = storage.Find(name);
+	if(ce)
+	{
+		// If we find the provider we are trying to add, then it apparently
+		// was safe to add the entry since it was already added before.
+		if(ce->provider == provider)
+			return true;
 
-	--it;
-	const ConditionEntry &ce = it->second;
+		if(!ce->provider)
+		{
+			Logger::LogError("Error: overwriting primary condition \"" + name + "\" with derived provider.");
+			return true;
+		}
+	}
 
-	// If we find the provider we are trying to add, then it apparently
-	// was safe to add the entry since it was already added before.
-	if(ce.provider == provider)
-		return true;
+	const ConditionEntry *prefixed = prefixes.Find(name);
+	if(prefixed && prefixed->provider != provider)
+		throw runtime_error("Error: not adding provider for \"" + name + "\""
+				", because it is within range of prefixed derived provider \"" + prefixed->provider->name + "\".");
+	return true;
+}
 
-	if(!ce.provider && it->first == name)
+
+
+ConditionsStore::ConditionEntry &ConditionsStore::CreateEntry(const string &name)
+{
+	ConditionEntry &ce = storage.Insert(name);
+	size_t slot;
+	if(FindSlot(name, slot) && slot < slotCount)
+		slots[slot] = &ce;
+	return ce;
+}
+
+
+
+// Look up the entries for any names interned since this was last done. This is
+// done before any change to the store, so that the slots remain correct.
+void ConditionsStore::UpdateSlots()
+{
+	size_t count = internedCount;
+	if(slotCount == count)
+		return;
+	// An empty store has no entries to find.
+	if(storage.IsEmpty())
 	{
-		Logger::LogError("Error: overwriting primary condition \"" + name + "\" with derived provider.");
-		return true;
+		slotCount = count;
+		return;
 	}
 
-	if(ce.provider && ce.provider->isPrefixProvider && 0 == name.compare(0, ce.provider->name.length(), ce.provider->name))
-		throw runtime_error("Error: not adding provider for \"" + name + "\""
-				", because it is within range of prefixed derived provider \"" + ce.provider->name + "\".");
-	return true;
+	lock_guard<mutex> lock(internMutex);
+	for( ; slotCount < count; ++slotCount)
+	{
+		const string &name = *internedNames[slotCount];
+		ConditionEntry *ce = storage.Find(name);
+		if(ce)
+		{
+			slots[slotCount] = ce;
+			continue;
+		}
+		// If this name is in the range of a prefixed provider, give it its own entry.
+		const ConditionEntry *prefixed = GetEntry(name);
+		if(prefixed)
+		{
+			ConditionEntry &entry = storage.Insert(name);
+			entry.provider = prefixed->provider;
+			entry.fullKey = name;
+			slots[slotCount] = &entry;
+		}
+	}
+}
+
+
+
+ConditionsStore::ConditionEntry *ConditionsStore::EntryTable::Find(const string &name) const
+{
+	if(buckets.empty())
+		return nullptr;
+
+	uint32_t index = buckets[FindBucket(name, hash<string>()(name))];
+	return index ? &nodes[index - 1]->entry : nullptr;
+}
+
+
+
+ConditionsStore::ConditionEntry &ConditionsStore::EntryTable::Insert(const string &name)
+{
+	// Keep the table at most half full, so that searches stay short.
+	if(2 * (nodes.size() + 1) > buckets.size())
+		Rehash(max<size_t>(16, 2 * buckets.size()));
+
+	size_t nameHash = hash<string>()(name);
+	size_t bucket = FindBucket(name, nameHash);
+	if(!buckets[bucket])
+	{
+		nodes.push_back(make_unique<Node>(Node{name, nameHash, ConditionEntry()}));
+		buckets[bucket] = nodes.size();
+	}
+	return nodes[buckets[bucket] - 1]->entry;
+}
+
+
+
+void ConditionsStore::EntryTable::Erase(const string &name)
+{
+	if(buckets.empty())
+		return;
+
+	size_t mask = buckets.size() - 1;
+	size_t hole = FindBucket(name, hash<string>()(name));
+	if(!buckets[hole])
+		return;
+	size_t index = buckets[hole] - 1;
+
+	// Move back any of the following entries that would otherwise no longer be
+	// found, because the search for them would stop at the empty bucket.
+	size_t next = (hole + 1) & mask;
+	while(buckets[next])
+	{
+		size_t ideal = nodes[buckets[next] - 1]->hash & mask;
+		if(((next - ideal) & mask) >= ((next - hole) & mask))
+		{
+			buckets[hole] = buckets[next];
+			hole = next;
+		}
+		next = (next + 1) & mask;
+	}
+	buckets[hole] = 0;
+
+	// Fill the gap in the list of nodes with the last one.
+	if(index != nodes.size() - 1)
+	{
+		buckets[FindBucket(nodes.back()->name, nodes.back()->hash)] = index + 1;
+		nodes[index] = std::move(nodes.back());
+	}
+	nodes.pop_back();
+}
+
+
+
+void ConditionsStore::EntryTable::Clear()
+{
+	nodes.clear();
+	buckets.clear();
+}
+
+
+
+bool ConditionsStore::EntryTable::IsEmpty() const
+{
+	return nodes.empty();
+}
+
+
+
+const vector<unique_ptr<ConditionsStore::EntryTable::Node>> &ConditionsStore::EntryTable::Nodes() const
+{
+	return nodes;
+}
+
+
+
+vector<const ConditionsStore::EntryTable::Node *> ConditionsStore::EntryTable::Sorted() const
+{
+	vector<const Node *> result;
+	result.reserve(nodes.size());
+	for(const auto &node : nodes)
+		result.push_back(node.get());
+	sort(result.begin(), result.end(), [](const Node *a, const Node *b) { return a->name < b->name; });
+	return result;
+}
+
+
+
+size_t ConditionsStore::EntryTable::FindBucket(const string &name, size_t nameHash) const
+{
+	size_t mask = buckets.size() - 1;
+	size_t bucket = nameHash & mask;
+	while(buckets[bucket])
+	{
+		const Node &node = *nodes[buckets[bucket] - 1];
+		if(node.hash == nameHash && node.name == name)
+			break;
+		bucket = (bucket + 1) & mask;
+	}
+	return bucket;
+}
+
+
+
+void ConditionsStore::EntryTable::Rehash(size_t size)
+{
+	buckets.assign(size, 0);
+	for(size_t i = 0; i < nodes.size(); ++i)
+	{
+		size_t bucket = nodes[i]->hash & (size - 1);
+		while(buckets[bucket])
+			bucket = (bucket + 1) & (size - 1);
+		buckets[bucket] = i + 1;
+	}
+}
+
+
+
+void ConditionsStore::PrefixTrie::Add(const string &prefix, ConditionEntry *entry)
+{
+	if(nodes.empty())
+		nodes.emplace_back();
+
+	uint32_t index = 0;
+	for(char c : prefix)
+	{
+		auto &children = nodes[index].children;
+		auto it = find_if(children.begin(), children.end(), [c](const pair<char, uint32_t> &child)
+			{ return child.first == c; });
+		if(it != children.end())
+			index = it->second;
+		else
+		{
+			uint32_t child = nodes.size();
+			children.emplace_back(c, child);
+			nodes.emplace_back();
+			index = child;
+		}
+	}
+	nodes[index].entry = entry;
+}
+
+
+
+ConditionsStore::ConditionEntry *ConditionsStore::PrefixTrie::Find(const string &name) const
+{
+	if(nodes.empty())
+		return nullptr;
+
+	uint32_t index = 0;
+	for(char c : name)
+	{
+		if(nodes[index].entry)
+			return nodes[index].entry;
+
+		const auto &children = nodes[index].children;
+		auto it = find_if(children.begin(), children.end(), [c](const pair<char, uint32_t> &child)
+			{ return child.first == c; });
+		if(it == children.end())
+			return nullptr;
+		index = it->second;
+	}
+	return nodes[index].entry;
+}
+
+
+
+void ConditionsStore::PrefixTrie::Clear()
+{
+	nodes.clear();
 }
@@ -15,11 +15,15 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 #include <functional>
 #include <initializer_list>
 #include <map>
+#include <memory>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 class DataNode;
 class DataWriter;
@@ -98,6 +102,25 @@ public:
 	};
 
 
+	// A condition name that has been looked up once, in advance. Each name is
+	// given a slot number shared by every ConditionsStore, so that a store can
+	// find its entry for the condition without comparing any strings.
+	class Handle {
+		friend ConditionsStore;
+
+	public:
+		Handle() = default;
+		explicit Handle(const std::string &name);
+
+		const std::string &Name() const;
+
+	private:
+		std::size_t slot = 0;
+		// The interned copy of the name, which is never freed.
+		const std::string *name = nullptr;
+	};
+
+
 
 public:
 	// Constructors to initialize this class.
@@ -105,6 +128,11 @@ public:
 	explicit ConditionsStore(const DataNode &node);
 	explicit ConditionsStore(std::initializer_list<std::pair<std::string, int64_t>> initialConditions);
 	explicit ConditionsStore(const std::map<std::string, int64_t> &initialConditions);
+	// Entries refer to this store's providers, so a store cannot be copied.
+	ConditionsStore(const ConditionsStore &) = delete;
+	ConditionsStore &operator=(const ConditionsStore &) = delete;
+	ConditionsStore(ConditionsStore &&) = default;
+	ConditionsStore &operator=(ConditionsStore &&) = default;
 
 	// Serialization support for this class.
 	void Load(const DataNode &node);
@@ -113,6 +141,7 @@ public:
 	// Retrieve a "condition" flag from this store (directly or from the
 	// connected provider).
 	int64_t Get(const std::string &name) const;
+	int64_t Get(const Handle &condition) const;
 
 	// Add a value to a condition, set a value for a condition or erase a
 	// condition completely. Returns true on success, false on failure.
@@ -141,11 +170,79 @@ private:
 	ConditionEntry *GetEntry(const std::string &name);
 	const ConditionEntry *GetEntry(const std::string &name) const;
 	bool VerifyProviderLocation(const std::string &name, DerivedProvider *provider) const;
+	// Create an entry for the given condition, and record it in its slot if
+	// the name has been interned.
+	ConditionEntry &CreateEntry(const std::string &name);
+	// Look up the entries for any names interned since this was last done.
+	void UpdateSlots();
+
+
+private:
+	// A hash table of condition entries, keyed by their full names. It uses open
+	// addressing with linear probing, and allocates each entry separately so that
+	// pointers to entries remain valid as the table grows.
+	class EntryTable {
+	public:
+		struct Node {
+			std::string name;
+			std::size_t hash;
+			ConditionEntry entry;
+		};
+
+	public:
+		ConditionEntry *Find(const std::string &name) const;
+		// Get the entry with the given name, creating it if there is none.
+		ConditionEntry &Insert(const std::string &name);
+		void Erase(const std::string &name);
+		void Clear();
+		bool IsEmpty() const;
+
+		// All the entries, in no particular order.
+		const std::vector<std::unique_ptr<Node>> &Nodes() const;
+		// All the entries, sorted by name.
+		std::vector<const Node *> Sorted() const;
+
+	private:
+		// Find the bucket that holds the given name, or the empty bucket where it
+		// would be inserted.
+		std::size_t FindBucket(const std::string &name, std::size_t hash) const;
+		void Rehash(std::size_t size);
+
+	private:
+		std::vector<std::unique_ptr<Node>> nodes;
+		// Each bucket holds one more than the index of its node, or 0 if empty.
+		std::vector<std::uint32_t> buckets;
+	};
+
+
+	// A trie of the prefixes of the prefixed providers, for finding whose range
+	// a condition name is in without searching through the entries.
+	class PrefixTrie {
+	public:
+		void Add(const std::string &prefix, ConditionEntry *entry);
+		// Get the entry of the shortest prefix that the given name starts with.
+		ConditionEntry *Find(const std::string &name) const;
+		void Clear();
+
+	private:
+		struct Node {
+			std::vector<std::pair<char, std::uint32_t>> children;
+			ConditionEntry *entry = nullptr;
+		};
+
+	private:
+		std::vector<Node> nodes;
+	};
 
 
 
 private:
 	// Storage for both the primary conditions as well as the providers.
-	std::map<std::string, ConditionEntry> storage;
+	EntryTable storage;
+	PrefixTrie prefixes;
 	std::map<std::string, DerivedProvider> providers;
+	// The entry for each interned condition name that this store has one for,
+	// by slot. Names interned after the last update are looked up by name.
+	std::unordered_map<std::size_t, ConditionEntry *> slots;
+	std::size_t slotCount = 0;
 };
@@ -18,8 +18,28 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "Files.h"
 #include "text/Utf8.h"
 
+#include <algorithm>
+#include <limits>
+#include <string_view>
+#include <utility>
+#include <vector>
+
 using namespace std;
 
+namespace {
+	// No data file nests its nodes anywhere near this deep, so compact data
+	// that does is corrupt, and reading it would only risk overflowing the stack.
+	constexpr size_t MAX_COMPACT_DEPTH = 1000;
+}
+
+
+
+// Check whether the given data is in the compact binary encoding.
+bool DataFile::IsCompact(string_view data)
+{
+	return data.starts_with(COMPACT_SIGNATURE);
+}
+
 
 
 // Constructor, taking a file path (in UTF-8).
@@ -45,14 +65,20 @@ void DataFile::Load(const string &path)
 	if(data.empty())
 		return;
 
-	// As a sentinel, make sure the file always ends in a newline.
-	if(data.back() != '\n')
-		data.push_back('\n');
-
 	// Note what file this node is in, so it will show up in error traces.
 	root.tokens.push_back("file");
 	root.tokens.push_back(path);
 
+	if(IsCompact(data))
+	{
+		LoadCompact(data);
+		return;
+	}
+
+	// As a sentinel, make sure the file always ends in a newline.
+	if(data.back() != '\n')
+		data.push_back('\n');
+
 	LoadData(data);
 }
 
@@ -71,6 +97,11 @@ void DataFile::Load(istream &in)
 		in.read(&*data.begin() + currentSize, BLOCK);
 		data.resize(currentSize + in.gcount());
 	}
+	if(IsCompact(data))
+	{
+		LoadCompact(data);
+		return;
+	}
 	// As a sentinel, make sure the file always ends in a newline.
 	if(data.empty() || data.back() != '\n')
 		data.push_back('\n');
@@ -80,8 +111,26 @@ void DataFile::Load(istream &in)
 
 
 
+// Load just the first node of the given data, which may be cut short
+// anywhere after that node.
+void DataFile::LoadFirstNode(const string &data)
+{
+	if(IsCompact(data))
+	{
+		LoadCompact(data, 1);
+		return;
+	}
+	// Text can simply be cut off after the first node.
+	size_t previousCount = root.children.size();
+	LoadData(data.empty() || data.back() != '\n' ? data + '\n' : data);
+	if(root.children.size() > previousCount + 1)
+		root.children.erase(root.children.begin() + previousCount + 1, root.children.end());
+}
+
+
+
 // Get an iterator to the start of the list of nodes in this file.
-list<DataNode>::const_iterator DataFile::begin() const
+vector<DataNode>::const_iterator DataFile::begin() const
 {
 	return root.begin();
 }
@@ -89,20 +138,44 @@ list<DataNode>::const_iterator DataFile::begin() const
 
 
 // Get an iterator to the end of the list of nodes in this file.
-list<DataNode>::const_iterator DataFile::end() const
+vector<DataNode>::const_iterator DataFile::end() const
 {
 	return root.end();
 }
 
 
 
-// Parse the given text.
+// Parse the given text. This is done in two passes. The first finds the tokens of
+// each line and where that line belongs in the tree, without allocating anything
+// per line. Then the nodes are created, at which point the exact number of
+// children and tokens of every node is known, so each node's storage is allocated
+// only once and every node's children are stored contiguously.
 void DataFile::LoadData(const string &data)
 {
+	// Placement of a line of the file within the node tree.
+	class Line {
+	public:
+		size_t lineNumber;
+		// The index of the parent line, or NO_PARENT if this is a root node.
+		size_t parent;
+		size_t firstToken;
+		size_t tokenCount = 0;
+		size_t childCount = 0;
+	};
+	static const size_t NO_PARENT = numeric_limits<size_t>::max();
+
+	vector<Line> lines;
+	// The tokens of every line, pointing into the text of the file.
+	vector<string_view> tokens;
+	size_t rootChildCount = 0;
+	// Warnings can only be printed once the node they refer to exists, so remember
+	// which line each one is for. Warnings about the file as a whole use NO_PARENT.
+	vector<pair<size_t, string>> warnings;
+
 	// Keep track of the current stack of indentation levels and the most recent
-	// node at each level - that is, the node that will be the "parent" of any
-	// new node added at the next deeper indentation level.
-	vector<DataNode *> stack(1, &root);
+	// line at each level - that is, the line that will be the "parent" of any
+	// new line added at the next deeper indentation level.
+	vector<size_t> stack(1, NO_PARENT);
 	vector<int> separatorStack(1, -1);
 	bool fileIsTabs = false;
 	bool fileIsSpaces = false;
@@ -147,7 +220,8 @@ void DataFile::LoadData(const string &data)
 		if(c == '#')
 		{
 			if(mixedIndentation)
-				root.PrintTrace("Warning: Mixed whitespace usage for comment at line " + to_string(lineNumber));
+				warnings.emplace_back(NO_PARENT,
+					"Warning: Mixed whitespace usage for comment at line " + to_string(lineNumber));
 			while(c != '\n')
 				c = Utf8::DecodeCodePoint(data, pos);
 		}
@@ -155,22 +229,23 @@ void DataFile::LoadData(const string &data)
 		if(c == '\n')
 			continue;
 
-		// Determine where in the node tree we are inserting this node, based on
-		// whether it has more indentation that the previous node, less, or the same.
+		// Determine where in the node tree we are inserting this line, based on
+		// whether it has more indentation that the previous line, less, or the same.
 		while(separatorStack.back() >= separators)
 		{
 			separatorStack.pop_back();
 			stack.pop_back();
 		}
 
-		// Add this node as a child of the proper node.
-		list<DataNode> &children = stack.back()->children;
-		children.emplace_back(stack.back());
-		DataNode &node = children.back();
-		node.lineNumber = lineNumber;
+		// Add this line as a child of the proper line.
+		size_t parent = stack.back();
+		++(parent == NO_PARENT ? rootChildCount : lines[parent].childCount);
+		size_t index = lines.size();
+		lines.push_back(Line{lineNumber, parent, tokens.size()});
+		Line &line = lines.back();
 
 		// Remember where in the tree we are.
-		stack.push_back(&node);
+		stack.push_back(index);
 		separatorStack.push_back(separators);
 
 		// Tokenize the line. Skip comments and empty lines.
@@ -195,16 +270,11 @@ void DataFile::LoadData(const string &data)
 				c = Utf8::DecodeCodePoint(data, pos);
 			}
 
-			// It ought to be legal to construct a string from an empty iterator
-			// range, but it appears that some libraries do not handle that case
-			// correctly. So:
-			if(tokenPos == endPos)
-				node.tokens.emplace_back();
-			else
-				node.tokens.emplace_back(data, tokenPos, endPos - tokenPos);
+			tokens.emplace_back(data.data() + tokenPos, endPos - tokenPos);
+			++line.tokenCount;
 			// This is not a fatal error, but it may indicate a format mistake:
 			if(isQuoted && c == '\n')
-				node.PrintTrace("Warning: Closing quotation mark is missing:");
+				warnings.emplace_back(index, "Warning: Closing quotation mark is missing:");
 
 			if(c != '\n')
 			{
@@ -230,11 +300,128 @@ void DataFile::LoadData(const string &data)
 				}
 			}
 		}
-		// Now that we've reached the end of the line, we know no more tokens will be added to the node.
-		node.tokens.shrink_to_fit();
 
-		// Now that we've tokenized this node, print any mixed whitespace warnings.
+		// Now that we've tokenized this line, note any mixed whitespace warnings.
 		if(mixedIndentation)
-			node.PrintTrace("Warning: Mixed whitespace usage at line");
+			warnings.emplace_back(index, "Warning: Mixed whitespace usage at line");
+	}
+
+	// Now create the nodes. Reserving the exact number of children that each node
+	// will have means no node is moved once it has been created, so the parent
+	// pointers of the nodes remain valid.
+	vector<DataNode *> nodes;
+	nodes.reserve(lines.size());
+	if(!root.children.empty())
+	{
+		// If something was already loaded, its nodes may have to move.
+		root.children.reserve(root.children.size() + rootChildCount);
+		for(DataNode &child : root.children)
+			child.parent = &root;
+	}
+	for(const Line &line : lines)
+	{
+		DataNode &parent = (line.parent == NO_PARENT ? root : *nodes[line.parent]);
+		if(parent.children.empty())
+			parent.children.reserve(line.parent == NO_PARENT ? rootChildCount : lines[line.parent].childCount);
+
+		auto first = tokens.begin() + line.firstToken;
+		vector<string> nodeTokens(first, first + line.tokenCount);
+		DataNode &node = parent.children.emplace_back(&parent, std::move(nodeTokens));
+		node.lineNumber = line.lineNumber;
+		nodes.push_back(&node);
+	}
+
+	for(const auto &[index, message] : warnings)
+		(index == NO_PARENT ? root : *nodes[index]).PrintTrace(message);
+}
+
+
+
+// Load nodes from the compact binary encoding. All numbers in it are stored as
+// variable-length integers, seven bits per byte. Each distinct token is stored
+// only once, the first time it appears; after that, it is referred to by its
+// index. Each node is stored as its number of tokens, its tokens, and its number
+// of children, followed by its children, so every node's children can be stored
+// contiguously, just as when parsing text. Nodes nested more than a thousand
+// deep are treated as corrupt data. If only the first few nodes are needed,
+// nothing after them is read, so the data may end anywhere after them.
+void DataFile::LoadCompact(const string &data, size_t maxNodes)
+{
+	size_t pos = COMPACT_SIGNATURE.size();
+	bool isValid = true;
+	auto ReadNumber = [&data, &pos, &isValid]() -> size_t
+	{
+		size_t value = 0;
+		for(int shift = 0; shift < 64 && pos < data.size(); shift += 7)
+		{
+			unsigned char byte = data[pos++];
+			value |= static_cast<size_t>(byte & 0x7F) << shift;
+			if(!(byte & 0x80))
+				return value;
+		}
+		isValid = false;
+		return 0;
+	};
+	// A token is either the index of a previous token plus one, or zero followed
+	// by the length and the characters of a new token.
+	vector<string> dictionary;
+	auto ReadToken = [&data, &pos, &isValid, &ReadNumber, &dictionary]() -> string
+	{
+		size_t index = ReadNumber();
+		if(index)
+		{
+			if(index <= dictionary.size())
+				return dictionary[index - 1];
+		}
+		else
+		{
+			size_t length = ReadNumber();
+			if(length <= data.size() - pos)
+			{
+				pos += length;
+				return dictionary.emplace_back(data, pos - length, length);
+			}
+		}
+		isValid = false;
+		return "";
+	};
+	// Read the given number of children of the given node, and their children.
+	auto ReadChildren = [&data, &pos, &isValid, &ReadNumber, &ReadToken](auto &ReadChildren,
+		DataNode &parent, size_t count, size_t depth) -> void
+	{
+		// Each node takes at least three bytes, so a larger count means the data is corrupt.
+		if(count > (data.size() - pos) / 3 || (count && depth >= MAX_COMPACT_DEPTH))
+		{
+			isValid = false;
+			return;
+		}
+		parent.children.reserve(parent.children.size() + count);
+		for(size_t i = 0; i < count && isValid; ++i)
+		{
+			size_t tokenCount = ReadNumber();
+			if(!tokenCount || tokenCount > data.size() - pos)
+			{
+				isValid = false;
+				return;
+			}
+			vector<string> tokens;
+			tokens.reserve(tokenCount);
+			for(size_t j = 0; j < tokenCount; ++j)
+				tokens.push_back(ReadToken());
+			DataNode &node = parent.children.emplace_back(&parent, std::move(tokens));
+			ReadChildren(ReadChildren, node, ReadNumber(), depth + 1);
+		}
+	};
+
+	// If something was already loaded, its nodes may have to move.
+	size_t previousCount = root.children.size();
+	ReadChildren(ReadChildren, root, min(ReadNumber(), maxNodes), 0);
+	for(DataNode &child : root.children)
+		child.parent = &root;
+
+	if(!isValid)
+	{
+		root.children.erase(root.children.begin() + previousCount, root.children.end());
+		root.PrintTrace("Error: Compact data is corrupt:");
 	}
 }
@@ -17,9 +17,12 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include "DataNode.h"
 
+#include <cstddef>
 #include <istream>
-#include <list>
+#include <limits>
 #include <string>
+#include <string_view>
+#include <vector>
 
 
 
@@ -29,7 +32,17 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 // it, it is a "child" of that node. Otherwise, it is a "sibling." Each node is
 // just a collection of one or more tokens that can be interpreted either as
 // strings or as floating point values; see DataNode for more information.
+// A DataFile can also be loaded from the compact binary encoding of the same
+// nodes that DataWriter::Compact() produces.
 class DataFile {
+public:
+	// Data in the compact binary encoding starts with this, which no text file
+	// starts with.
+	static constexpr std::string_view COMPACT_SIGNATURE{"\0ESD\x01", 5};
+	// Check whether the given data is in the compact binary encoding.
+	static bool IsCompact(std::string_view data);
+
+
 public:
 	// A DataFile can be loaded either from a file path or an istream.
 	DataFile() = default;
@@ -38,14 +51,19 @@ public:
 
 	void Load(const std::string &path);
 	void Load(std::istream &in);
+	// Load just the first node of the given data, which may be cut short
+	// anywhere after that node. This allows reading the start of a large file
+	// in the compact encoding without reading all of it.
+	void LoadFirstNode(const std::string &data);
 
 	// Functions for iterating through all DataNodes in this file.
-	std::list<DataNode>::const_iterator begin() const;
-	std::list<DataNode>::const_iterator end() const;
+	std::vector<DataNode>::const_iterator begin() const;
+	std::vector<DataNode>::const_iterator end() const;
 
 
 private:
 	void LoadData(const std::string &data);
+	void LoadCompact(const std::string &data, size_t maxNodes = std::numeric_limits<size_t>::max());
 
 
 private:
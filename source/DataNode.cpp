@@ -38,6 +38,14 @@ DataNode::DataNode(const DataNode *parent) noexcept(false)
 
 
 
+// Construct a DataNode from tokens that have already been found.
+DataNode::DataNode(const DataNode *parent, vector<string> &&tokens) noexcept
+	: tokens(std::move(tokens)), parent(parent)
+{
+}
+
+
+
 // Copy constructor.
 DataNode::DataNode(const DataNode &other)
 	: children(other.children), tokens(other.tokens), lineNumber(std::move(other.lineNumber))
@@ -274,7 +282,16 @@ bool DataNode::IsBool(const string &token)
 // Add a new child. The child's parent must be this node.
 void DataNode::AddChild(const DataNode &child)
 {
+	bool willMove = (children.size() == children.capacity());
 	children.emplace_back(child);
+	// If the existing children were moved to make room for the new one, their
+	// parent pointers were not carried over. (Their own children were updated
+	// by the move constructor.)
+	if(willMove)
+		for(DataNode &it : children)
+			it.parent = this;
+	else
+		children.back().parent = this;
 }
 
 
@@ -288,7 +305,7 @@ bool DataNode::HasChildren() const noexcept
 
 
 // Iterator to the beginning of the list of children.
-list<DataNode>::const_iterator DataNode::begin() const noexcept
+vector<DataNode>::const_iterator DataNode::begin() const noexcept
 {
 	return children.begin();
 }
@@ -296,7 +313,7 @@ list<DataNode>::const_iterator DataNode::begin() const noexcept
 
 
 // Iterator to the end of the list of children.
-list<DataNode>::const_iterator DataNode::end() const noexcept
+vector<DataNode>::const_iterator DataNode::end() const noexcept
 {
 	return children.end();
 }
@@ -16,7 +16,6 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #pragma once
 
 #include <cstdint>
-#include <list>
 #include <string>
 #include <vector>
 
@@ -33,6 +32,8 @@ public:
 	// Construct a DataNode. For the purpose of printing stack traces, each node
 	// must remember what its parent node is.
 	explicit DataNode(const DataNode *parent = nullptr) noexcept(false);
+	// Construct a DataNode with the given tokens.
+	DataNode(const DataNode *parent, std::vector<std::string> &&tokens) noexcept;
 	// Copying or moving a DataNode requires updating the parent pointers.
 	DataNode(const DataNode &other);
 	DataNode &operator=(const DataNode &other);
@@ -70,8 +71,8 @@ public:
 	// Check if this node has any children. If so, the iterator functions below
 	// can be used to access them.
 	bool HasChildren() const noexcept;
-	std::list<DataNode>::const_iterator begin() const noexcept;
-	std::list<DataNode>::const_iterator end() const noexcept;
+	std::vector<DataNode>::const_iterator begin() const noexcept;
+	std::vector<DataNode>::const_iterator end() const noexcept;
 
 	// Print a message followed by a "trace" of this node and its parents.
 	int PrintTrace(const std::string &message = "") const;
@@ -84,7 +85,9 @@ private:
 
 private:
 	// These are "child" nodes found on subsequent lines with deeper indentation.
-	std::list<DataNode> children;
+	// They are stored contiguously, so whenever they are moved to new storage
+	// their parent pointers must be updated.
+	std::vector<DataNode> children;
 	// These are the tokens found in this particular line of the data file.
 	std::vector<std::string> tokens;
 	// The parent pointer is used only for printing stack traces.
@@ -15,11 +15,59 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include "DataWriter.h"
 
+#include "DataFile.h"
 #include "DataNode.h"
 #include "Files.h"
 
+#include <iterator>
+#include <unordered_map>
+
 using namespace std;
 
+namespace {
+	// Helper for encoding nodes in the compact format that DataFile::LoadCompact()
+	// describes and reads.
+	class CompactWriter {
+	public:
+		explicit CompactWriter(string &out) : out(out) {}
+
+		void WriteNumber(size_t value)
+		{
+			for( ; value >= 0x80; value >>= 7)
+				out += static_cast<char>((value & 0x7F) | 0x80);
+			out += static_cast<char>(value);
+		}
+
+		void WriteToken(const string &token)
+		{
+			auto it = indices.find(token);
+			if(it != indices.end())
+				WriteNumber(it->second);
+			else
+			{
+				WriteNumber(0);
+				WriteNumber(token.size());
+				out += token;
+				indices.emplace(token, indices.size() + 1);
+			}
+		}
+
+		void WriteNode(const DataNode &node)
+		{
+			WriteNumber(node.Size());
+			for(const string &token : node.Tokens())
+				WriteToken(token);
+			WriteNumber(distance(node.begin(), node.end()));
+			for(const DataNode &child : node)
+				WriteNode(child);
+		}
+
+	private:
+		string &out;
+		unordered_map<string, size_t> indices;
+	};
+}
+
 
 
 // This string constant is just used for remembering what string needs to be
@@ -71,6 +119,20 @@ string DataWriter::SaveToString()
 
 
 
+// Encode the nodes of the given file in the compact binary encoding, which
+// DataFile can load just like text. Comments are not kept.
+string DataWriter::Compact(const DataFile &file)
+{
+	string result(DataFile::COMPACT_SIGNATURE);
+	CompactWriter writer(result);
+	writer.WriteNumber(distance(file.begin(), file.end()));
+	for(const DataNode &node : file)
+		writer.WriteNode(node);
+	return result;
+}
+
+
+
 // Write a DataNode with all its children.
 void DataWriter::Write(const DataNode &node)
 {
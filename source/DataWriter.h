@@ -21,6 +21,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include <string>
 #include <vector>
 
+class DataFile;
 class DataNode;
 
 
@@ -48,6 +49,9 @@ public:
 	void SaveToPath(const std::string &path);
 	// Get the contents as a string.
 	std::string SaveToString();
+	// Encode the nodes of the given file in the compact binary encoding, which
+	// DataFile can load just like text. Comments are not kept.
+	static std::string Compact(const DataFile &file);
 
 	// The Write() function can take any number of arguments. Each argument is
 	// converted to a token. Arguments may be strings or numeric values.
@@ -15,6 +15,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include "Dictionary.h"
 
+#include "Attribute.h"
 #include "StringInterner.h"
 
 #include <cstring>
@@ -25,6 +26,9 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 using namespace std;
 
 namespace {
+	// The slot of a known attribute that is not in a dictionary.
+	const uint32_t NOT_PRESENT = static_cast<uint32_t>(-1);
+
 	// Perform a binary search on a sorted vector. Return the key's location (or
 	// proper insertion spot) in the first element of the pair, and "true" in
 	// the second element if the key is already in the vector.
@@ -58,6 +62,18 @@ double &Dictionary::operator[](const char *key)
 	if(pos.second)
 		return data()[pos.first].second;
 
+	// Every known attribute after the insertion point moves down one place.
+	for(uint32_t &index : slots)
+		if(index != NOT_PRESENT && index >= pos.first)
+			++index;
+	const size_t slot = Attribute::Find(key);
+	if(slot != Attribute::NONE)
+	{
+		if(slots.empty())
+			slots.resize(Attribute::Count(), NOT_PRESENT);
+		slots[slot] = static_cast<uint32_t>(pos.first);
+	}
+
 	return insert(begin() + pos.first, make_pair(StringInterner::Intern(key), 0.))->second;
 }
 
@@ -82,3 +98,13 @@ double Dictionary::Get(const string &key) const
 {
 	return Get(key.c_str());
 }
+
+
+
+double Dictionary::Get(const Attribute &key) const
+{
+	if(slots.empty())
+		return 0.;
+	const uint32_t index = slots[key.Slot()];
+	return (index == NOT_PRESENT ? 0. : data()[index].second);
+}
@@ -15,10 +15,12 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #pragma once
 
+#include <cstdint>
 #include <string>
 #include <utility>
 #include <vector>
 
+class Attribute;
 
 
 // This class stores a mapping from character string keys to values, in a way
@@ -33,9 +35,17 @@ public:
 	// Get the value of a key, or 0 if it does not exist:
 	double Get(const char *key) const;
 	double Get(const std::string &key) const;
+	// Get the value of an attribute known at compile time, without a search:
+	double Get(const Attribute &key) const;
 
 	// Expose certain functions from the underlying vector:
 	using std::vector<std::pair<const char *, double>>::empty;
 	using std::vector<std::pair<const char *, double>>::begin;
 	using std::vector<std::pair<const char *, double>>::end;
+
+
+private:
+	// The index in the vector of each known attribute, if this dictionary
+	// contains any of them. This is kept up to date as keys are inserted.
+	std::vector<uint32_t> slots;
 };
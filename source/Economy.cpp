@@ -0,0 +1,220 @@
+/* Economy.cpp
+Copyright (c) 2026 by the Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "Economy.h"
+
+#include "Random.h"
+#include "System.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+
+namespace {
+	// Dynamic economy parameters: how much of its production each system keeps
+	// and exports each day:
+	const double KEEP = .89;
+	const double EXPORT = .10;
+	// Standard deviation of the daily production of each commodity:
+	const double VOLUME = 2000.;
+	// Above this supply amount, price differences taper off:
+	const double LIMIT = 20000.;
+}
+
+
+
+// Rebuild the matrices for the given systems and commodities. Each system
+// keeps its supply of every commodity it still trades in.
+void Economy::Update(const Set<System> &systems, const vector<Trade::Commodity> &commodities)
+{
+	Economy previous = std::move(*this);
+	*this = Economy();
+
+	for(const Trade::Commodity &commodity : commodities)
+		rows.emplace(commodity.name, rows.size());
+	tradedRows = rows.size();
+	for(const auto &it : systems)
+	{
+		columns.emplace(&it.second, columns.size());
+		// A system may also have a price for something that is not one of the
+		// regular commodities. Its supply changes every day, but it is not
+		// traded between systems.
+		for(const auto &base : it.second.BasePrices())
+			rows.emplace(base.first, rows.size());
+	}
+	systemCount = columns.size();
+
+	linkStart.reserve(systemCount + 1);
+	exportShare.resize(systemCount);
+	for(const auto &it : systems)
+	{
+		const System &system = it.second;
+		const size_t column = columns.at(&system);
+		linkStart.push_back(links.size());
+		for(const System *link : system.Links())
+		{
+			auto lit = columns.find(link);
+			if(lit != columns.end())
+				links.push_back(lit->second);
+		}
+		if(!system.Links().empty())
+			exportShare[column] = 1. / system.Links().size();
+	}
+	linkStart.push_back(links.size());
+
+	const size_t size = rows.size() * systemCount;
+	isTraded.resize(size);
+	basePrice.resize(size);
+	price.resize(size);
+	supply.resize(size);
+	exports.resize(size);
+	shipped.resize(systemCount);
+	for(const auto &it : systems)
+	{
+		const System &system = it.second;
+		const size_t column = columns.at(&system);
+		for(const auto &base : system.BasePrices())
+		{
+			const size_t index = rows.at(base.first) * systemCount + column;
+			isTraded[index] = true;
+			basePrice[index] = base.second;
+			const int64_t old = previous.Index(system, base.first);
+			if(old >= 0)
+			{
+				supply[index] = previous.supply[old];
+				exports[index] = previous.exports[old];
+			}
+			UpdatePrice(index);
+		}
+	}
+}
+
+
+
+// Set the supply of everything everywhere back to zero.
+void Economy::Reset()
+{
+	fill(supply.begin(), supply.end(), 0.);
+	fill(exports.begin(), exports.end(), 0.);
+	for(size_t index = 0; index < price.size(); ++index)
+		UpdatePrice(index);
+}
+
+
+
+// Have each system produce goods for one day, and export some of its supply
+// to each of the systems it is linked to.
+void Economy::Step()
+{
+	for(size_t row = 0; row < rows.size(); ++row)
+	{
+		const size_t begin = row * systemCount;
+		const uint8_t *traded = isTraded.data() + begin;
+		double *rowSupply = supply.data() + begin;
+		double *rowExports = exports.data() + begin;
+
+		// First, have each system generate new goods for local use and trade.
+		for(size_t i = 0; i < systemCount; ++i)
+			if(traded[i])
+			{
+				rowExports[i] = EXPORT * rowSupply[i];
+				rowSupply[i] = rowSupply[i] * KEEP + Random::Normal() * VOLUME;
+			}
+
+		// Then, send out the trade goods. This has to be done in a separate pass
+		// because otherwise whichever systems trade last would already have
+		// gotten supplied by the other systems.
+		if(row < tradedRows)
+		{
+			for(size_t i = 0; i < systemCount; ++i)
+				shipped[i] = rowExports[i] * exportShare[i];
+			for(size_t i = 0; i < systemCount; ++i)
+				if(traded[i])
+				{
+					double received = 0.;
+					for(size_t link = linkStart[i]; link < linkStart[i + 1]; ++link)
+						received += shipped[links[link]];
+					rowSupply[i] += received;
+				}
+		}
+
+		for(size_t i = 0; i < systemCount; ++i)
+			if(traded[i])
+				UpdatePrice(begin + i);
+	}
+}
+
+
+
+// Get the price of the given commodity in the given system, or zero if the
+// system does not trade in it.
+int Economy::Price(const System &system, const string &commodity) const
+{
+	const int64_t index = Index(system, commodity);
+	return index < 0 ? 0 : price[index];
+}
+
+
+
+double Economy::Supply(const System &system, const string &commodity) const
+{
+	const int64_t index = Index(system, commodity);
+	return index < 0 ? 0. : supply[index];
+}
+
+
+
+// Get how much of the given commodity the system exported on the last day.
+double Economy::Exports(const System &system, const string &commodity) const
+{
+	const int64_t index = Index(system, commodity);
+	return index < 0 ? 0. : exports[index];
+}
+
+
+
+// Set the supply of the given commodity, if the system trades in it.
+void Economy::SetSupply(const System &system, const string &commodity, double tons)
+{
+	const int64_t index = Index(system, commodity);
+	if(index < 0)
+		return;
+
+	supply[index] = tons;
+	UpdatePrice(index);
+}
+
+
+
+// Get the index of the given commodity and system in the matrices, or -1 if
+// that system does not trade in that commodity.
+int64_t Economy::Index(const System &system, const string &commodity) const
+{
+	auto rit = rows.find(commodity);
+	auto cit = columns.find(&system);
+	if(rit == rows.end() || cit == columns.end())
+		return -1;
+
+	const size_t index = rit->second * systemCount + cit->second;
+	return isTraded[index] ? static_cast<int64_t>(index) : -1;
+}
+
+
+
+void Economy::UpdatePrice(size_t index)
+{
+	price[index] = basePrice[index] + static_cast<int>(-100. * erf(supply[index] / LIMIT));
+}
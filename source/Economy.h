@@ -0,0 +1,89 @@
+/* Economy.h
+Copyright (c) 2026 by the Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "Set.h"
+#include "Trade.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class System;
+
+
+
+// Class holding the supply and price of every commodity in every system. They
+// are stored as dense matrices, with one row per commodity and one column per
+// system, and the hyperspace links between the systems are stored as an
+// adjacency list of column indices. That way, each day's production and trade
+// is a sweep over contiguous arrays, rather than a lookup by name of every
+// commodity in every system and in each of its neighbors. The System class's
+// trade accessors are views into these matrices.
+class Economy {
+public:
+	// Rebuild the matrices for the given systems and commodities. Each system
+	// keeps its supply of every commodity it still trades in.
+	void Update(const Set<System> &systems, const std::vector<Trade::Commodity> &commodities);
+	// Set the supply of everything everywhere back to zero.
+	void Reset();
+	// Have each system produce goods for one day, and export some of its supply
+	// to each of the systems it is linked to.
+	void Step();
+
+	// Get the price of the given commodity in the given system, or zero if the
+	// system does not trade in it.
+	int Price(const System &system, const std::string &commodity) const;
+	double Supply(const System &system, const std::string &commodity) const;
+	// Get how much of the given commodity the system exported on the last day.
+	double Exports(const System &system, const std::string &commodity) const;
+	// Set the supply of the given commodity, if the system trades in it.
+	void SetSupply(const System &system, const std::string &commodity, double tons);
+
+
+private:
+	// Get the index of the given commodity and system in the matrices, or -1 if
+	// that system does not trade in that commodity.
+	int64_t Index(const System &system, const std::string &commodity) const;
+	void UpdatePrice(size_t index);
+
+
+private:
+	std::unordered_map<std::string, size_t> rows;
+	std::unordered_map<const System *, size_t> columns;
+	size_t systemCount = 0;
+	// Only the rows of the regular commodities are traded between systems.
+	size_t tradedRows = 0;
+
+	// The systems each system is linked to are stored in links, from index
+	// linkStart[i] up to linkStart[i + 1]. Each system sends an equal share of
+	// its exports to each system it links to.
+	std::vector<size_t> linkStart;
+	std::vector<uint32_t> links;
+	std::vector<double> exportShare;
+
+	// The matrices, each with one row per commodity and one column per system.
+	std::vector<uint8_t> isTraded;
+	std::vector<int> basePrice;
+	std::vector<int> price;
+	std::vector<double> supply;
+	std::vector<double> exports;
+	// The share of its exports that each system sends to each of its links, for
+	// the commodity that is being traded.
+	std::vector<double> shipped;
+};
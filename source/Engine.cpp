@@ -16,6 +16,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "Engine.h"
 
 #include "AlertLabel.h"
+#include "Attribute.h"
 #include "audio/Audio.h"
 #include "CategoryList.h"
 #include "CategoryTypes.h"
@@ -26,6 +27,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "DamageProfile.h"
 #include "Effect.h"
 #include "FighterHitHelper.h"
+#include "Files.h"
 #include "FillShader.h"
 #include "Fleet.h"
 #include "Flotsam.h"
@@ -105,6 +107,21 @@ namespace {
 	constexpr auto Prune = [](auto &objects) { erase_if(objects,
 			[](const auto &obj) { return obj.ShouldBeRemoved(); }); };
 
+	// The number of ships moved by each task when ship movement is calculated in
+	// parallel. This is fixed so that the results do not depend on the CPU.
+	constexpr size_t SHIPS_PER_MOVE_CHUNK = 16;
+
+	// The number of projectiles whose collisions are found by each task.
+	constexpr size_t PROJECTILES_PER_COLLISION_CHUNK = 128;
+
+	// Wait for all of the given tasks to finish.
+	void WaitForAll(const vector<shared_future<void>> &futures)
+	{
+		for(const shared_future<void> &future : futures)
+			if(future.valid())
+				future.wait();
+	}
+
 	template <class Type>
 	void Append(vector<Type> &objects, vector<Type> &added)
 	{
@@ -242,6 +259,26 @@ namespace {
 
 		return make_pair(newCenter, newVelocity);
 	}
+
+	// Get the seed of the random number generator for the main thread or the
+	// calculation thread in the given step of a recorded flight. This uses the
+	// "SplitMix64" function, so that nearby steps get very different seeds.
+	uint64_t StepSeed(uint64_t seed, size_t step, bool isMainThread)
+	{
+		uint64_t z = seed + (2 * step + isMainThread + 1) * 0x9E3779B97F4A7C15ull;
+		z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+		z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+		return z ^ (z >> 31);
+	}
+
+	// Add the bytes of the given value to a 64-bit FNV-1a hash.
+	template <class Type>
+	void AddToHash(uint64_t &hash, const Type &value)
+	{
+		const unsigned char *bytes = reinterpret_cast<const unsigned char *>(&value);
+		for(size_t i = 0; i < sizeof(value); ++i)
+			hash = (hash ^ bytes[i]) * 0x100000001B3ull;
+	}
 }
 
 
@@ -491,12 +528,33 @@ void Engine::Wait()
 // Begin the next step of calculations.
 void Engine::Step(bool isActive)
 {
+	if(isStepCalculated)
+		RecordStep();
+
 	events.swap(eventQueue);
 	eventQueue.clear();
 
 	// Process any outstanding sprites that need to be uploaded to the GPU.
 	queue.ProcessSyncTasks();
 
+	// Summarize the recent step times for the step profiler overlay once a
+	// second, and save them as a trace if that was requested.
+	if(Preferences::Has("Show step profiler") && !(step % 60))
+	{
+		zoneStats.resize(static_cast<size_t>(Profiler::Zone::COUNT));
+		for(size_t i = 0; i < zoneStats.size(); ++i)
+			zoneStats[i] = profiler.Recent(static_cast<Profiler::Zone>(i));
+		stepStats = profiler.Recent();
+	}
+	if(doSaveTrace)
+	{
+		doSaveTrace = false;
+		const string path = Files::Config() + "step trace.json";
+		Files::Write(path, profiler.Trace());
+		Messages::Add("Saved the timing of the last " + to_string(min<int>(profiler.Steps(), Profiler::HISTORY_SIZE))
+			+ " steps to \"" + path + "\".", Messages::Importance::High);
+	}
+
 	// The calculation thread was paused by MainPanel before calling this function, so it is safe to access things.
 	const shared_ptr<Ship> flagship = player.FlagshipPtr();
 	const StellarObject *object = player.GetStellarObject();
@@ -547,7 +605,16 @@ void Engine::Step(bool isActive)
 			--jumpCount;
 	}
 	ai.UpdateEvents(events);
-	if(isActive)
+	if(replay)
+	{
+		// Give the AI the same keys that it was given in the recorded flight.
+		if(recordedSteps < replay->Steps() && replay->GetInput(recordedSteps).hasKeys)
+		{
+			Command keys = replay->GetInput(recordedSteps).keys;
+			ai.UpdateKeys(player, keys);
+		}
+	}
+	else if(isActive)
 	{
 		HandleKeyboardInputs();
 		// Ignore any inputs given when first becoming active, since those inputs
@@ -555,7 +622,14 @@ void Engine::Step(bool isActive)
 		if(!wasActive)
 			activeCommands.Clear();
 		else
+		{
 			ai.UpdateKeys(player, activeCommands);
+			if(recording)
+			{
+				recordedInput.hasKeys = true;
+				recordedInput.keys = activeCommands;
+			}
+		}
 	}
 
 	wasActive = isActive;
@@ -734,7 +808,7 @@ void Engine::Step(bool isActive)
 		// Have an alarm label flash up when enemy ships are in the system
 		if(alarmTime && step / 20 % 2 && Preferences::DisplayVisualAlert())
 			info.SetCondition("red alert");
-		double fuelCap = flagship->Attributes().Get("fuel capacity");
+		double fuelCap = flagship->Attributes().Get(Attribute("fuel capacity"));
 		// If the flagship has a large amount of fuel, display a solid bar.
 		// Otherwise, display a segment for every 100 units of fuel.
 		if(fuelCap <= MAX_FUEL_DISPLAY)
@@ -815,7 +889,7 @@ void Engine::Step(bool isActive)
 
 		targetVector = targetAsteroid->Position() - center;
 
-		if(flagship->Attributes().Get("tactical scan power"))
+		if(flagship->Attributes().Get(Attribute("tactical scan power")))
 		{
 			info.SetCondition("range display");
 			info.SetBar("target hull", targetAsteroid->Hull(), 20.);
@@ -858,7 +932,7 @@ void Engine::Step(bool isActive)
 			targetVector = target->Position() - center;
 
 			// Check if the target is close enough to show tactical information.
-			double tacticalRange = 100. * sqrt(flagship->Attributes().Get("tactical scan power"));
+			double tacticalRange = 100. * sqrt(flagship->Attributes().Get(Attribute("tactical scan power")));
 			double targetRange = target->Position().Distance(flagship->Position());
 			if(tacticalRange)
 			{
@@ -867,14 +941,14 @@ void Engine::Step(bool isActive)
 			}
 			// Actual tactical information requires a scrutable
 			// target that is within the tactical scanner range.
-			if((targetRange <= tacticalRange && !target->Attributes().Get("inscrutable"))
+			if((targetRange <= tacticalRange && !target->Attributes().Get(Attribute("inscrutable")))
 					|| (tacticalRange && target->IsYours()))
 			{
 				info.SetCondition("tactical display");
 				info.SetString("target crew", to_string(target->Crew()));
-				int fuel = round(target->Fuel() * target->Attributes().Get("fuel capacity"));
+				int fuel = round(target->Fuel() * target->Attributes().Get(Attribute("fuel capacity")));
 				info.SetString("target fuel", to_string(fuel));
-				int energy = round(target->Energy() * target->Attributes().Get("energy capacity"));
+				int energy = round(target->Energy() * target->Attributes().Get(Attribute("energy capacity")));
 				info.SetString("target energy", to_string(energy));
 				int heat = round(100. * target->Heat());
 				info.SetString("target heat", to_string(heat) + "%");
@@ -952,7 +1026,7 @@ void Engine::Step(bool isActive)
 	bool shouldCatalogAsteroids = (!isAsteroidCatalogComplete && !Random::Int(20));
 	if(shouldShowAsteroidOverlay || shouldCatalogAsteroids)
 	{
-		double scanRangeMetric = flagship ? 10000. * flagship->Attributes().Get("asteroid scan power") : 0.;
+		double scanRangeMetric = flagship ? 10000. * flagship->Attributes().Get(Attribute("asteroid scan power")) : 0.;
 		if(flagship && scanRangeMetric && !flagship->IsHyperspacing())
 		{
 			bool scanComplete = true;
@@ -1007,7 +1081,19 @@ void Engine::Go()
 {
 	++step;
 	currentCalcBuffer = currentCalcBuffer ? 0 : 1;
-	queue.Run([this] { CalculateStep(); });
+	isStepCalculated = true;
+	// If this flight is recorded or replayed, the calculation thread must start
+	// from the same random state in this step every time.
+	if(recording || replay)
+	{
+		const uint64_t seed = StepSeed(recordedSeed, recordedSteps, false);
+		queue.Run([this, seed] {
+			Random::Seed(seed);
+			CalculateStep();
+		});
+	}
+	else
+		queue.Run([this] { CalculateStep(); });
 }
 
 
@@ -1179,7 +1265,14 @@ void Engine::Draw() const
 		Color color = *colors.Get("medium");
 		font.Draw(loadString,
 			Point(-10 - font.Width(loadString), Screen::Height() * -.5 + 5.), color);
-	}
+		// Also show how many objects each collision check has had to look at.
+		string collisionString = Format::Decimal(collisionCandidates, 1) + " per collision check ("
+			+ to_string(collisionCellSize) + " grid)";
+		font.Draw(collisionString,
+			Point(-10 - font.Width(collisionString), Screen::Height() * -.5 + 25.), color);
+	}
+	if(Preferences::Has("Show step profiler"))
+		DrawProfiler();
 }
 
 
@@ -1259,6 +1352,78 @@ void Engine::BreakTargeting(const Government *gov)
 
 
 
+const Profiler &Engine::GetProfiler() const
+{
+	return profiler;
+}
+
+
+
+void Engine::SaveTrace()
+{
+	doSaveTrace = true;
+}
+
+
+
+// Record the player's input and the state of the game in each step from now
+// on, or replay the input from a recording instead of reading it from the
+// keyboard and mouse. Either one reseeds the random number generators in
+// every step, so that the game plays out the same way each time. Passing a
+// null pointer stops recording or replaying.
+void Engine::Record(Recording *recording)
+{
+	this->recording = recording;
+	replay = nullptr;
+	recordedInput = Recording::Input();
+	recordedSeed = recording ? recording->Seed() : 0;
+	recordedSteps = 0;
+	divergence = -1;
+	isStepCalculated = false;
+	if(recording)
+	{
+		recording->SetFirstStep(step);
+		Random::Seed(StepSeed(recordedSeed, 0, true));
+	}
+}
+
+
+
+void Engine::Replay(const Recording *recording)
+{
+	this->recording = nullptr;
+	replay = recording;
+	recordedInput = Recording::Input();
+	recordedSeed = recording ? recording->Seed() : 0;
+	recordedSteps = 0;
+	divergence = -1;
+	isStepCalculated = false;
+	if(recording)
+	{
+		step = recording->FirstStep();
+		Random::Seed(StepSeed(recordedSeed, 0, true));
+	}
+}
+
+
+
+// Get how many steps have been recorded or replayed.
+size_t Engine::RecordedSteps() const
+{
+	return recordedSteps;
+}
+
+
+
+// Get the first replayed step after which the state of the game was not
+// the same as in the recording, or -1 if there was none.
+int64_t Engine::Divergence() const
+{
+	return divergence;
+}
+
+
+
 void Engine::EnterSystem()
 {
 	ai.Clean();
@@ -1417,11 +1582,29 @@ void Engine::CalculateStep()
 
 	if(!player.GetSystem())
 		return;
+	profiler.BeginStep();
 
-	// Handle the mouse input of the mouse navigation
-	HandleMouseInput(activeCommands);
+	// Handle the mouse input of the mouse navigation, or replay the input that
+	// was given in this step of a recorded flight.
+	if(replay)
+	{
+		activeCommands = recordedSteps < replay->Steps() ? replay->GetInput(recordedSteps).command : Command();
+		isMouseTurningEnabled = activeCommands.Has(Command::MOUSE_TURNING_HOLD);
+		if(isMouseTurningEnabled)
+			ai.SetMousePosition(replay->GetInput(recordedSteps).mouse);
+	}
+	else
+		HandleMouseInput(activeCommands);
+	if(recording)
+	{
+		recordedInput.command = activeCommands;
+		recordedInput.mouse = isMouseTurningEnabled ? mousePosition : Point();
+	}
 	// Now, all the ships must decide what they are doing next.
-	ai.Step(activeCommands);
+	{
+		Profiler::Scope scope(profiler, Profiler::Zone::AI);
+		ai.Step(activeCommands);
+	}
 
 	// Clear the active players commands, they are all processed at this point.
 	activeCommands.Clear();
@@ -1440,24 +1623,37 @@ void Engine::CalculateStep()
 	const Ship *flagship = player.Flagship();
 	bool flagshipWasUntargetable = (flagship && !flagship->IsTargetable());
 	bool wasHyperspacing = (flagship && flagship->IsEnteringHyperspace());
-	// First, move the player's flagship.
-	if(flagship)
-		MoveShip(player.FlagshipPtr());
-	const System *flagshipSystem = (flagship ? flagship->GetSystem() : nullptr);
-	bool flagshipIsTargetable = (flagship && flagship->IsTargetable());
-	bool flagshipBecameTargetable = flagshipWasUntargetable && flagshipIsTargetable;
-	// Then, move the other ships.
-	for(const shared_ptr<Ship> &it : ships)
 	{
-		if(it == player.FlagshipPtr())
-			continue;
-		bool wasUntargetable = !it->IsTargetable();
-		MoveShip(it);
-		bool isTargetable = it->IsTargetable();
-		if(flagshipSystem == it->GetSystem()
-			&& ((wasUntargetable && isTargetable) || flagshipBecameTargetable)
-			&& isTargetable && flagshipIsTargetable)
-				eventQueue.emplace_back(player.FlagshipPtr(), it, ShipEvent::ENCOUNTER);
+		Profiler::Scope scope(profiler, Profiler::Zone::SHIPS);
+		// First, move the player's flagship.
+		if(flagship)
+			MoveShip(player.FlagshipPtr());
+		const System *flagshipSystem = (flagship ? flagship->GetSystem() : nullptr);
+		bool flagshipIsTargetable = (flagship && flagship->IsTargetable());
+		bool flagshipBecameTargetable = flagshipWasUntargetable && flagshipIsTargetable;
+		// Then, move the other ships. If enabled, the part of each ship's movement
+		// that does not interact with other ships is calculated in parallel first.
+		const bool isParallel = Preferences::Has("Parallel ship movement");
+		if(isParallel)
+			MoveShipsInParallel();
+		size_t index = 0;
+		for(const shared_ptr<Ship> &it : ships)
+		{
+			const ShipMove *parallelMove = isParallel ? &shipMoves[index++] : nullptr;
+			if(it == player.FlagshipPtr())
+				continue;
+			const ShipMove move = (parallelMove && parallelMove->isSelfMoved) ? *parallelMove : BeginMoveShip(*it);
+			if(!move.isSelfMoved)
+				it->Move(newVisuals, newFlotsam);
+			else if(move.needsFinish)
+				it->FinishMove(newVisuals);
+			FinishMoveShip(it, move);
+			bool isTargetable = it->IsTargetable();
+			if(flagshipSystem == it->GetSystem()
+				&& ((move.wasUntargetable && isTargetable) || flagshipBecameTargetable)
+				&& isTargetable && flagshipIsTargetable)
+					eventQueue.emplace_back(player.FlagshipPtr(), it, ShipEvent::ENCOUNTER);
+		}
 	}
 	// If the flagship just began jumping, play the appropriate sound.
 	if(!wasHyperspacing && flagship && flagship->IsEnteringHyperspace())
@@ -1497,7 +1693,10 @@ void Engine::CalculateStep()
 
 	// Move the asteroids. This must be done before collision detection. Minables
 	// may create visuals or flotsam.
-	asteroids.Step(newVisuals, newFlotsam, step);
+	{
+		Profiler::Scope scope(profiler, Profiler::Zone::ASTEROIDS);
+		asteroids.Step(newVisuals, newFlotsam, step);
+	}
 
 	// Move the flotsam. This must happen after the ships move, because flotsam
 	// checks if any ship has picked it up.
@@ -1506,14 +1705,20 @@ void Engine::CalculateStep()
 	PrunePointers(flotsam);
 
 	// Move the projectiles.
-	for(Projectile &projectile : projectiles)
-		projectile.Move(newVisuals, newProjectiles);
-	Prune(projectiles);
+	{
+		Profiler::Scope scope(profiler, Profiler::Zone::PROJECTILES);
+		for(Projectile &projectile : projectiles)
+			projectile.Move(newVisuals, newProjectiles);
+		Prune(projectiles);
+	}
 
 	// Step the weather.
-	for(Weather &weather : activeWeather)
-		weather.Step(newVisuals, flagship ? flagship->Position() : center);
-	Prune(activeWeather);
+	{
+		Profiler::Scope scope(profiler, Profiler::Zone::WEATHER);
+		for(Weather &weather : activeWeather)
+			weather.Step(newVisuals, flagship ? flagship->Position() : center);
+		Prune(activeWeather);
+	}
 
 	// Move the visuals.
 	for(Visual &visual : visuals)
@@ -1542,18 +1747,30 @@ void Engine::CalculateStep()
 		--grudgeTime;
 
 	// Populate the collision detection lookup sets.
-	FillCollisionSets();
+	{
+		Profiler::Scope scope(profiler, Profiler::Zone::COLLISION_SETS);
+		FillCollisionSets();
+	}
 
-	// Perform collision detection.
-	for(Projectile &projectile : projectiles)
-		DoCollisions(projectile);
+	// Perform collision detection. Finding what each projectile hits does not
+	// change anything, so that is done in parallel first. Then the collisions
+	// are applied one projectile at a time, in order.
+	{
+		Profiler::Scope scope(profiler, Profiler::Zone::COLLISIONS);
+		FindProjectileCollisions();
+		for(size_t i = 0; i < projectiles.size(); ++i)
+			DoCollisions(projectiles[i], projectileCollisions[i]);
+	}
 	// Now that collision detection is done, clear the cache of ships with anti-
 	// missile systems ready to fire.
 	hasAntiMissile.clear();
 
 	// Damage ships from any active weather events.
-	for(Weather &weather : activeWeather)
-		DoWeather(weather);
+	{
+		Profiler::Scope scope(profiler, Profiler::Zone::WEATHER);
+		for(Weather &weather : activeWeather)
+			DoWeather(weather);
+	}
 
 	// Check for flotsam collection (collisions with ships).
 	for(const shared_ptr<Flotsam> &it : flotsam)
@@ -1586,83 +1803,96 @@ void Engine::CalculateStep()
 	radar[currentCalcBuffer].SetCenter(newCenter);
 
 	// Populate the radar.
-	FillRadar();
+	{
+		Profiler::Scope scope(profiler, Profiler::Zone::RADAR);
+		FillRadar();
+	}
 
-	// Draw the planets.
-	for(const StellarObject &object : playerSystem->Objects())
-		if(object.HasSprite())
-		{
-			// Don't apply motion blur to very large planets and stars.
-			if(object.Width() >= 280.)
-				draw[currentCalcBuffer].AddUnblurred(object);
-			else
-				draw[currentCalcBuffer].Add(object);
-		}
-	// Draw the asteroids and minables.
-	asteroids.Draw(draw[currentCalcBuffer], newCenter, zoom);
-	// Draw the flotsam.
-	for(const shared_ptr<Flotsam> &it : flotsam)
-		draw[currentCalcBuffer].Add(*it);
-	// Draw the ships. Skip the flagship, then draw it on top of all the others.
-	bool showFlagship = false;
-	for(const shared_ptr<Ship> &ship : ships)
-		if(ship->GetSystem() == playerSystem && ship->HasSprite())
-		{
-			if(ship.get() != flagship)
+	{
+		Profiler::Scope scope(profiler, Profiler::Zone::DRAW);
+		// Draw the planets.
+		for(const StellarObject &object : playerSystem->Objects())
+			if(object.HasSprite())
 			{
-				DrawShipSprites(*ship);
-				if(ship->IsThrusting() && !ship->EnginePoints().empty())
-				{
-					for(const auto &it : ship->Attributes().FlareSounds())
-						Audio::Play(it.first, ship->Position());
-				}
-				else if(ship->IsReversing() && !ship->ReverseEnginePoints().empty())
-				{
-					for(const auto &it : ship->Attributes().ReverseFlareSounds())
-						Audio::Play(it.first, ship->Position());
-				}
-				if(ship->IsSteering() && !ship->SteeringEnginePoints().empty())
+				// Don't apply motion blur to very large planets and stars.
+				if(object.Width() >= 280.)
+					draw[currentCalcBuffer].AddUnblurred(object);
+				else
+					draw[currentCalcBuffer].Add(object);
+			}
+		// Draw the asteroids and minables.
+		asteroids.Draw(draw[currentCalcBuffer], newCenter, zoom);
+		// Draw the flotsam.
+		for(const shared_ptr<Flotsam> &it : flotsam)
+			draw[currentCalcBuffer].Add(*it);
+		// Draw the ships. Skip the flagship, then draw it on top of all the others.
+		bool showFlagship = false;
+		for(const shared_ptr<Ship> &ship : ships)
+			if(ship->GetSystem() == playerSystem && ship->HasSprite())
+			{
+				if(ship.get() != flagship)
 				{
-					for(const auto &it : ship->Attributes().SteeringFlareSounds())
-						Audio::Play(it.first, ship->Position());
+					DrawShipSprites(*ship);
+					if(ship->IsThrusting() && !ship->EnginePoints().empty())
+					{
+						for(const auto &it : ship->Attributes().FlareSounds())
+							Audio::Play(it.first, ship->Position());
+					}
+					else if(ship->IsReversing() && !ship->ReverseEnginePoints().empty())
+					{
+						for(const auto &it : ship->Attributes().ReverseFlareSounds())
+							Audio::Play(it.first, ship->Position());
+					}
+					if(ship->IsSteering() && !ship->SteeringEnginePoints().empty())
+					{
+						for(const auto &it : ship->Attributes().SteeringFlareSounds())
+							Audio::Play(it.first, ship->Position());
+					}
 				}
+				else
+					showFlagship = true;
 			}
-			else
-				showFlagship = true;
-		}
 
-	if(flagship && showFlagship)
-	{
-		DrawShipSprites(*flagship);
-		if(flagship->IsThrusting() && !flagship->EnginePoints().empty())
-		{
-			for(const auto &it : flagship->Attributes().FlareSounds())
-				Audio::Play(it.first);
-		}
-		else if(flagship->IsReversing() && !flagship->ReverseEnginePoints().empty())
+		if(flagship && showFlagship)
 		{
-			for(const auto &it : flagship->Attributes().ReverseFlareSounds())
-				Audio::Play(it.first);
-		}
-		if(flagship->IsSteering() && !flagship->SteeringEnginePoints().empty())
-		{
-			for(const auto &it : flagship->Attributes().SteeringFlareSounds())
-				Audio::Play(it.first);
+			DrawShipSprites(*flagship);
+			if(flagship->IsThrusting() && !flagship->EnginePoints().empty())
+			{
+				for(const auto &it : flagship->Attributes().FlareSounds())
+					Audio::Play(it.first);
+			}
+			else if(flagship->IsReversing() && !flagship->ReverseEnginePoints().empty())
+			{
+				for(const auto &it : flagship->Attributes().ReverseFlareSounds())
+					Audio::Play(it.first);
+			}
+			if(flagship->IsSteering() && !flagship->SteeringEnginePoints().empty())
+			{
+				for(const auto &it : flagship->Attributes().SteeringFlareSounds())
+					Audio::Play(it.first);
+			}
 		}
+		// Draw the projectiles.
+		for(const Projectile &projectile : projectiles)
+			batchDraw[currentCalcBuffer].Add(projectile, projectile.Clip());
+		// Draw the visuals.
+		for(const Visual &visual : visuals)
+			batchDraw[currentCalcBuffer].AddVisual(visual);
 	}
-	// Draw the projectiles.
-	for(const Projectile &projectile : projectiles)
-		batchDraw[currentCalcBuffer].Add(projectile, projectile.Clip());
-	// Draw the visuals.
-	for(const Visual &visual : visuals)
-		batchDraw[currentCalcBuffer].AddVisual(visual);
 
-	// Keep track of how much of the CPU time we are using.
+	profiler.EndStep();
+
+	// Keep track of how much of the CPU time we are using, and how much work
+	// each collision query takes.
 	loadSum += loadTimer.Time();
+	collisionCandidatesSum += shipCollisions.CandidatesPerQuery();
 	if(++loadCount == 60)
 	{
 		load = loadSum;
 		loadSum = 0.;
+		collisionCandidates = collisionCandidatesSum / 60.;
+		collisionCandidatesSum = 0.;
+		collisionCellSize = shipCollisions.CellSize();
 		loadCount = 0;
 	}
 }
@@ -1672,21 +1902,43 @@ void Engine::CalculateStep()
 // Move a ship. Also determine if the ship should generate hyperspace sounds or
 // boarding events, fire weapons, and launch fighters.
 void Engine::MoveShip(const shared_ptr<Ship> &ship)
+{
+	const ShipMove move = BeginMoveShip(*ship);
+	// Give the ship the list of visuals so that it can draw explosions,
+	// ion sparks, jump drive flashes, etc.
+	ship->Move(newVisuals, newFlotsam);
+	FinishMoveShip(ship, move);
+}
+
+
+
+// Prepare a ship to move, and record the parts of its state that the
+// results of the move will be compared against.
+Engine::ShipMove Engine::BeginMoveShip(Ship &ship) const
 {
 	// Various actions a ship could have taken last frame may have impacted the accuracy of cached values.
 	// Therefore, determine with any information needs recalculated and cache it.
-	ship->UpdateCaches();
+	ship.UpdateCaches();
 
 	const Ship *flagship = player.Flagship();
 
-	bool isJump = ship->IsUsingJumpDrive();
-	bool wasHere = (flagship && ship->GetSystem() == flagship->GetSystem());
-	bool wasHyperspacing = ship->IsHyperspacing();
-	bool wasDisabled = ship->IsDisabled();
-	// Give the ship the list of visuals so that it can draw explosions,
-	// ion sparks, jump drive flashes, etc.
-	ship->Move(newVisuals, newFlotsam);
-	if(ship->IsDisabled() && !wasDisabled)
+	ShipMove move;
+	move.isJump = ship.IsUsingJumpDrive();
+	move.wasHere = (flagship && ship.GetSystem() == flagship->GetSystem());
+	move.wasHyperspacing = ship.IsHyperspacing();
+	move.wasDisabled = ship.IsDisabled();
+	move.wasUntargetable = !ship.IsTargetable();
+	return move;
+}
+
+
+
+// Handle the results of a ship's move that affect the rest of the game.
+void Engine::FinishMoveShip(const shared_ptr<Ship> &ship, const ShipMove &move)
+{
+	const Ship *flagship = player.Flagship();
+
+	if(ship->IsDisabled() && !move.wasDisabled)
 		eventQueue.emplace_back(nullptr, ship, ShipEvent::DISABLE);
 	// Bail out if the ship just died.
 	if(ship->ShouldBeRemoved())
@@ -1711,24 +1963,24 @@ void Engine::MoveShip(const shared_ptr<Ship> &ship)
 		// The position from where sounds will be played.
 		Point position = ship->Position();
 		// Did this ship just begin hyperspacing?
-		if(wasHere && !wasHyperspacing && ship->IsHyperspacing())
+		if(move.wasHere && !move.wasHyperspacing && ship->IsHyperspacing())
 		{
-			const map<const Sound *, int> &jumpSounds = isJump
+			const map<const Sound *, int> &jumpSounds = move.isJump
 				? ship->Attributes().JumpOutSounds() : ship->Attributes().HyperOutSounds();
 			if(jumpSounds.empty())
-				Audio::Play(Audio::Get(isJump ? "jump out" : "hyperdrive out"), position);
+				Audio::Play(Audio::Get(move.isJump ? "jump out" : "hyperdrive out"), position);
 			else
 				for(const auto &sound : jumpSounds)
 					Audio::Play(sound.first, position);
 		}
 
 		// Did this ship just jump into the player's system?
-		if(!wasHere && flagship && ship->GetSystem() == flagship->GetSystem())
+		if(!move.wasHere && flagship && ship->GetSystem() == flagship->GetSystem())
 		{
-			const map<const Sound *, int> &jumpSounds = isJump
+			const map<const Sound *, int> &jumpSounds = move.isJump
 				? ship->Attributes().JumpInSounds() : ship->Attributes().HyperInSounds();
 			if(jumpSounds.empty())
-				Audio::Play(Audio::Get(isJump ? "jump in" : "hyperdrive in"), position);
+				Audio::Play(Audio::Get(move.isJump ? "jump in" : "hyperdrive in"), position);
 			else
 				for(const auto &sound : jumpSounds)
 					Audio::Play(sound.first, position);
@@ -1765,9 +2017,79 @@ void Engine::MoveShip(const shared_ptr<Ship> &ship)
 
 
 
+// Calculate the first half of the move (Ship::MoveSelf) for every ship that
+// can do so independently of the others, using the worker threads. The ships
+// are split into chunks of a fixed size, each with its own random seed and
+// lists of new visuals, flotsam and messages, and the chunks' results are
+// merged in order, so the outcome does not depend on how the chunks were
+// scheduled.
+void Engine::MoveShipsInParallel()
+{
+	class Chunk {
+	public:
+		vector<pair<Ship *, ShipMove *>> ships;
+		uint64_t seed = 0;
+		vector<Visual> visuals;
+		list<shared_ptr<Flotsam>> flotsam;
+		vector<pair<string, Messages::Importance>> messages;
+	};
+
+	const Ship *flagship = player.Flagship();
+	shipMoves.clear();
+	shipMoves.resize(ships.size());
+
+	vector<Chunk> chunks;
+	auto moveIt = shipMoves.begin();
+	for(const shared_ptr<Ship> &it : ships)
+	{
+		ShipMove &move = *moveIt++;
+		// Ships entering or exiting hyperspace keep track of their parent's
+		// position, so they are moved after all the other ships instead.
+		if(it.get() == flagship || it->IsEnteringHyperspace() || it->IsHyperspacing())
+			continue;
+		if(chunks.empty() || chunks.back().ships.size() == SHIPS_PER_MOVE_CHUNK)
+		{
+			chunks.emplace_back();
+			chunks.back().ships.reserve(SHIPS_PER_MOVE_CHUNK);
+			chunks.back().seed = (static_cast<uint64_t>(Random::Int()) << 32) | Random::Int();
+		}
+		chunks.back().ships.emplace_back(it.get(), &move);
+	}
+
+	vector<shared_future<void>> futures;
+	futures.reserve(chunks.size());
+	for(Chunk &chunk : chunks)
+		futures.push_back(queue.Run([this, &chunk]
+		{
+			// Start this worker's generator from the chunk's own seed, and hold
+			// back any messages, such as those about scanning, until the chunks
+			// can be merged.
+			Random::Seed(chunk.seed);
+			Messages::Deferred deferred(chunk.messages);
+			for(auto &[ship, move] : chunk.ships)
+			{
+				*move = BeginMoveShip(*ship);
+				move->isSelfMoved = true;
+				move->needsFinish = ship->MoveSelf(chunk.visuals, chunk.flotsam);
+			}
+		}));
+	WaitForAll(futures);
+
+	for(Chunk &chunk : chunks)
+	{
+		Append(newVisuals, chunk.visuals);
+		newFlotsam.splice(newFlotsam.end(), chunk.flotsam);
+		for(const auto &message : chunk.messages)
+			Messages::Add(message.first, message.second);
+	}
+}
+
+
+
 // Populate the ship collision detection set for projectile & flotsam computations.
 void Engine::FillCollisionSets()
 {
+	shipCollisions.SetAdaptive(Preferences::Has("Adaptive collision grid"));
 	shipCollisions.Clear(step);
 	for(const shared_ptr<Ship> &it : ships)
 		if(it->GetSystem() == player.GetSystem() && it->Zoom() == 1.)
@@ -2078,10 +2400,10 @@ void Engine::HandleMouseClicks()
 			}
 		}
 	}
-	else if(flagship->Attributes().Get("asteroid scan power"))
+	else if(flagship->Attributes().Get(Attribute("asteroid scan power")))
 	{
 		// If the click was not on any ship, check if it was on a minable.
-		double scanRange = 100. * sqrt(flagship->Attributes().Get("asteroid scan power"));
+		double scanRange = 100. * sqrt(flagship->Attributes().Get(Attribute("asteroid scan power")));
 		for(const shared_ptr<Minable> &minable : asteroids.Minables())
 		{
 			Point position = minable->Position() - flagship->Position();
@@ -2129,7 +2451,8 @@ void Engine::HandleMouseInput(Command &activeCommands)
 		rightMouseButtonHeld = true;
 	double relX = mousePosX - Screen::RawWidth() / 2.0;
 	double relY = mousePosY - Screen::RawHeight() / 2.0;
-	ai.SetMousePosition(Point(relX, relY));
+	mousePosition = Point(relX, relY);
+	ai.SetMousePosition(mousePosition);
 
 	// Activate firing command.
 	if(isMouseTurningEnabled && rightMouseButtonHeld)
@@ -2138,15 +2461,66 @@ void Engine::HandleMouseInput(Command &activeCommands)
 
 
 
-// Perform collision detection. Note that unlike the preceding functions, this
-// one adds any visuals that are created directly to the main visuals list. If
-// this is multi-threaded in the future, that will need to change.
-void Engine::DoCollisions(Projectile &projectile)
+// Record or check the state of the game after the step that was just
+// calculated, and reseed the random number generator for the next one.
+void Engine::RecordStep()
+{
+	isStepCalculated = false;
+	if(!recording && !replay)
+		return;
+
+	if(recording)
+		recording->Add(recordedInput, StateHash());
+	else if(recordedSteps < replay->Steps() && divergence < 0 && StateHash() != replay->Hash(recordedSteps))
+		divergence = recordedSteps;
+	recordedInput = Recording::Input();
+	++recordedSteps;
+
+	// Anything that the main thread does before the next step, such as handling
+	// the events of this one, must also use the same random numbers each time.
+	Random::Seed(StepSeed(recordedSeed, recordedSteps, true));
+}
+
+
+
+// Get a hash of the positions and condition of everything in the system.
+uint32_t Engine::StateHash() const
+{
+	uint64_t hash = 0xCBF29CE484222325ull;
+	for(const shared_ptr<Ship> &ship : ships)
+	{
+		AddToHash(hash, ship->Position().X());
+		AddToHash(hash, ship->Position().Y());
+		AddToHash(hash, ship->Velocity().X());
+		AddToHash(hash, ship->Velocity().Y());
+		AddToHash(hash, ship->Facing().Degrees());
+		AddToHash(hash, ship->Shields());
+		AddToHash(hash, ship->Hull());
+		AddToHash(hash, ship->Energy());
+		AddToHash(hash, ship->Fuel());
+	}
+	for(const Projectile &projectile : projectiles)
+	{
+		AddToHash(hash, projectile.Position().X());
+		AddToHash(hash, projectile.Position().Y());
+	}
+	AddToHash(hash, static_cast<uint64_t>(flotsam.size()));
+	return static_cast<uint32_t>(hash ^ (hash >> 32));
+}
+
+
+
+// Find everything the given projectile collides with in this step, without
+// changing anything. This is called from worker threads, each of which writes
+// only to the given projectile's own list of collisions and only reads the
+// collision sets and ships, which are not modified until all the workers are
+// done. The collisions are then applied, one projectile at a time and in
+// order, by DoCollisions().
+void Engine::FindCollisions(const Projectile &projectile, vector<Collision> &collisions) const
 {
 	// The asteroids can collide with projectiles, the same as any other
 	// object. If the asteroid turns out to be closer than the ship, it
 	// shields the ship (unless the projectile has a blast radius).
-	vector<Collision> collisions;
 	const Government *gov = projectile.GetGovernment();
 	const Weapon &weapon = projectile.GetWeapon();
 
@@ -2201,6 +2575,60 @@ void Engine::DoCollisions(Projectile &projectile)
 
 	// Sort the Collisions by increasing range so that the closer collisions are evaluated first.
 	sort(collisions.begin(), collisions.end());
+}
+
+
+
+// Find the collisions of every projectile, in parallel if there are enough
+// projectiles to make that worthwhile.
+void Engine::FindProjectileCollisions()
+{
+	// Masks are looked up by animation frame, which is calculated and cached
+	// the first time a body's mask is requested in a given step. Make sure that
+	// has already happened for the targets of phasing projectiles, so that the
+	// parallel lookups do not modify them. (The collision sets do the same for
+	// the objects in them.)
+	for(const Projectile &projectile : projectiles)
+		if(projectile.GetWeapon().IsPhasing() && projectile.Target())
+		{
+			shared_ptr<Ship> target = projectile.TargetPtr();
+			if(target)
+				target->GetFrame(step);
+		}
+
+	projectileCollisions.resize(projectiles.size());
+	auto findChunk = [this](size_t begin, size_t end)
+	{
+		for(size_t i = begin; i < end; ++i)
+		{
+			projectileCollisions[i].clear();
+			FindCollisions(projectiles[i], projectileCollisions[i]);
+		}
+	};
+
+	if(projectiles.size() <= PROJECTILES_PER_COLLISION_CHUNK)
+	{
+		findChunk(0, projectiles.size());
+		return;
+	}
+
+	vector<shared_future<void>> futures;
+	for(size_t begin = 0; begin < projectiles.size(); begin += PROJECTILES_PER_COLLISION_CHUNK)
+	{
+		size_t end = min(begin + PROJECTILES_PER_COLLISION_CHUNK, projectiles.size());
+		futures.push_back(queue.Run([&findChunk, begin, end] { findChunk(begin, end); }));
+	}
+	WaitForAll(futures);
+}
+
+
+
+// Apply the given collisions, found by FindCollisions(), to the given projectile
+// and the objects it hit.
+void Engine::DoCollisions(Projectile &projectile, vector<Collision> &collisions)
+{
+	const Government *gov = projectile.GetGovernment();
+	const Weapon &weapon = projectile.GetWeapon();
 
 	// Run all collisions until either the projectile dies or there are no more collisions left.
 	for(Collision &collision : collisions)
@@ -2413,7 +2841,7 @@ void Engine::DoCollection(Flotsam &flotsam)
 	if(flotsam.OutfitType())
 	{
 		const Outfit *outfit = flotsam.OutfitType();
-		if(outfit->Get("minable") > 0.)
+		if(outfit->Get(Attribute("minable")) > 0.)
 		{
 			commodity = outfit->DisplayName();
 			player.Harvest(outfit);
@@ -2628,6 +3056,46 @@ void Engine::DrawShipSprites(const Ship &ship)
 
 
 
+// Draw a table of how long each phase of the recent calculation steps took.
+void Engine::DrawProfiler() const
+{
+	const Font &font = FontSet::Get(14);
+	const Color &dim = *GameData::Colors().Get("medium");
+	const Color &bright = *GameData::Colors().Get("bright");
+	// The times are shown in milliseconds, right-aligned in columns to the
+	// right of the name of each zone.
+	static const double NAME_X = -260.;
+	static const double COLUMNS[] = {20., 80., 140., 200.};
+	auto DrawRow = [&font, &dim](const string &name, const Profiler::Stats &stats, const Color &color, double y)
+	{
+		font.Draw(name, Point(NAME_X, y), dim);
+		const double times[] = {stats.average, stats.median, stats.p95, stats.p99};
+		for(int i = 0; i < 4; ++i)
+		{
+			string text = Format::Decimal(1000. * times[i], 2);
+			font.Draw(text, Point(COLUMNS[i] - font.Width(text), y), color);
+		}
+	};
+
+	double y = Screen::Height() * -.5 + 45.;
+	static const string HEADINGS[] = {"avg", "p50", "p95", "p99"};
+	for(int i = 0; i < 4; ++i)
+		font.Draw(HEADINGS[i], Point(COLUMNS[i] - font.Width(HEADINGS[i]), y), bright);
+	font.Draw("ms per step", Point(NAME_X, y), bright);
+	for(size_t i = 0; i < zoneStats.size(); ++i)
+	{
+		y += 20.;
+		DrawRow(Profiler::Name(static_cast<Profiler::Zone>(i)), zoneStats[i], dim, y);
+	}
+	y += 20.;
+	DrawRow("step", stepStats, bright, y);
+	y += 20.;
+	static const string HINT = "Press F12 to save a trace of the last 10 seconds.";
+	font.Draw(HINT, Point(NAME_X, y), dim);
+}
+
+
+
 // If a ship just damaged another ship, update information on who has asked the
 // player for assistance (and ask for assistance if appropriate).
 void Engine::DoGrudge(const shared_ptr<Ship> &target, const Government *attacker)
@@ -29,12 +29,15 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "PlanetLabel.h"
 #include "Point.h"
 #include "Preferences.h"
+#include "Profiler.h"
 #include "Projectile.h"
 #include "Radar.h"
+#include "Recording.h"
 #include "Rectangle.h"
 #include "TaskQueue.h"
 
 #include <condition_variable>
+#include <cstdint>
 #include <list>
 #include <map>
 #include <memory>
@@ -98,6 +101,26 @@ public:
 	// projectiles stop targeting gov.
 	void BreakTargeting(const Government *gov);
 
+	// Get the times spent in each phase of the calculation step. This must only
+	// be accessed while the calculation thread is paused.
+	const Profiler &GetProfiler() const;
+	// Save the profiler's history of recent steps as a trace file, as soon as
+	// the calculation thread is paused.
+	void SaveTrace();
+
+	// Record the player's input and the state of the game in each step from now
+	// on, or replay the input from a recording instead of reading it from the
+	// keyboard and mouse. Either one reseeds the random number generators in
+	// every step, so that the game plays out the same way each time. Passing a
+	// null pointer stops recording or replaying.
+	void Record(Recording *recording);
+	void Replay(const Recording *recording);
+	// Get how many steps have been recorded or replayed.
+	size_t RecordedSteps() const;
+	// Get the first replayed step after which the state of the game was not
+	// the same as in the recording, or -1 if there was none.
+	int64_t Divergence() const;
+
 
 private:
 	class Outline {
@@ -141,6 +164,21 @@ private:
 		double angle;
 	};
 
+	// The state of a ship from before it moved this step, used to check what
+	// changed as a result of the move.
+	class ShipMove {
+	public:
+		bool isJump = false;
+		bool wasHere = false;
+		bool wasHyperspacing = false;
+		bool wasDisabled = false;
+		bool wasUntargetable = false;
+		// Whether the first half of this ship's move was already done in parallel,
+		// and if so, whether Ship::FinishMove() must still be called.
+		bool isSelfMoved = false;
+		bool needsFinish = false;
+	};
+
 	class Zoom {
 	public:
 		constexpr Zoom() : base(0.) {}
@@ -159,6 +197,9 @@ private:
 	void CalculateStep();
 
 	void MoveShip(const std::shared_ptr<Ship> &ship);
+	ShipMove BeginMoveShip(Ship &ship) const;
+	void FinishMoveShip(const std::shared_ptr<Ship> &ship, const ShipMove &move);
+	void MoveShipsInParallel();
 
 	void SpawnFleets();
 	void SpawnPersons();
@@ -167,10 +208,17 @@ private:
 	void HandleKeyboardInputs();
 	void HandleMouseClicks();
 	void HandleMouseInput(Command &activeCommands);
+	// Record or check the state of the game after the step that was just
+	// calculated, and reseed the random number generator for the next one.
+	void RecordStep();
+	// Get a hash of the positions and condition of everything in the system.
+	uint32_t StateHash() const;
 
 	void FillCollisionSets();
 
-	void DoCollisions(Projectile &projectile);
+	void FindProjectileCollisions();
+	void FindCollisions(const Projectile &projectile, std::vector<Collision> &collisions) const;
+	void DoCollisions(Projectile &projectile, std::vector<Collision> &collisions);
 	void DoWeather(Weather &weather);
 	void DoCollection(Flotsam &flotsam);
 	void DoScanning(const std::shared_ptr<Ship> &ship);
@@ -178,6 +226,7 @@ private:
 	void FillRadar();
 
 	void DrawShipSprites(const Ship &ship);
+	void DrawProfiler() const;
 
 	void DoGrudge(const std::shared_ptr<Ship> &target, const Government *attacker);
 
@@ -210,6 +259,9 @@ private:
 	AI ai;
 
 	TaskQueue queue;
+	// The state of each ship in the ships list before it moved this step, when
+	// ship movement is being calculated in parallel.
+	std::vector<ShipMove> shipMoves;
 
 	// ES uses a technique called double buffering to calculate the next frame and render the current one simultaneously.
 	// To facilitate this, it uses two buffers for each list of things to draw - one for the next frame's calculations and
@@ -255,6 +307,8 @@ private:
 	int grudgeTime = 0;
 
 	CollisionSet shipCollisions;
+	// The collisions found for each projectile in the current step.
+	std::vector<std::vector<Collision>> projectileCollisions;
 
 	int alarmTime = 0;
 	double flash = 0.;
@@ -294,4 +348,26 @@ private:
 	double load = 0.;
 	int loadCount = 0;
 	double loadSum = 0.;
+	// The average number of ships examined per ship collision query.
+	double collisionCandidates = 0.;
+	double collisionCandidatesSum = 0.;
+	unsigned collisionCellSize = 0;
+	Profiler profiler;
+	// Statistics of each zone of the profiler, and of the whole step, for the
+	// step profiler overlay. These are only updated once a second.
+	std::vector<Profiler::Stats> zoneStats;
+	Profiler::Stats stepStats;
+	bool doSaveTrace = false;
+
+	// The flight that is being recorded or replayed, if any.
+	Recording *recording = nullptr;
+	const Recording *replay = nullptr;
+	// The player's input in the step being calculated.
+	Recording::Input recordedInput;
+	uint64_t recordedSeed = 0;
+	size_t recordedSteps = 0;
+	int64_t divergence = -1;
+	bool isStepCalculated = false;
+	// Where the mouse was, if mouse turning is enabled.
+	Point mousePosition;
 };
@@ -17,6 +17,14 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include "Files.h"
 
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+#include <utility>
+
 using namespace std;
 
 
@@ -63,3 +71,28 @@ File::operator FILE*() const
 {
 	return file;
 }
+
+
+
+// Write anything that is buffered and make sure it reaches the disk. This
+// returns false if any of the data could not be written.
+bool File::Sync()
+{
+	if(!file || fflush(file))
+		return false;
+#ifdef _WIN32
+	return !_commit(_fileno(file));
+#else
+	return !fsync(fileno(file));
+#endif
+}
+
+
+
+// Close the file now, rather than when this object is destroyed.
+bool File::Close()
+{
+	if(!file)
+		return false;
+	return !fclose(exchange(file, nullptr));
+}
@@ -37,6 +37,14 @@ public:
 	explicit operator bool() const;
 	operator FILE*() const;
 
+	// Write anything that is buffered and make sure it reaches the disk. This
+	// returns false if any of the data could not be written.
+	bool Sync();
+	// Close the file now, rather than when this object is destroyed. This
+	// returns false if the file was not open or could not be closed cleanly,
+	// in which case some of the data written to it may have been lost.
+	bool Close();
+
 private:
 	FILE *file = nullptr;
 };
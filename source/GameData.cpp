@@ -24,6 +24,8 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "Conversation.h"
 #include "DataNode.h"
 #include "DataWriter.h"
+#include "DistanceMap.h"
+#include "Economy.h"
 #include "Effect.h"
 #include "Files.h"
 #include "FillShader.h"
@@ -35,6 +37,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "GameEvent.h"
 #include "Government.h"
 #include "Hazard.h"
+#include "image/ImageCache.h"
 #include "image/ImageSet.h"
 #include "Interface.h"
 #include "LineShader.h"
@@ -68,7 +71,12 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include <algorithm>
 #include <atomic>
 #include <iostream>
+#include <iterator>
+#include <mutex>
 #include <queue>
+#include <set>
+#include <tuple>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -98,6 +106,7 @@ namespace {
 
 	const Government *playerGovernment = nullptr;
 	map<const System *, map<string, int>> purchases;
+	Economy economy;
 
 	ConditionsStore globalConditions;
 
@@ -111,10 +120,77 @@ namespace {
 	mutex imageQueueMutex;
 	queue<shared_ptr<ImageSet>> imageQueue;
 
+	// Which missions may be offered where, so that not every mission in the game
+	// needs to be checked each time the player lands. Each mission is stored with
+	// its position in the list of all missions, so that the lists for a planet can
+	// be merged without changing the order the missions are offered in (which
+	// would change which random numbers each of them gets).
+	struct MissionIndex {
+		using List = vector<pair<int, const Mission *>>;
+
+		// The number of missions this index was built from. Missions are never
+		// removed, so this changes whenever one is added.
+		int size = -1;
+		// Missions offered when landing that can be offered on any planet.
+		List anywhere;
+		// Missions offered when landing that can only be offered on certain planets.
+		map<const Planet *, List> planets;
+		vector<const Mission *> boarding;
+		vector<const Mission *> assisting;
+	};
+	MissionIndex missionIndex;
+
+	// How many days it takes to travel from a system to every other system, for
+	// each combination of travel settings that has been asked about. Each system
+	// is given a position in the tables the first time they are used, and the
+	// tables are thrown out whenever a change to the universe may change routes.
+	// Only the days are kept, because which of several equally short routes is
+	// chosen depends on how dangerous each system is, which changes whenever the
+	// player's reputation does.
+	struct RouteTables {
+		unordered_map<const System *, size_t> index;
+		map<tuple<const System *, WormholeStrategy, bool>, vector<int>> days;
+	};
+	mutex routeMutex;
+	RouteTables routeTables;
+
+	void ClearRoutes()
+	{
+		lock_guard<mutex> lock(routeMutex);
+		routeTables = RouteTables();
+	}
+
+	const MissionIndex &GetMissionIndex()
+	{
+		const Set<Mission> &missions = GameData::Missions();
+		if(missionIndex.size == missions.size())
+			return missionIndex;
+
+		missionIndex = MissionIndex();
+		missionIndex.size = missions.size();
+		int position = 0;
+		set<const Planet *> sourcePlanets;
+		for(const auto &it : missions)
+		{
+			const Mission *mission = &it.second;
+			if(mission->IsAtLocation(Mission::BOARDING))
+				missionIndex.boarding.push_back(mission);
+			else if(mission->IsAtLocation(Mission::ASSISTING))
+				missionIndex.assisting.push_back(mission);
+			else if(mission->GetSourcePlanets(sourcePlanets))
+				for(const Planet *planet : sourcePlanets)
+					missionIndex.planets[planet].emplace_back(position, mission);
+			else
+				missionIndex.anywhere.emplace_back(position, mission);
+			++position;
+		}
+		return missionIndex;
+	}
+
 	// Loads a sprite and queues it for upload to the GPU.
 	void LoadSprite(TaskQueue &queue, const shared_ptr<ImageSet> &image)
 	{
-		queue.Run([image] { image->Load(); },
+		queue.Run([image, &queue] { image->Load(queue); },
 			[image] { image->Upload(SpriteSet::Modify(image->Name()), !preventSpriteUpload); });
 	}
 
@@ -135,7 +211,7 @@ namespace {
 	// Recursively loads the next image in the queue, if any.
 	void LoadSpriteQueued(TaskQueue &queue, const shared_ptr<ImageSet> &image)
 	{
-		queue.Run([image] { image->Load(); },
+		queue.Run([image, &queue] { image->Load(queue); },
 			[image, &queue]
 			{
 				image->Upload(SpriteSet::Modify(image->Name()), !preventSpriteUpload);
@@ -195,6 +271,12 @@ shared_future<void> GameData::BeginLoad(TaskQueue &queue, bool onlyLoadData, boo
 			// paths override the default images.
 			map<string, shared_ptr<ImageSet>> images = FindImages();
 
+			// Remove any cached images whose source images no longer exist.
+			set<string> names;
+			for(const auto &it : images)
+				names.insert(it.first);
+			ImageCache::Prune(names);
+
 			// From the name, strip out any frame number, plus the extension.
 			for(auto &it : images)
 			{
@@ -248,6 +330,7 @@ void GameData::FinishLoading()
 	playerGovernment = objects.governments.Get("Escort");
 
 	politics.Reset();
+	economy.Update(objects.systems, Commodities());
 }
 
 
@@ -383,6 +466,9 @@ void GameData::Revert()
 
 	politics.Reset();
 	purchases.clear();
+	economy.Update(objects.systems, Commodities());
+	economy.Reset();
+	ClearRoutes();
 }
 
 
@@ -486,29 +572,9 @@ void GameData::StepEconomy()
 	}
 	purchases.clear();
 
-	// Then, have each system generate new goods for local use and trade.
-	for(auto &it : objects.systems)
-		it.second.StepEconomy();
-
-	// Finally, send out the trade goods. This has to be done in a separate step
-	// because otherwise whichever systems trade last would already have gotten
-	// supplied by the other systems.
-	for(auto &it : objects.systems)
-	{
-		System &system = it.second;
-		if(!system.Links().empty())
-			for(const Trade::Commodity &commodity : Commodities())
-			{
-				double supply = system.Supply(commodity.name);
-				for(const System *neighbor : system.Links())
-				{
-					double scale = neighbor->Links().size();
-					if(scale)
-						supply += neighbor->Exports(commodity.name) / scale;
-				}
-				system.SetSupply(commodity.name, supply);
-			}
-	}
+	// Then, have each system generate new goods for local use and trade, and
+	// send out the trade goods to its neighbors.
+	economy.Step();
 }
 
 
@@ -525,6 +591,7 @@ void GameData::AddPurchase(const System &system, const string &commodity, int to
 void GameData::Change(const DataNode &node)
 {
 	objects.Change(node);
+	ClearRoutes();
 }
 
 
@@ -534,6 +601,8 @@ void GameData::Change(const DataNode &node)
 void GameData::UpdateSystems()
 {
 	objects.UpdateSystems();
+	economy.Update(objects.systems, Commodities());
+	ClearRoutes();
 }
 
 
@@ -541,6 +610,37 @@ void GameData::UpdateSystems()
 void GameData::AddJumpRange(double neighborDistance)
 {
 	objects.neighborDistances.insert(neighborDistance);
+	ClearRoutes();
+}
+
+
+
+int GameData::TravelDays(const System *from, const System *to, WormholeStrategy wormholeStrategy, bool useJumpDrive)
+{
+	if(!from || !to)
+		return -1;
+
+	lock_guard<mutex> lock(routeMutex);
+	if(routeTables.index.empty())
+		for(const auto &it : objects.systems)
+			routeTables.index.emplace(&it.second, routeTables.index.size());
+	auto target = routeTables.index.find(to);
+	if(target == routeTables.index.end())
+		return -1;
+
+	vector<int> &days = routeTables.days[{from, wormholeStrategy, useJumpDrive}];
+	if(days.empty())
+	{
+		days.resize(routeTables.index.size(), -1);
+		const DistanceMap distance(from, wormholeStrategy, useJumpDrive);
+		for(const System *system : distance.Systems())
+		{
+			auto it = routeTables.index.find(system);
+			if(it != routeTables.index.end())
+				days[it->second] = distance.Days(system);
+		}
+	}
+	return days[target->second];
 }
 
 
@@ -648,6 +748,39 @@ const Set<Mission> &GameData::Missions()
 
 
 
+vector<const Mission *> GameData::MissionsOfferedAt(const Planet *planet)
+{
+	const MissionIndex &index = GetMissionIndex();
+	auto it = index.planets.find(planet);
+	if(it == index.planets.end())
+	{
+		vector<const Mission *> result;
+		result.reserve(index.anywhere.size());
+		for(const auto &entry : index.anywhere)
+			result.push_back(entry.second);
+		return result;
+	}
+
+	MissionIndex::List merged;
+	merged.reserve(index.anywhere.size() + it->second.size());
+	merge(index.anywhere.begin(), index.anywhere.end(), it->second.begin(), it->second.end(), back_inserter(merged));
+	vector<const Mission *> result;
+	result.reserve(merged.size());
+	for(const auto &entry : merged)
+		result.push_back(entry.second);
+	return result;
+}
+
+
+
+const vector<const Mission *> &GameData::MissionsOfferedOnShips(bool isEnemy)
+{
+	const MissionIndex &index = GetMissionIndex();
+	return isEnemy ? index.boarding : index.assisting;
+}
+
+
+
 const Set<News> &GameData::SpaceportNews()
 {
 	return objects.news;
@@ -753,6 +886,13 @@ Politics &GameData::GetPolitics()
 
 
 
+Economy &GameData::GetEconomy()
+{
+	return economy;
+}
+
+
+
 const vector<StartConditions> &GameData::StartOptions()
 {
 	return objects.startConditions;
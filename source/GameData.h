@@ -19,6 +19,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "Sale.h"
 #include "Set.h"
 #include "Trade.h"
+#include "WormholeStrategy.h"
 
 #include <future>
 #include <map>
@@ -33,6 +34,7 @@ class Conversation;
 class DataNode;
 class DataWriter;
 class Date;
+class Economy;
 class Effect;
 class Fleet;
 class FormationPattern;
@@ -108,6 +110,12 @@ public:
 	// This must be done any time that a change creates or moves a system.
 	static void UpdateSystems();
 	static void AddJumpRange(double neighborDistance);
+	// Get how many days it takes to travel from one system to another, or -1 if
+	// there is no route. This is the same as DistanceMap::Days() for a map with
+	// the given settings, but the days to every system are computed only once
+	// for each starting system and kept until the map of the galaxy changes.
+	static int TravelDays(const System *from, const System *to,
+		WormholeStrategy wormholeStrategy = WormholeStrategy::NONE, bool useJumpDrive = false);
 
 	// Re-activate any special persons that were created previously but that are
 	// still alive.
@@ -140,10 +148,19 @@ public:
 	static const Set<TestData> &TestDataSets();
 	static const Set<Wormhole> &Wormholes();
 
+	// Get the missions that may be offered when landing on the given planet, in
+	// the same order as Missions(). This only leaves out missions that can never
+	// be offered there, so each one must still be checked with CanOffer().
+	static std::vector<const Mission *> MissionsOfferedAt(const Planet *planet);
+	// Get the missions that may be offered when boarding an enemy ship, or when
+	// assisting a ship that is not an enemy, in the same order as Missions().
+	static const std::vector<const Mission *> &MissionsOfferedOnShips(bool isEnemy);
+
 	static ConditionsStore &GlobalConditions();
 
 	static const Government *PlayerGovernment();
 	static Politics &GetPolitics();
+	static Economy &GetEconomy();
 	static const std::vector<StartConditions> &StartOptions();
 
 	static const std::vector<Trade::Commodity> &Commodities();
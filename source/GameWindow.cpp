@@ -18,7 +18,9 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "Files.h"
 #include "image/ImageBuffer.h"
 #include "Logger.h"
+#include "Preferences.h"
 #include "Screen.h"
+#include "image/Sprite.h"
 
 #include "opengl.h"
 #include <SDL2/SDL.h>
@@ -233,6 +235,7 @@ bool GameWindow::Init(bool headless)
 
 	// Check for support of various graphical features.
 	supportsAdaptiveVSync = OpenGL::HasAdaptiveVSyncSupport();
+	Sprite::SetCompression(Preferences::Has("Compress graphics") && OpenGL::HasTextureCompressionSupport());
 
 	// Enable the user's preferred VSync state, otherwise update to an available
 	// value (e.g. if an external program is forcing a particular VSync state).
@@ -126,6 +126,8 @@ LoadPanel::LoadPanel(PlayerInfo &player, UI &gamePanels)
 	if(player.GetPlanet() && !player.IsDead() && !gamePanels.IsTop(&*gamePanels.Root())
 			&& gamePanels.CanSave())
 		player.Save();
+	// The files listed here must be up to date, so that they can be copied or deleted.
+	PlayerInfo::FinishSaving();
 	UpdateLists();
 }
 
@@ -434,6 +434,25 @@ bool LocationFilter::Matches(const Ship &ship) const
 
 
 
+// If this filter can only ever match planets from a fixed list, no matter
+// how the game state changes, fill in that list and return true.
+bool LocationFilter::GetPlanets(set<const Planet *> &result) const
+{
+	// A filter that specifies ship categories never matches any planet.
+	if(!shipCategory.empty())
+	{
+		result.clear();
+		return true;
+	}
+	if(planets.empty())
+		return false;
+
+	result = planets;
+	return true;
+}
+
+
+
 // Convert a "distance" filter into a "near" filter.
 LocationFilter LocationFilter::SetOrigin(const System *origin) const
 {
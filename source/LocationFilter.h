@@ -57,6 +57,9 @@ public:
 	// Ships are chosen based on system/"near" filters, government, category
 	// of ship, outfits installed/carried, and their total attributes.
 	bool Matches(const Ship &ship) const;
+	// If this filter can only ever match planets from a fixed list, no matter
+	// how the game state changes, fill in that list and return true.
+	bool GetPlanets(std::set<const Planet *> &result) const;
 
 	// Return a new LocationFilter with any "distance" conditions converted
 	// into "near" references, relative to the given system.
@@ -38,6 +38,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "PlayerInfo.h"
 #include "PlayerInfoPanel.h"
 #include "Preferences.h"
+#include "Recording.h"
 #include "Screen.h"
 #include "Ship.h"
 #include "ShipEvent.h"
@@ -102,6 +103,9 @@ void MainPanel::Step()
 	if(isActive && player.GetPlanet() && !player.GetPlanet()->IsWormhole())
 	{
 		GetUI()->Push(new PlanetPanel(player, bind(&MainPanel::OnCallback, this)));
+		// A recorded flight ends with the landing.
+		engine.Record(nullptr);
+		Recording::End();
 		player.Land(GetUI());
 		isActive = false;
 	}
@@ -170,6 +174,8 @@ void MainPanel::Draw()
 // The planet panel calls this when it closes.
 void MainPanel::OnCallback()
 {
+	// If this flight is being recorded, that must start before the ships are placed.
+	engine.Record(Recording::Current());
 	engine.Place();
 	// Run one step of the simulation to fill in the new planet locations.
 	engine.Go();
@@ -231,6 +237,8 @@ bool MainPanel::KeyDown(SDL_Keycode key, Uint16 mod, const Command &command, boo
 		Preferences::ZoomViewIn();
 	else if(key >= '0' && key <= '9' && !command)
 		engine.SelectGroup(key - '0', mod & KMOD_SHIFT, mod & (KMOD_CTRL | KMOD_GUI));
+	else if(key == SDLK_F12 && !command && Preferences::Has("Show step profiler"))
+		engine.SaveTrace();
 	else
 		return false;
 
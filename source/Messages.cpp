@@ -30,6 +30,24 @@ namespace {
 	vector<pair<string, Messages::Importance>> incoming;
 	vector<Messages::Entry> recent;
 	deque<pair<string, Messages::Importance>> logged;
+
+	// Where this thread's messages are being held back, if anywhere.
+	thread_local Messages::Deferred *deferred = nullptr;
+}
+
+
+
+Messages::Deferred::Deferred(vector<pair<string, Importance>> &messages)
+	: messages(messages), previous(deferred)
+{
+	deferred = this;
+}
+
+
+
+Messages::Deferred::~Deferred()
+{
+	deferred = previous;
 }
 
 
@@ -37,6 +55,12 @@ namespace {
 // Add a message to the list along with its level of importance
 void Messages::Add(const string &message, Importance importance)
 {
+	if(deferred)
+	{
+		deferred->messages.emplace_back(message, importance);
+		return;
+	}
+
 	lock_guard<mutex> lock(incomingMutex);
 	incoming.emplace_back(message, importance);
 	AddLog(message, importance);
@@ -51,6 +51,24 @@ public:
 		Importance importance;
 	};
 
+	// While an object of this class exists, the messages added by the thread
+	// that created it are appended to the given list instead of being shown.
+	// Work that is done in parallel can then add its messages in a fixed order
+	// once it is done.
+	class Deferred {
+	public:
+		explicit Deferred(std::vector<std::pair<std::string, Importance>> &messages);
+		~Deferred();
+		Deferred(const Deferred &) = delete;
+		Deferred &operator=(const Deferred &) = delete;
+
+	private:
+		std::vector<std::pair<std::string, Importance>> &messages;
+		Deferred *previous = nullptr;
+
+		friend class Messages;
+	};
+
 public:
 	// Add a message to the list along with its level of importance
 	static void Add(const std::string &message, Importance importance = Importance::Low);
@@ -18,7 +18,6 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "DataNode.h"
 #include "DataWriter.h"
 #include "Dialog.h"
-#include "DistanceMap.h"
 #include "text/Format.h"
 #include "GameData.h"
 #include "Government.h"
@@ -604,6 +603,22 @@ bool Mission::IsAtLocation(Location location) const
 
 
 
+// If this mission can only be offered on particular planets, fill in the
+// list of them and return true.
+bool Mission::GetSourcePlanets(set<const Planet *> &planets) const
+{
+	if(location == BOARDING || location == ASSISTING)
+		return false;
+	if(source)
+	{
+		planets = {source};
+		return true;
+	}
+	return sourceFilter.GetPlanets(planets);
+}
+
+
+
 // Information about what you are doing.
 const Ship *Mission::SourceShip() const
 {
@@ -1579,17 +1594,16 @@ int Mission::CalculateJumps(const System *sourceSystem)
 	while(!destinations.empty())
 	{
 		// Find the closest destination to this location.
-		DistanceMap distance(sourceSystem,
-				distanceCalcSettings.WormholeStrat(),
-				distanceCalcSettings.AssumesJumpDrive());
 		auto it = destinations.begin();
 		auto bestIt = it;
-		int bestDays = distance.Days(*bestIt);
+		int bestDays = GameData::TravelDays(sourceSystem, *bestIt,
+				distanceCalcSettings.WormholeStrat(), distanceCalcSettings.AssumesJumpDrive());
 		if(bestDays < 0)
 			bestDays = numeric_limits<int>::max();
 		for(++it; it != destinations.end(); ++it)
 		{
-			int days = distance.Days(*it);
+			int days = GameData::TravelDays(sourceSystem, *it,
+					distanceCalcSettings.WormholeStrat(), distanceCalcSettings.AssumesJumpDrive());
 			if(days >= 0 && days < bestDays)
 			{
 				bestIt = it;
@@ -1602,11 +1616,9 @@ int Mission::CalculateJumps(const System *sourceSystem)
 		expectedJumps += bestDays == numeric_limits<int>::max() ? -1 : bestDays;
 		destinations.erase(bestIt);
 	}
-	DistanceMap distance(sourceSystem,
-			distanceCalcSettings.WormholeStrat(),
-			distanceCalcSettings.AssumesJumpDrive());
 	// If currently unreachable, this system adds -1 to the deadline, to match previous behavior.
-	expectedJumps += distance.Days(destination->GetSystem());
+	expectedJumps += GameData::TravelDays(sourceSystem, destination->GetSystem(),
+			distanceCalcSettings.WormholeStrat(), distanceCalcSettings.AssumesJumpDrive());
 
 	return expectedJumps;
 }
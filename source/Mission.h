@@ -88,6 +88,9 @@ public:
 	// Find out where this mission is offered.
 	enum Location {SPACEPORT, LANDING, JOB, ASSISTING, BOARDING, SHIPYARD, OUTFITTER};
 	bool IsAtLocation(Location location) const;
+	// If this mission can only be offered on particular planets, fill in the
+	// list of them and return true.
+	bool GetSourcePlanets(std::set<const Planet *> &planets) const;
 
 	// Information about what you are doing.
 	const Ship *SourceShip() const;
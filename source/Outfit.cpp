@@ -477,6 +477,13 @@ double Outfit::Get(const string &attribute) const
 
 
 
+double Outfit::Get(const Attribute &attribute) const
+{
+	return attributes.Get(attribute);
+}
+
+
+
 const Dictionary &Outfit::Attributes() const
 {
 	return attributes;
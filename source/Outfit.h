@@ -24,6 +24,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include <utility>
 #include <vector>
 
+class Attribute;
 class Body;
 class DataNode;
 class Effect;
@@ -66,6 +67,7 @@ public:
 
 	double Get(const char *attribute) const;
 	double Get(const std::string &attribute) const;
+	double Get(const Attribute &attribute) const;
 	const Dictionary &Attributes() const;
 
 	// Determine whether the given number of instances of the given outfit can
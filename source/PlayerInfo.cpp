@@ -22,6 +22,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "DataWriter.h"
 #include "Dialog.h"
 #include "DistanceMap.h"
+#include "File.h"
 #include "Files.h"
 #include "text/Format.h"
 #include "GameData.h"
@@ -41,18 +42,24 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "Ship.h"
 #include "ShipEvent.h"
 #include "ShipJumpNavigation.h"
+#include "image/Sprite.h"
 #include "StartConditions.h"
 #include "StellarObject.h"
 #include "System.h"
+#include "TaskQueue.h"
 #include "UI.h"
 
 #include <algorithm>
 #include <cassert>
 #include <cmath>
+#include <cstdio>
 #include <ctime>
+#include <exception>
 #include <functional>
 #include <iterator>
 #include <limits>
+#include <mutex>
+#include <queue>
 #include <sstream>
 #include <stdexcept>
 
@@ -124,6 +131,106 @@ namespace {
 			oldFirstShip->SetIsParked(true);
 		}
 	}
+
+	// Let the player know that a saved game could not be written, both in the
+	// error log and in the game itself.
+	void ReportSaveError(const string &message)
+	{
+		Logger::LogError(message);
+		Messages::Add(message, Messages::Importance::Highest);
+	}
+
+	// Saved games are written to disk by background tasks, so that saving never
+	// holds up the game. The tasks are run one at a time, in the order they were
+	// queued, so that backups are always rotated before the file is replaced.
+	class SaveWriter {
+	public:
+		void Run(function<void()> task)
+		{
+			{
+				lock_guard<mutex> lock(pendingMutex);
+				pending.push(std::move(task));
+			}
+			// The queue's threads may start these in any order, so each one runs
+			// whichever pending task is the oldest.
+			queue.Run([this]
+				{
+					lock_guard<mutex> writeLock(writeMutex);
+					function<void()> next;
+					{
+						lock_guard<mutex> lock(pendingMutex);
+						next = std::move(pending.front());
+						pending.pop();
+					}
+					// The task queue only passes on exceptions when its sync
+					// tasks are processed, which this one never does, so report
+					// them here instead.
+					try {
+						next();
+					}
+					catch(const exception &error)
+					{
+						ReportSaveError(string("Error while saving the game: ") + error.what());
+					}
+					catch(...)
+					{
+						ReportSaveError("Unknown error while saving the game.");
+					}
+				});
+		}
+		// Wait for everything that has been queued to be written.
+		void Wait()
+		{
+			queue.Wait();
+		}
+
+	private:
+		TaskQueue queue;
+		mutex writeMutex;
+		mutex pendingMutex;
+		std::queue<function<void()>> pending;
+	};
+
+	// The writer is destroyed before the worker threads are, when the game exits,
+	// and finishes writing anything that is still pending when it is.
+	SaveWriter &Writer()
+	{
+		static SaveWriter writer;
+		return writer;
+	}
+
+	// Encode a saved game in the compact binary encoding, which is smaller and
+	// faster to load than text, but cannot be edited by hand. Encoding it takes
+	// longer than just writing the text, but it is done by the writer's task.
+	string Compact(const string &text)
+	{
+		istringstream in(text);
+		return DataWriter::Compact(DataFile(in));
+	}
+
+	// Write the file under a temporary name and then rename it, so that the file
+	// at the given path is never left partially written.
+	void WriteAtomically(const string &path, const string &data)
+	{
+		const string temporary = path + ".tmp";
+		// The data must be on the disk before the old file is replaced, or a
+		// full disk or a crash could leave only a truncated copy of either.
+		File file(temporary, true);
+		const bool written = file && fwrite(data.data(), 1, data.size(), file) == data.size()
+			&& file.Sync() && file.Close();
+		if(!written)
+		{
+			file.Close();
+			Files::Delete(temporary);
+			ReportSaveError("Unable to save \"" + path + "\".");
+			return;
+		}
+		Files::Move(temporary, path);
+		// If the file could not be replaced, keep the new copy under its
+		// temporary name, so that it is not lost.
+		if(Files::Exists(temporary))
+			ReportSaveError("Unable to replace \"" + path + "\"; it was saved as \"" + temporary + "\" instead.");
+	}
 }
 
 
@@ -200,6 +307,8 @@ void PlayerInfo::New(const StartConditions &start)
 // Load player information from a saved game file.
 void PlayerInfo::Load(const string &path)
 {
+	// Make sure any saved game that is still being written is finished first.
+	FinishSaving();
 	// Make sure any previously loaded data is cleared.
 	Clear();
 
@@ -496,36 +605,64 @@ void PlayerInfo::Save() const
 	if(!CanBeSaved())
 		return;
 
-	// Remember that this was the most recently saved player.
-	Files::Write(Files::Config() + "recent.txt", filePath + '\n');
-
-	if(filePath.rfind(".txt") == filePath.length() - 4)
-	{
-		// Only update the backups if this save will have a newer date.
-		SavedGame saved(filePath);
-		if(saved.GetDate() != date.ToString())
+	// Everything that is to be written is collected now, and written to disk
+	// by a background task.
+	string data = SaveToString();
+	DataWriter globalConditions;
+	GameData::GlobalConditions().Save(globalConditions);
+	Writer().Run([filePath = filePath, data = std::move(data), conditions = globalConditions.SaveToString(),
+			date = date.ToString(), previousCount = Preferences::GetPreviousSaveCount(),
+			saveSpaceport = planet && planet->HasServices(),
+			compact = Preferences::Has("Compact saved games")]() mutable
 		{
-			string root = filePath.substr(0, filePath.length() - 4);
-			const int previousCount = Preferences::GetPreviousSaveCount();
-			const string rootPrevious = root + "~~previous-";
-			for(int i = previousCount - 1; i > 0; --i)
+			if(compact)
+				data = Compact(data);
+
+			// Remember that this was the most recently saved player.
+			Files::Write(Files::Config() + "recent.txt", filePath + '\n');
+
+			if(filePath.rfind(".txt") == filePath.length() - 4)
 			{
-				const string toMove = rootPrevious + to_string(i) + ".txt";
-				if(Files::Exists(toMove))
-					Files::Move(toMove, rootPrevious + to_string(i + 1) + ".txt");
+				// Only update the backups if this save will have a newer date.
+				SavedGame saved(filePath);
+				if(saved.GetDate() != date)
+				{
+					string root = filePath.substr(0, filePath.length() - 4);
+					const string rootPrevious = root + "~~previous-";
+					for(int i = previousCount - 1; i > 0; --i)
+					{
+						const string toMove = rootPrevious + to_string(i) + ".txt";
+						if(Files::Exists(toMove))
+							Files::Move(toMove, rootPrevious + to_string(i + 1) + ".txt");
+					}
+					if(Files::Exists(filePath))
+						Files::Move(filePath, rootPrevious + "1.txt");
+					if(saveSpaceport)
+						WriteAtomically(rootPrevious + "spaceport.txt", data);
+				}
 			}
-			if(Files::Exists(filePath))
-				Files::Move(filePath, rootPrevious + "1.txt");
-			if(planet->HasServices())
-				Save(rootPrevious + "spaceport.txt");
-		}
-	}
 
-	Save(filePath);
+			WriteAtomically(filePath, data);
 
-	// Save global conditions:
-	DataWriter globalConditions(Files::Config() + "global conditions.txt");
-	GameData::GlobalConditions().Save(globalConditions);
+			// Save global conditions:
+			WriteAtomically(Files::Config() + "global conditions.txt", conditions);
+		});
+}
+
+
+
+// Wait until every saved game has been written to disk.
+void PlayerInfo::FinishSaving()
+{
+	Writer().Wait();
+}
+
+
+
+// Never save this player, not even automatically.
+void PlayerInfo::DisableSaving()
+{
+	isSavingDisabled = true;
 }
 
 
@@ -2117,14 +2254,11 @@ Mission *PlayerInfo::BoardingMission(const shared_ptr<Ship> &ship)
 	// "boardingMissions" is emptied by MissionCallback, but to be sure:
 	boardingMissions.clear();
 
-	Mission::Location location = (ship->GetGovernment()->IsEnemy()
-			? Mission::BOARDING : Mission::ASSISTING);
-
 	// Check for available boarding or assisting missions.
-	for(const auto &it : GameData::Missions())
-		if(it.second.IsAtLocation(location) && it.second.CanOffer(*this, ship))
+	for(const Mission *mission : GameData::MissionsOfferedOnShips(ship->GetGovernment()->IsEnemy()))
+		if(mission->CanOffer(*this, ship))
 		{
-			boardingMissions.push_back(it.second.Instantiate(*this, ship));
+			boardingMissions.push_back(mission->Instantiate(*this, ship));
 			if(boardingMissions.back().IsFailed(*this))
 				boardingMissions.pop_back();
 			else
@@ -3819,19 +3953,8 @@ void PlayerInfo::RegisterDerivedConditions()
 	destroyedPersonProvider.SetGetFunction(destroyedPersonFun);
 
 	// Read-only navigation conditions.
-	auto HyperspaceTravelDays = [](const System *origin, const System *destination) -> int
-	{
-		if(!origin)
-			return -1;
-
-		auto distanceMap = DistanceMap(origin);
-		if(!distanceMap.HasRoute(destination))
-			return -1;
-		return distanceMap.Days(destination);
-	};
-
 	auto &&hyperjumpsToSystemProvider = conditions.GetProviderPrefixed("hyperjumps to system: ");
-	auto hyperjumpsToSystemFun = [this, HyperspaceTravelDays](const string &name) -> int
+	auto hyperjumpsToSystemFun = [this](const string &name) -> int
 	{
 		const System *system = GameData::Systems().Find(name.substr(strlen("hyperjumps to system: ")));
 		if(!system)
@@ -3840,12 +3963,12 @@ void PlayerInfo::RegisterDerivedConditions()
 					+ "\" referred to in condition is not valid.");
 			return -1;
 		}
-		return HyperspaceTravelDays(this->GetSystem(), system);
+		return GameData::TravelDays(this->GetSystem(), system);
 	};
 	hyperjumpsToSystemProvider.SetGetFunction(hyperjumpsToSystemFun);
 
 	auto &&hyperjumpsToPlanetProvider = conditions.GetProviderPrefixed("hyperjumps to planet: ");
-	auto hyperjumpsToPlanetFun = [this, HyperspaceTravelDays](const string &name) -> int
+	auto hyperjumpsToPlanetFun = [this](const string &name) -> int
 	{
 		const Planet *planet = GameData::Planets().Find(name.substr(strlen("hyperjumps to planet: ")));
 		if(!planet)
@@ -3861,7 +3984,7 @@ void PlayerInfo::RegisterDerivedConditions()
 					+ "\" referred to in condition is not in any system.");
 			return -1;
 		}
-		return HyperspaceTravelDays(this->GetSystem(), system);
+		return GameData::TravelDays(this->GetSystem(), system);
 	};
 	hyperjumpsToPlanetProvider.SetGetFunction(hyperjumpsToPlanetFun);
 
@@ -3935,22 +4058,20 @@ void PlayerInfo::CreateMissions()
 	// Check for available missions.
 	bool skipJobs = planet && !planet->GetPort().HasService(Port::ServicesType::JobBoard);
 	bool hasPriorityMissions = false;
-	for(const auto &it : GameData::Missions())
+	for(const Mission *mission : GameData::MissionsOfferedAt(planet))
 	{
-		if(it.second.IsAtLocation(Mission::BOARDING) || it.second.IsAtLocation(Mission::ASSISTING))
-			continue;
-		if(skipJobs && it.second.IsAtLocation(Mission::JOB))
+		if(skipJobs && mission->IsAtLocation(Mission::JOB))
 			continue;
 
-		if(it.second.CanOffer(*this))
+		if(mission->CanOffer(*this))
 		{
 			list<Mission> &missions =
-				it.second.IsAtLocation(Mission::JOB) ? availableJobs : availableMissions;
+				mission->IsAtLocation(Mission::JOB) ? availableJobs : availableMissions;
 
-			missions.push_back(it.second.Instantiate(*this));
+			missions.push_back(mission->Instantiate(*this));
 			if(missions.back().IsFailed(*this))
 				missions.pop_back();
-			else if(!it.second.IsAtLocation(Mission::JOB))
+			else if(!mission->IsAtLocation(Mission::JOB))
 				hasPriorityMissions |= missions.back().HasPriority();
 		}
 	}
@@ -4224,20 +4345,53 @@ void PlayerInfo::Autosave() const
 
 
 void PlayerInfo::Save(const string &filePath) const
+{
+	Writer().Run([filePath, data = SaveToString(), compact = Preferences::Has("Compact saved games")]
+		{
+			WriteAtomically(filePath, compact ? Compact(data) : data);
+		});
+}
+
+
+
+// Get the contents of the saved game, as of the start of the current
+// transaction if there is one.
+string PlayerInfo::SaveToString() const
 {
 	if(transactionSnapshot)
-		transactionSnapshot->SaveToPath(filePath);
-	else
-	{
-		DataWriter out(filePath);
-		Save(out);
-	}
+		return transactionSnapshot->SaveToString();
+
+	DataWriter out;
+	Save(out);
+	return out.SaveToString();
 }
 
 
 
 void PlayerInfo::Save(DataWriter &out) const
 {
+	// A summary of what the load panel shows for this pilot. It comes first, so
+	// that the panel only needs to read the start of the file.
+	out.Write("summary");
+	out.BeginChild();
+	{
+		out.Write("pilot", firstName, lastName);
+		out.Write("date", date.Day(), date.Month(), date.Year());
+		if(system)
+			out.Write("system", system->Name());
+		if(planet)
+			out.Write("planet", planet->TrueName());
+		out.Write("playtime", playTime);
+		out.Write("credits", accounts.Credits());
+		if(flagship)
+		{
+			out.Write("ship", flagship->Name());
+			if(flagship->GetSprite())
+				out.Write("ship sprite", flagship->GetSprite()->Name());
+		}
+	}
+	out.EndChild();
+
 	// Basic player information and persistent UI settings:
 
 	// Pilot information:
@@ -4690,5 +4844,5 @@ void PlayerInfo::ForgetGiftedShip(const Ship &oldShip, bool failsMissions)
 // Check that this player's current state can be saved.
 bool PlayerInfo::CanBeSaved() const
 {
-	return (!isDead && planet && system && !firstName.empty() && !lastName.empty());
+	return (!isDead && !isSavingDisabled && planet && system && !firstName.empty() && !lastName.empty());
 }
@@ -84,8 +84,17 @@ public:
 	void Load(const std::string &path);
 	// Load the most recently saved player. If no save could be loaded, returns false.
 	bool LoadRecent();
-	// Save this player (using the Identifier() as the file name).
+	// Save this player (using the Identifier() as the file name). The files are
+	// written in the background, and never left partially written.
 	void Save() const;
+	// Wait until every saved game has been written to disk.
+	static void FinishSaving();
+	// Never save this player, not even automatically. This is for running a
+	// pilot without a window, which must not change their saved games.
+	void DisableSaving();
+	// Get the contents of the saved game, as of the start of the current
+	// transaction if there is one.
+	std::string SaveToString() const;
 
 	// Get the root filename used for this player's saved game files. (If there
 	// are multiple pilots with the same name it may have a digit appended.)
@@ -386,6 +395,7 @@ private:
 	const Planet *planet = nullptr;
 	bool shouldLaunch = false;
 	bool isDead = false;
+	bool isSavingDisabled = false;
 	bool displayCarrierHelp = false;
 
 	// The amount of in-game time played, in seconds.
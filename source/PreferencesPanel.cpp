@@ -642,11 +642,13 @@ void PreferencesPanel::DrawSettings()
 		"Show CPU / GPU load",
 		"Render motion blur",
 		"Reduce large graphics",
+		"Compress graphics",
 		"Draw background haze",
 		"Draw starfield",
 		BACKGROUND_PARALLAX,
 		"Show hyperspace flash",
 		EXTENDED_JUMP_EFFECTS,
+		"Parallel ship movement",
 		SHIP_OUTLINES,
 		HUD_SHIP_OUTLINES,
 		CLOAK_OUTLINE,
@@ -693,8 +695,10 @@ void PreferencesPanel::DrawSettings()
 		REACTIVATE_HELP,
 		"Interrupt fast-forward",
 		"Landing zoom",
+		"Compact saved games",
 		SCROLL_SPEED,
-		DATE_FORMAT
+		DATE_FORMAT,
+		"Show step profiler"
 	};
 
 	bool isCategory = true;
@@ -0,0 +1,225 @@
+/* Profiler.cpp
+Copyright (c) 2026 by the Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "Profiler.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <utility>
+
+using namespace std;
+
+namespace {
+	const char *ZONE_NAMES[] = {
+		"AI",
+		"ship movement",
+		"asteroids",
+		"projectiles",
+		"weather",
+		"collision sets",
+		"collisions",
+		"radar",
+		"draw lists"
+	};
+	static_assert(size(ZONE_NAMES) == static_cast<size_t>(Profiler::Zone::COUNT));
+
+	double Seconds(chrono::steady_clock::duration duration)
+	{
+		return chrono::duration_cast<chrono::duration<double>>(duration).count();
+	}
+
+	// Format a duration as a number of microseconds, which is the unit that
+	// trace files use for all times.
+	string Microseconds(chrono::steady_clock::duration duration)
+	{
+		int64_t nanoseconds = chrono::duration_cast<chrono::nanoseconds>(duration).count();
+		string fraction = to_string(nanoseconds % 1000);
+		return to_string(nanoseconds / 1000) + "." + string(3 - fraction.size(), '0') + fraction;
+	}
+
+	// Add a "complete" event, which has a start time and a duration, to a trace.
+	void AddEvent(string &out, const char *name, chrono::steady_clock::duration start,
+		chrono::steady_clock::duration duration)
+	{
+		if(out.back() != '[')
+			out += ",";
+		out += "\n{\"name\":\"";
+		out += name;
+		out += "\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":" + Microseconds(start)
+			+ ",\"dur\":" + Microseconds(duration) + "}";
+	}
+}
+
+
+
+Profiler::Scope::Scope(Profiler &profiler, Zone zone)
+	: profiler(profiler), zone(zone), start(chrono::steady_clock::now())
+{
+}
+
+
+
+Profiler::Scope::~Scope()
+{
+	profiler.Add(zone, start, chrono::steady_clock::now());
+}
+
+
+
+Profiler::Profiler()
+	: origin(chrono::steady_clock::now())
+{
+	history.reserve(HISTORY_SIZE);
+}
+
+
+
+const char *Profiler::Name(Zone zone)
+{
+	return ZONE_NAMES[static_cast<int>(zone)];
+}
+
+
+
+void Profiler::BeginStep()
+{
+	current.start = chrono::steady_clock::now();
+}
+
+
+
+void Profiler::EndStep()
+{
+	current.end = chrono::steady_clock::now();
+	stepTime += Seconds(current.end - current.start);
+	++steps;
+
+	// Once the history is full, reuse the oldest step's record, so that its
+	// list of events does not need to be allocated again.
+	if(history.size() < HISTORY_SIZE)
+	{
+		history.push_back(std::move(current));
+		current = Record();
+	}
+	else
+	{
+		swap(history[next], current);
+		next = (next + 1) % HISTORY_SIZE;
+	}
+	current.zoneTime.fill(0.);
+	current.events.clear();
+}
+
+
+
+int Profiler::Steps() const
+{
+	return steps;
+}
+
+
+
+double Profiler::Time(Zone zone) const
+{
+	return zoneTime[static_cast<int>(zone)];
+}
+
+
+
+double Profiler::Time() const
+{
+	return stepTime;
+}
+
+
+
+Profiler::Stats Profiler::Recent(Zone zone) const
+{
+	vector<double> times;
+	times.reserve(history.size());
+	for(const Record &record : history)
+		times.push_back(record.zoneTime[static_cast<int>(zone)]);
+	return Summarize(times);
+}
+
+
+
+Profiler::Stats Profiler::Recent() const
+{
+	vector<double> times;
+	times.reserve(history.size());
+	for(const Record &record : history)
+		times.push_back(Seconds(record.end - record.start));
+	return Summarize(times);
+}
+
+
+
+string Profiler::Trace() const
+{
+	string out = "{\"traceEvents\":[";
+	// Write the steps from oldest to newest.
+	for(size_t i = 0; i < history.size(); ++i)
+	{
+		const Record &record = history[(next + i) % history.size()];
+		AddEvent(out, "step", record.start - origin, record.end - record.start);
+		for(const Event &event : record.events)
+			AddEvent(out, Name(event.zone), event.start - origin, event.end - event.start);
+	}
+	out += "\n],\"displayTimeUnit\":\"ms\"}\n";
+	return out;
+}
+
+
+
+void Profiler::Reset()
+{
+	zoneTime.fill(0.);
+	stepTime = 0.;
+	steps = 0;
+	history.clear();
+	next = 0;
+}
+
+
+
+void Profiler::Add(Zone zone, chrono::steady_clock::time_point start, chrono::steady_clock::time_point end)
+{
+	double time = Seconds(end - start);
+	zoneTime[static_cast<int>(zone)] += time;
+	current.zoneTime[static_cast<int>(zone)] += time;
+	current.events.push_back({zone, start, end});
+}
+
+
+
+Profiler::Stats Profiler::Summarize(vector<double> &times)
+{
+	Stats stats;
+	if(times.empty())
+		return stats;
+
+	sort(times.begin(), times.end());
+	auto Percentile = [&times](double fraction) -> double
+	{
+		return times[min(times.size() - 1, static_cast<size_t>(fraction * times.size()))];
+	};
+	stats.average = accumulate(times.begin(), times.end(), 0.) / times.size();
+	stats.median = Percentile(.5);
+	stats.p95 = Percentile(.95);
+	stats.p99 = Percentile(.99);
+	return stats;
+}
@@ -0,0 +1,143 @@
+/* Profiler.h
+Copyright (c) 2026 by the Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+
+
+// Class for measuring how long each phase of the engine's calculation step takes.
+// The engine marks the start and end of each step, and wraps each phase of it in
+// a Scope object. The time spent in each phase is added up over all steps until
+// the profiler is reset, and the most recent steps are also kept in a rolling
+// history, so that their statistics can be shown or saved as a trace.
+class Profiler {
+public:
+	// The phases of a step that are timed separately. Anything not in any zone
+	// is only counted in the total time of the step.
+	enum class Zone : int {
+		AI,
+		SHIPS,
+		ASTEROIDS,
+		PROJECTILES,
+		WEATHER,
+		COLLISION_SETS,
+		COLLISIONS,
+		RADAR,
+		DRAW,
+		COUNT
+	};
+
+	// Statistics of the time, in seconds, that the recent steps took.
+	class Stats {
+	public:
+		double average = 0.;
+		double median = 0.;
+		double p95 = 0.;
+		double p99 = 0.;
+	};
+
+	// Time a single phase of the current step, from when this object is
+	// created until it is destroyed.
+	class Scope {
+	public:
+		Scope(Profiler &profiler, Zone zone);
+		~Scope();
+
+		Scope(const Scope &) = delete;
+		Scope &operator=(const Scope &) = delete;
+
+	private:
+		Profiler &profiler;
+		Zone zone;
+		std::chrono::steady_clock::time_point start;
+	};
+
+	// The number of steps kept in the history: ten seconds of game time.
+	static constexpr std::size_t HISTORY_SIZE = 600;
+
+
+public:
+	Profiler();
+
+	// Get the name of the given zone, for display.
+	static const char *Name(Zone zone);
+
+	// Mark the beginning and the end of one step.
+	void BeginStep();
+	void EndStep();
+
+	// Get the number of steps that have been completed.
+	int Steps() const;
+	// Get the total time, in seconds, spent in the given zone, or in all the
+	// completed steps, since the profiler was last reset.
+	double Time(Zone zone) const;
+	double Time() const;
+
+	// Get statistics of the time each step in the history spent in the given
+	// zone, or of the time each step took.
+	Stats Recent(Zone zone) const;
+	Stats Recent() const;
+	// Get the steps in the history as a Chrome trace event file, which can be
+	// viewed with chrome://tracing or Perfetto.
+	std::string Trace() const;
+
+	// Discard all the times that have been recorded.
+	void Reset();
+
+
+private:
+	// A single phase of a step, as it appears in the trace.
+	class Event {
+	public:
+		Zone zone;
+		std::chrono::steady_clock::time_point start;
+		std::chrono::steady_clock::time_point end;
+	};
+
+	// Everything that was recorded about a single step.
+	class Record {
+	public:
+		std::chrono::steady_clock::time_point start;
+		std::chrono::steady_clock::time_point end;
+		std::array<double, static_cast<int>(Zone::COUNT)> zoneTime = {};
+		std::vector<Event> events;
+	};
+
+
+private:
+	void Add(Zone zone, std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end);
+	// Calculate the statistics of the given times, sorting them in the process.
+	static Stats Summarize(std::vector<double> &times);
+
+
+private:
+	// Trace timestamps are measured from when the profiler was created.
+	std::chrono::steady_clock::time_point origin;
+	std::array<double, static_cast<int>(Zone::COUNT)> zoneTime = {};
+	double stepTime = 0.;
+	int steps = 0;
+
+	// The step currently being recorded, and a ring buffer of the most recent
+	// completed steps, in which "next" is the oldest step once it is full.
+	Record current;
+	std::vector<Record> history;
+	std::size_t next = 0;
+};
@@ -17,47 +17,33 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include <random>
 
-#ifndef __linux__
-#include <mutex>
-#endif
-
 using namespace std;
 
-// Right now thread_local storage is only supported under Linux.
+// Each thread has its own generator, so that no locking is needed and so that
+// seeding it from one thread does not change the numbers another thread gets.
 namespace {
-#ifndef __linux__
-	mutex workaroundMutex;
-	mt19937_64 gen;
-	uniform_int_distribution<uint32_t> uniform;
-	uniform_real_distribution<double> real;
-	normal_distribution<double> normal;
-#else
 	thread_local mt19937_64 gen;
 	thread_local uniform_int_distribution<uint32_t> uniform;
 	thread_local uniform_real_distribution<double> real;
 	thread_local normal_distribution<double> normal;
-#endif
 }
 
 
 
-// Seed the generator (e.g. to make it produce exactly the same random
-// numbers it produced previously).
+// Seed this thread's generator (e.g. to make it produce exactly the same
+// random numbers it produced previously).
 void Random::Seed(uint64_t seed)
 {
-#ifndef __linux__
-	lock_guard<mutex> lock(workaroundMutex);
-#endif
 	gen.seed(seed);
+	// The normal distribution generates numbers in pairs, and must not hand out
+	// one that was left over from before the generator was seeded.
+	normal.reset();
 }
 
 
 
 uint32_t Random::Int()
 {
-#ifndef __linux__
-	lock_guard<mutex> lock(workaroundMutex);
-#endif
 	return uniform(gen);
 }
 
@@ -65,9 +51,6 @@ uint32_t Random::Int()
 
 uint32_t Random::Int(uint32_t upper_bound)
 {
-#ifndef __linux__
-	lock_guard<mutex> lock(workaroundMutex);
-#endif
 	const uint32_t x = uniform(gen);
 	return (static_cast<uint64_t>(x) * static_cast<uint64_t>(upper_bound)) >> 32;
 }
@@ -76,9 +59,6 @@ uint32_t Random::Int(uint32_t upper_bound)
 
 double Random::Real()
 {
-#ifndef __linux__
-	lock_guard<mutex> lock(workaroundMutex);
-#endif
 	return real(gen);
 }
 
@@ -89,9 +69,6 @@ double Random::Real()
 uint32_t Random::Polya(uint32_t k, double p)
 {
 	negative_binomial_distribution<uint32_t> polya(k, p);
-#ifndef __linux__
-	lock_guard<mutex> lock(workaroundMutex);
-#endif
 	return polya(gen);
 }
 
@@ -101,9 +78,6 @@ uint32_t Random::Polya(uint32_t k, double p)
 uint32_t Random::Binomial(uint32_t t, double p)
 {
 	binomial_distribution<uint32_t> binomial(t, p);
-#ifndef __linux__
-	lock_guard<mutex> lock(workaroundMutex);
-#endif
 	return binomial(gen);
 }
 
@@ -112,8 +86,5 @@ uint32_t Random::Binomial(uint32_t t, double p)
 // Get a normally distributed number with standard or specified mean and stddev.
 double Random::Normal(double mean, double sigma)
 {
-#ifndef __linux__
-	lock_guard<mutex> lock(workaroundMutex);
-#endif
 	return sigma * normal(gen) + mean;
 }
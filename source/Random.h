@@ -20,12 +20,11 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 
 // Collection of functions for generating random numbers with a variety of
-// different distributions. (This is done partly because on some systems the
-// random number generation is not thread-safe.)
+// different distributions. Each thread has its own generator.
 class Random {
 public:
-	// Seed the generator (e.g. to make it produce exactly the same random
-	// numbers it produced previously).
+	// Seed this thread's generator (e.g. to make it produce exactly the same
+	// random numbers it produced previously).
 	static void Seed(uint64_t seed);
 
 	static uint32_t Int();
@@ -0,0 +1,315 @@
+/* Recording.cpp
+Copyright (c) 2026 by the Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "Recording.h"
+
+#include "ConditionsStore.h"
+#include "DataWriter.h"
+#include "Files.h"
+#include "GameData.h"
+#include "Logger.h"
+#include "PlayerInfo.h"
+#include "Random.h"
+
+#include <cstring>
+#include <memory>
+
+using namespace std;
+
+namespace {
+	string recordPath;
+	unique_ptr<Recording> current;
+
+	// Every recording starts with this, so that files written by a different
+	// version of the format, or on a machine with a different byte order, are
+	// never played back.
+	const uint32_t MAGIC = 0x43525345;
+	const uint32_t VERSION = 1;
+
+	// Flags stored with each run of identical inputs.
+	const uint8_t HAS_KEYS = 1;
+	const uint8_t HAS_MOUSE = 2;
+
+	template <class Type>
+	void Append(string &out, const Type &value)
+	{
+		out.append(reinterpret_cast<const char *>(&value), sizeof(value));
+	}
+
+	void AppendString(string &out, const string &value)
+	{
+		Append(out, static_cast<uint64_t>(value.size()));
+		out += value;
+	}
+
+	// Helper for reading a recording, keeping track of the offset into it.
+	class Reader {
+	public:
+		explicit Reader(const string &data) : data(data) {}
+
+		template <class Type>
+		bool Read(Type &value)
+		{
+			if(data.size() - offset < sizeof(value))
+				return false;
+			memcpy(&value, data.data() + offset, sizeof(value));
+			offset += sizeof(value);
+			return true;
+		}
+		bool ReadString(string &value)
+		{
+			uint64_t size = 0;
+			if(!Read(size) || data.size() - offset < size)
+				return false;
+			value.assign(data, offset, size);
+			offset += size;
+			return true;
+		}
+		// Get how many bytes have not been read yet.
+		size_t Remaining() const
+		{
+			return data.size() - offset;
+		}
+
+	private:
+		const string &data;
+		size_t offset = 0;
+	};
+}
+
+
+
+// Set the file that flights are recorded to. If it is empty, which is the
+// default, no flights are recorded.
+void Recording::SetPath(const string &newPath)
+{
+	recordPath = newPath;
+}
+
+
+
+// Begin recording a flight from the planet the player is landed on. This
+// must be called right before the player takes off.
+void Recording::Begin(const PlayerInfo &player, bool distributeCargo)
+{
+	End();
+	if(recordPath.empty())
+		return;
+
+	current = make_unique<Recording>();
+	current->seed = (static_cast<uint64_t>(Random::Int()) << 32) | Random::Int();
+	current->distributeCargo = distributeCargo;
+	current->savedGame = player.SaveToString();
+	DataWriter conditions;
+	GameData::GlobalConditions().Save(conditions);
+	current->globalConditions = conditions.SaveToString();
+}
+
+
+
+// Get the flight that is being recorded, if any.
+Recording *Recording::Current()
+{
+	return current.get();
+}
+
+
+
+// Stop recording, and write the recorded flight to the file.
+void Recording::End()
+{
+	if(!current)
+		return;
+
+	if(current->Steps())
+		current->Save(recordPath);
+	current.reset();
+}
+
+
+
+// Read a recording from the given file. If it cannot be read, this returns
+// false and the recording is left empty.
+bool Recording::Load(const string &path)
+{
+	*this = Recording();
+	const string data = Files::Read(path);
+	Reader in(data);
+
+	uint32_t magic = 0;
+	uint32_t version = 0;
+	uint8_t distribute = 0;
+	uint64_t steps = 0;
+	bool valid = in.Read(magic) && magic == MAGIC && in.Read(version) && version == VERSION
+		&& in.Read(seed) && in.Read(distribute) && in.Read(firstStep)
+		&& in.ReadString(savedGame) && in.ReadString(globalConditions) && in.Read(steps);
+	distributeCargo = distribute;
+	// Every step has a hash, so a file that claims more steps than it has room
+	// for hashes is corrupt, and its step count cannot be trusted.
+	valid = valid && steps <= in.Remaining() / sizeof(uint32_t);
+
+	// The inputs are stored as runs of identical inputs.
+	while(valid && inputs.size() < steps)
+	{
+		uint32_t count = 0;
+		uint8_t flags = 0;
+		Input input;
+		valid = in.Read(count) && count && count <= steps - inputs.size() && in.Read(flags);
+		input.hasKeys = (flags & HAS_KEYS);
+		if(valid && input.hasKeys)
+			valid = in.Read(input.keys.state) && in.Read(input.keys.turn);
+		valid = valid && in.Read(input.command.state) && in.Read(input.command.turn);
+		if(valid && (flags & HAS_MOUSE))
+			valid = in.Read(input.mouse.X()) && in.Read(input.mouse.Y());
+		if(valid)
+			inputs.insert(inputs.end(), count, input);
+	}
+	hashes.resize(inputs.size());
+	for(uint32_t &hash : hashes)
+		valid = valid && in.Read(hash);
+
+	if(!valid)
+	{
+		Logger::LogError("Unable to read the recording \"" + path + "\".");
+		*this = Recording();
+	}
+	return valid;
+}
+
+
+
+void Recording::Save(const string &path) const
+{
+	string out;
+	Append(out, MAGIC);
+	Append(out, VERSION);
+	Append(out, seed);
+	Append(out, static_cast<uint8_t>(distributeCargo));
+	Append(out, firstStep);
+	AppendString(out, savedGame);
+	AppendString(out, globalConditions);
+	Append(out, static_cast<uint64_t>(inputs.size()));
+
+	auto IsSame = [](const Input &a, const Input &b) -> bool
+	{
+		return a.hasKeys == b.hasKeys && a.keys.state == b.keys.state && a.keys.turn == b.keys.turn
+			&& a.command.state == b.command.state && a.command.turn == b.command.turn
+			&& a.mouse.X() == b.mouse.X() && a.mouse.Y() == b.mouse.Y();
+	};
+	for(size_t i = 0; i < inputs.size(); )
+	{
+		const Input &input = inputs[i];
+		uint32_t count = 1;
+		while(i + count < inputs.size() && count < UINT32_MAX && IsSame(input, inputs[i + count]))
+			++count;
+		i += count;
+
+		const bool hasMouse = input.mouse.X() || input.mouse.Y();
+		Append(out, count);
+		Append(out, static_cast<uint8_t>((input.hasKeys ? HAS_KEYS : 0) | (hasMouse ? HAS_MOUSE : 0)));
+		if(input.hasKeys)
+		{
+			Append(out, input.keys.state);
+			Append(out, input.keys.turn);
+		}
+		Append(out, input.command.state);
+		Append(out, input.command.turn);
+		if(hasMouse)
+		{
+			Append(out, input.mouse.X());
+			Append(out, input.mouse.Y());
+		}
+	}
+	for(uint32_t hash : hashes)
+		Append(out, hash);
+
+	Files::Write(path, out);
+}
+
+
+
+uint64_t Recording::Seed() const
+{
+	return seed;
+}
+
+
+
+bool Recording::DistributeCargo() const
+{
+	return distributeCargo;
+}
+
+
+
+// The engine's step counter when the flight began, which some animations
+// and collision masks depend on.
+int Recording::FirstStep() const
+{
+	return firstStep;
+}
+
+
+
+void Recording::SetFirstStep(int step)
+{
+	firstStep = step;
+}
+
+
+
+// The saved game and the global conditions that the flight started from.
+const string &Recording::SavedGame() const
+{
+	return savedGame;
+}
+
+
+
+const string &Recording::GlobalConditions() const
+{
+	return globalConditions;
+}
+
+
+
+// Get the number of steps in this recording.
+size_t Recording::Steps() const
+{
+	return inputs.size();
+}
+
+
+
+// Add the input of the next step, and the hash of the state after it.
+void Recording::Add(const Input &input, uint32_t hash)
+{
+	inputs.push_back(input);
+	hashes.push_back(hash);
+}
+
+
+
+const Recording::Input &Recording::GetInput(size_t step) const
+{
+	return inputs[step];
+}
+
+
+
+uint32_t Recording::Hash(size_t step) const
+{
+	return hashes[step];
+}
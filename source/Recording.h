@@ -0,0 +1,99 @@
+/* Recording.h
+Copyright (c) 2026 by the Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "Command.h"
+#include "Point.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class PlayerInfo;
+
+
+
+// A recording of one flight, from taking off until the next landing. It holds
+// everything needed to play the flight back exactly: the saved game it started
+// from, the seed of the random number generator, and the player's input in
+// each step. It also holds a hash of the state of the game after each step, so
+// that a replay can tell whether, and in which step, it went differently than
+// the original flight did. Recordings are written in a compact binary format,
+// in which runs of steps with the same input are only stored once.
+class Recording {
+public:
+	// The player's input in a single step.
+	class Input {
+	public:
+		// Whether the AI was given the player's keys before this step, and
+		// which keys they were.
+		bool hasKeys = false;
+		Command keys;
+		// The commands given to the player's flagship in this step.
+		Command command;
+		// Where the mouse was, if the flagship was turning toward it.
+		Point mouse;
+	};
+
+
+public:
+	// Set the file that flights are recorded to. If it is empty, which is the
+	// default, no flights are recorded.
+	static void SetPath(const std::string &path);
+	// Begin recording a flight from the planet the player is landed on. This
+	// must be called right before the player takes off.
+	static void Begin(const PlayerInfo &player, bool distributeCargo);
+	// Get the flight that is being recorded, if any.
+	static Recording *Current();
+	// Stop recording, and write the recorded flight to the file.
+	static void End();
+
+
+public:
+	// Read a recording from the given file. If it cannot be read, this returns
+	// false and the recording is left empty.
+	bool Load(const std::string &path);
+	void Save(const std::string &path) const;
+
+	uint64_t Seed() const;
+	bool DistributeCargo() const;
+	// The engine's step counter when the flight began, which some animations
+	// and collision masks depend on.
+	int FirstStep() const;
+	void SetFirstStep(int step);
+	// The saved game and the global conditions that the flight started from.
+	const std::string &SavedGame() const;
+	const std::string &GlobalConditions() const;
+
+	// Get the number of steps in this recording.
+	size_t Steps() const;
+	// Add the input of the next step, and the hash of the state after it.
+	void Add(const Input &input, uint32_t hash);
+	const Input &GetInput(size_t step) const;
+	uint32_t Hash(size_t step) const;
+
+
+private:
+	uint64_t seed = 0;
+	bool distributeCargo = false;
+	int32_t firstStep = 0;
+	std::string savedGame;
+	std::string globalConditions;
+
+	std::vector<Input> inputs;
+	std::vector<uint32_t> hashes;
+};
@@ -18,11 +18,58 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "DataFile.h"
 #include "DataNode.h"
 #include "Date.h"
+#include "File.h"
 #include "text/Format.h"
 #include "image/SpriteSet.h"
 
+#include <cstdio>
+
 using namespace std;
 
+namespace {
+	// Saved games start with a summary of what the load panel shows. Stop reading
+	// the summary if it is longer than this, because something must be wrong.
+	const size_t MAX_SUMMARY_SIZE = 1 << 16;
+
+	// Read just the summary block at the start of the given saved game. This is
+	// empty if the file does not start with one, e.g. because it was saved by an
+	// older version of the game. A saved game in the compact encoding cannot be
+	// split into lines, so as much of it as the summary may take up is read.
+	string ReadSummary(const string &path)
+	{
+		File file(path);
+		if(!file)
+			return "";
+
+		static const string HEADER = "summary\n";
+		string text;
+		char block[4096];
+		while(text.size() < MAX_SUMMARY_SIZE)
+		{
+			size_t count = fread(block, 1, sizeof(block), file);
+			size_t searchFrom = text.empty() ? 0 : text.size() - 1;
+			text.append(block, count);
+			if(DataFile::IsCompact(text))
+			{
+				if(count < sizeof(block))
+					return text;
+				continue;
+			}
+			if(text.compare(0, HEADER.size(), HEADER, 0, min(HEADER.size(), text.size())))
+				return "";
+
+			// The summary ends at the first line after it that is not indented.
+			size_t pos = max(searchFrom, HEADER.size() - 1);
+			while((pos = text.find('\n', pos)) != string::npos && ++pos < text.size())
+				if(text[pos] != '\t')
+					return text.substr(0, pos);
+			if(count < sizeof(block))
+				return text.size() > HEADER.size() ? text : "";
+		}
+		return DataFile::IsCompact(text) ? text : "";
+	}
+}
+
 
 
 SavedGame::SavedGame(const string &path)
@@ -35,6 +82,9 @@ SavedGame::SavedGame(const string &path)
 void SavedGame::Load(const string &path)
 {
 	Clear();
+	if(LoadSummary(path))
+		return;
+
 	DataFile file(path);
 	if(file.begin() != file.end())
 		this->path = path;
@@ -165,3 +215,41 @@ const string &SavedGame::ShipName() const
 {
 	return shipName;
 }
+
+
+
+// Load the information from the summary at the start of the file, without
+// reading the rest of it. Returns false if the file has no summary.
+bool SavedGame::LoadSummary(const string &path)
+{
+	DataFile file;
+	file.LoadFirstNode(ReadSummary(path));
+	for(const DataNode &summary : file)
+	{
+		if(summary.Token(0) != "summary")
+			return false;
+
+		this->path = path;
+		for(const DataNode &node : summary)
+		{
+			if(node.Token(0) == "pilot" && node.Size() >= 3)
+				name = node.Token(1) + " " + node.Token(2);
+			else if(node.Token(0) == "date" && node.Size() >= 4)
+				date = Date(node.Value(1), node.Value(2), node.Value(3)).ToString();
+			else if(node.Token(0) == "system" && node.Size() >= 2)
+				system = node.Token(1);
+			else if(node.Token(0) == "planet" && node.Size() >= 2)
+				planet = node.Token(1);
+			else if(node.Token(0) == "playtime" && node.Size() >= 2)
+				playTime = Format::PlayTime(node.Value(1));
+			else if(node.Token(0) == "credits" && node.Size() >= 2)
+				credits = Format::Credits(node.Value(1));
+			else if(node.Token(0) == "ship" && node.Size() >= 2)
+				shipName = node.Token(1);
+			else if(node.Token(0) == "ship sprite" && node.Size() >= 2)
+				shipSprite = SpriteSet::Get(node.Token(1));
+		}
+		return true;
+	}
+	return false;
+}
@@ -25,7 +25,9 @@ class Sprite;
 // information necessary from the file to display it in the "Load Game" panel,
 // without doing all the complicated parsing that PlayerInfo does. This is so
 // that we only need to have one PlayerInfo instance, and there does not need
-// to be logic for copying one PlayerInfo into another.
+// to be logic for copying one PlayerInfo into another. Saved games start with a
+// summary of that information, so usually only the first few lines of the file
+// need to be read; older saved games are parsed in full.
 class SavedGame {
 public:
 	SavedGame() = default;
@@ -48,6 +50,10 @@ public:
 	const std::string &ShipName() const;
 
 
+private:
+	bool LoadSummary(const std::string &path);
+
+
 private:
 	std::string path;
 
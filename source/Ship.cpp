@@ -15,6 +15,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include "Ship.h"
 
+#include "Attribute.h"
 #include "audio/Audio.h"
 #include "CategoryList.h"
 #include "CategoryTypes.h"
@@ -721,7 +722,7 @@ void Ship::FinishLoading(bool isNewInstance)
 
 	// Mark any drone that has no "automaton" value as an automaton, to
 	// grandfather in the drones from before that attribute existed.
-	if(baseAttributes.Category() == "Drone" && !baseAttributes.Get("automaton"))
+	if(baseAttributes.Category() == "Drone" && !baseAttributes.Get(Attribute("automaton")))
 		baseAttributes.Set("automaton", 1.);
 
 	baseAttributes.Set("gun ports", armament.GunCount());
@@ -795,7 +796,7 @@ void Ship::FinishLoading(bool isNewInstance)
 	{
 		const Outfit *outfit = hardpoint.GetOutfit();
 		if(outfit && outfit->IsDefined()
-				&& (hardpoint.IsTurret() != (outfit->Get("turret mounts") != 0.)))
+				&& (hardpoint.IsTurret() != (outfit->Get(Attribute("turret mounts")) != 0.)))
 		{
 			string warning = (!isYours && !variantName.empty()) ? "variant \"" + variantName + "\"" : trueModelName;
 			if(!name.empty())
@@ -807,7 +808,7 @@ void Ship::FinishLoading(bool isNewInstance)
 			Logger::LogError(warning);
 		}
 	}
-	cargo.SetSize(attributes.Get("cargo space"));
+	cargo.SetSize(attributes.Get(Attribute("cargo space")));
 	armament.FinishLoading();
 
 	// Figure out how far from center the farthest hardpoint is.
@@ -853,11 +854,13 @@ void Ship::FinishLoading(bool isNewInstance)
 		if(val < 0)
 			warning += attr + ": " + Format::Number(val) + "\n";
 	}
-	if(attributes.Get("drag") <= 0.)
+	if(attributes.Get(Attribute("drag")) <= 0.)
 	{
-		warning += "Defaulting " + string(attributes.Get("drag") ? "invalid" : "missing") + " \"drag\" attribute to 100.0\n";
+		warning += "Defaulting " + string(attributes.Get(Attribute("drag")) ? "invalid" : "missing")
+			+ " \"drag\" attribute to 100.0\n";
 		attributes.Set("drag", 100.);
 	}
+	UpdateDerivedStats();
 
 	// Calculate the values used to determine this ship's value and danger.
 	attraction = CalculateAttraction();
@@ -1274,20 +1277,20 @@ vector<string> Ship::FlightCheck() const
 {
 	auto checks = vector<string>{};
 
-	double generation = attributes.Get("energy generation") - attributes.Get("energy consumption");
-	double consuming = attributes.Get("fuel energy");
-	double solar = attributes.Get("solar collection");
-	double battery = attributes.Get("energy capacity");
+	double generation = attributes.Get(Attribute("energy generation")) - attributes.Get(Attribute("energy consumption"));
+	double consuming = attributes.Get(Attribute("fuel energy"));
+	double solar = attributes.Get(Attribute("solar collection"));
+	double battery = attributes.Get(Attribute("energy capacity"));
 	double energy = generation + consuming + solar + battery;
-	double fuelChange = attributes.Get("fuel generation") - attributes.Get("fuel consumption");
-	double fuelCapacity = attributes.Get("fuel capacity");
+	double fuelChange = attributes.Get(Attribute("fuel generation")) - attributes.Get(Attribute("fuel consumption"));
+	double fuelCapacity = attributes.Get(Attribute("fuel capacity"));
 	double fuel = fuelCapacity + fuelChange;
-	double thrust = attributes.Get("thrust");
-	double reverseThrust = attributes.Get("reverse thrust");
-	double afterburner = attributes.Get("afterburner thrust");
-	double thrustEnergy = attributes.Get("thrusting energy");
-	double turn = attributes.Get("turn");
-	double turnEnergy = attributes.Get("turning energy");
+	double thrust = attributes.Get(Attribute("thrust"));
+	double reverseThrust = attributes.Get(Attribute("reverse thrust"));
+	double afterburner = attributes.Get(Attribute("afterburner thrust"));
+	double thrustEnergy = attributes.Get(Attribute("thrusting energy"));
+	double turn = attributes.Get(Attribute("turn"));
+	double turnEnergy = attributes.Get(Attribute("turning energy"));
 	double hyperDrive = navigation.HasHyperdrive();
 	double jumpDrive = navigation.HasJumpDrive();
 
@@ -1306,7 +1309,7 @@ vector<string> Ship::FlightCheck() const
 	// If no errors were found, check all warning conditions:
 	if(checks.empty())
 	{
-		if(RequiredCrew() > attributes.Get("bunks"))
+		if(RequiredCrew() > attributes.Get(Attribute("bunks")))
 			checks.emplace_back("insufficient bunks?");
 		if(!thrust && !reverseThrust)
 			checks.emplace_back("afterburner only?");
@@ -1623,40 +1626,50 @@ const FireCommand &Ship::FiringCommands() const noexcept
 // it is in the process of blowing up. If this returns false, the ship
 // should be deleted.
 void Ship::Move(vector<Visual> &visuals, list<shared_ptr<Flotsam>> &flotsam)
+{
+	if(MoveSelf(visuals, flotsam))
+		FinishMove(visuals);
+}
+
+
+
+// The first half of Move(), which only affects this ship and its carried ships.
+// Returns true if FinishMove() should be called to complete the move.
+bool Ship::MoveSelf(vector<Visual> &visuals, list<shared_ptr<Flotsam>> &flotsam)
 {
 	// Do nothing with ships that are being forgotten.
 	if(StepFlags())
-		return;
+		return false;
 
 	// We're done if the ship was destroyed.
 	const int destroyResult = StepDestroyed(visuals, flotsam);
 	if(destroyResult > 0)
-		return;
+		return false;
 
-	const bool isBeingDestroyed = destroyResult;
+	isMoveBeingDestroyed = destroyResult;
 
 	// Generate energy, heat, etc. if we're not being destroyed.
-	if(!isBeingDestroyed)
+	if(!isMoveBeingDestroyed)
 		DoGeneration();
 
 	DoPassiveEffects(visuals, flotsam);
 	DoJettison(flotsam);
 	DoCloakDecision();
 
-	bool isUsingAfterburner = false;
+	isMoveUsingAfterburner = false;
 
 	// Don't let the ship do anything else if it is being destroyed.
-	if(!isBeingDestroyed)
+	if(!isMoveBeingDestroyed)
 	{
 		// See if the ship is entering hyperspace.
 		// If it is, nothing more needs to be done here.
 		if(DoHyperspaceLogic(visuals))
-			return;
+			return false;
 
 		// Check if we're trying to land.
 		// If we landed, we're done.
 		if(DoLandingLogic())
-			return;
+			return false;
 
 		// Move the turrets.
 		if(!isDisabled)
@@ -1664,16 +1677,25 @@ void Ship::Move(vector<Visual> &visuals, list<shared_ptr<Flotsam>> &flotsam)
 
 		DoInitializeMovement();
 		StepPilot();
-		DoMovement(isUsingAfterburner);
-		StepTargeting();
+		DoMovement(isMoveUsingAfterburner);
 	}
+	return true;
+}
+
+
+
+// The second half of Move(), which may interact with the ship being boarded.
+void Ship::FinishMove(vector<Visual> &visuals)
+{
+	if(!isMoveBeingDestroyed)
+		StepTargeting();
 
 	// Move the ship.
 	position += velocity;
 
 	// Show afterburner flares unless the ship is being destroyed.
-	if(!isBeingDestroyed)
-		DoEngineVisuals(visuals, isUsingAfterburner);
+	if(!isMoveBeingDestroyed)
+		DoEngineVisuals(visuals, isMoveUsingAfterburner);
 
 	// Start fading the damage overlay.
 	if(damageOverlayTimer)
@@ -1690,12 +1712,13 @@ void Ship::Launch(list<shared_ptr<Ship>> &ships, vector<Visual> &visuals)
 	// eject any ships still docked, possibly destroying them in the process.
 	bool ejecting = IsDestroyed();
 	if(!ejecting && (!commands.Has(Command::DEPLOY) || zoom != 1.f || hyperspaceCount ||
-			(cloak && !attributes.Get("cloaked deployment"))))
+			(cloak && !attributes.Get(Attribute("cloaked deployment")))))
 		return;
 
 	for(Bay &bay : bays)
 		if(bay.ship
-			&& ((bay.ship->Commands().Has(Command::DEPLOY) && !Random::Int(40 + 20 * !bay.ship->attributes.Get("automaton")))
+			&& ((bay.ship->Commands().Has(Command::DEPLOY)
+					&& !Random::Int(40 + 20 * !bay.ship->attributes.Get(Attribute("automaton"))))
 			|| (ejecting && !Random::Int(6))))
 		{
 			// Resupply any ships launching of their own accord.
@@ -1721,7 +1744,7 @@ void Ship::Launch(list<shared_ptr<Ship>> &ships, vector<Visual> &visuals)
 
 				// This ship will refuel naturally based on the carrier's fuel
 				// collection, but the carrier may have some reserves to spare.
-				double maxFuel = bay.ship->attributes.Get("fuel capacity");
+				double maxFuel = bay.ship->attributes.Get(Attribute("fuel capacity"));
 				if(maxFuel)
 				{
 					double spareFuel = fuel - navigation.JumpFuel();
@@ -1798,10 +1821,11 @@ shared_ptr<Ship> Ship::Board(bool autoPlunder, bool nonDocking)
 			TransferFuel(victim->JumpFuelMissing(), victim.get());
 		}
 		// Transfer some energy, if needed.
-		if(victim->Attributes().Get("energy capacity") > 0 && victim->energy < 200.)
+		if(victim->Attributes().Get(Attribute("energy capacity")) > 0 && victim->energy < 200.)
 		{
 			helped = true;
-			double toGive = max(attributes.Get("energy capacity") * 0.1, victim->Attributes().Get("energy capacity") * 0.2);
+			double toGive = max(attributes.Get(Attribute("energy capacity")) * 0.1,
+				victim->Attributes().Get(Attribute("energy capacity")) * 0.2);
 			TransferEnergy(max(200., toGive), victim.get());
 		}
 		if(helped)
@@ -1848,18 +1872,18 @@ int Ship::Scan(const PlayerInfo &player)
 
 	// The range of a scanner is proportional to the square root of its power.
 	// Because of Pythagoras, if we use square-distance, we can skip this square root.
-	double cargoDistanceSquared = attributes.Get("cargo scan power");
-	double outfitDistanceSquared = attributes.Get("outfit scan power");
+	double cargoDistanceSquared = attributes.Get(Attribute("cargo scan power"));
+	double outfitDistanceSquared = attributes.Get(Attribute("outfit scan power"));
 
 	// Bail out if this ship has no scanners.
 	if(!cargoDistanceSquared && !outfitDistanceSquared)
 		return 0;
 
-	double cargoSpeed = attributes.Get("cargo scan efficiency");
+	double cargoSpeed = attributes.Get(Attribute("cargo scan efficiency"));
 	if(!cargoSpeed)
 		cargoSpeed = cargoDistanceSquared;
 
-	double outfitSpeed = attributes.Get("outfit scan efficiency");
+	double outfitSpeed = attributes.Get(Attribute("outfit scan efficiency"));
 	if(!outfitSpeed)
 		outfitSpeed = outfitDistanceSquared;
 
@@ -1875,8 +1899,10 @@ int Ship::Scan(const PlayerInfo &player)
 	// of 0.
 	// If instantly scanning very small ships is desirable, this can be removed.
 	// One point of scan opacity is the equivalent of an additional ton of cargo / outfit space
-	const double outfitsSize = target->baseAttributes.Get("outfit space") + target->attributes.Get("outfit scan opacity");
-	const double cargoSize = target->attributes.Get("cargo space") + target->attributes.Get("cargo scan opacity");
+	const double outfitsSize = target->baseAttributes.Get(Attribute("outfit space"))
+		+ target->attributes.Get(Attribute("outfit scan opacity"));
+	const double cargoSize = target->attributes.Get(Attribute("cargo space"))
+		+ target->attributes.Get(Attribute("cargo scan opacity"));
 	double outfits = max(SCAN_MIN_OUTFIT_SPACE, outfitsSize) * SCAN_OUTFIT_FACTOR;
 	double cargo = max(SCAN_MIN_CARGO_SPACE, cargoSize) * SCAN_CARGO_FACTOR;
 
@@ -1984,7 +2010,7 @@ int Ship::Scan(const PlayerInfo &player)
 		if(result & ShipEvent::SCAN_OUTFITS)
 			Messages::Add("The " + government->GetName() + " " + Noun() + " \""
 					+ Name() + "\" completed its outfit scan of your ship \"" + target->Name()
-					+ (target->Attributes().Get("inscrutable") > 0. ? "\" with no useful results." : "\"."),
+					+ (target->Attributes().Get(Attribute("inscrutable")) > 0. ? "\" with no useful results." : "\"."),
 					Messages::Importance::High);
 	}
 
@@ -2052,7 +2078,7 @@ void Ship::Fire(vector<Projectile> &projectiles, vector<Visual> &visuals)
 				armament.Fire(i, *this, projectiles, visuals, Random::Real() < jamChance);
 				if(cloak)
 				{
-					double cloakingFiring = attributes.Get("cloaked firing");
+					double cloakingFiring = attributes.Get(Attribute("cloaked firing"));
 					// Any negative value means shooting does not decloak.
 					if(cloakingFiring > 0)
 						cloak -= cloakingFiring;
@@ -2262,22 +2288,22 @@ bool Ship::CannotAct(ActionType actionType) const
 		switch(actionType)
 		{
 			case ActionType::AFTERBURNER:
-				canActCloaked = attributes.Get("cloaked afterburner");
+				canActCloaked = attributes.Get(Attribute("cloaked afterburner"));
 				break;
 			case ActionType::BOARD:
-				canActCloaked = attributes.Get("cloaked boarding");
+				canActCloaked = attributes.Get(Attribute("cloaked boarding"));
 				break;
 			case ActionType::COMMUNICATION:
-				canActCloaked = attributes.Get("cloaked communication");
+				canActCloaked = attributes.Get(Attribute("cloaked communication"));
 				break;
 			case ActionType::FIRE:
-				canActCloaked = attributes.Get("cloaked firing");
+				canActCloaked = attributes.Get(Attribute("cloaked firing"));
 				break;
 			case ActionType::PICKUP:
-				canActCloaked = attributes.Get("cloaked pickup");
+				canActCloaked = attributes.Get(Attribute("cloaked pickup"));
 				break;
 			case ActionType::SCAN:
-				canActCloaked = attributes.Get("cloaked scanning");
+				canActCloaked = attributes.Get(Attribute("cloaked scanning"));
 				break;
 		}
 	return (cloak == 1. && !canActCloaked) || (cloak != 1. && cloak && !cloakDisruption && !canActCloaked);
@@ -2371,7 +2397,7 @@ bool Ship::IsReadyToJump(bool waitingIsReady) const
 
 	Point direction = targetSystem->Position() - currentSystem->Position();
 	bool isJump = (jumpUsed.first == JumpType::JUMP_DRIVE);
-	double scramThreshold = attributes.Get("scram drive");
+	double scramThreshold = attributes.Get(Attribute("scram drive"));
 
 	// If the system has a departure distance the ship is only allowed to leave the system
 	// if it is beyond this distance.
@@ -2390,7 +2416,7 @@ bool Ship::IsReadyToJump(bool waitingIsReady) const
 		if(deviation > scramThreshold)
 			return false;
 	}
-	else if(velocity.Length() > attributes.Get("jump speed"))
+	else if(velocity.Length() > attributes.Get(Attribute("jump speed")))
 		return false;
 
 	if(!isJump)
@@ -2530,18 +2556,18 @@ void Ship::Recharge(int rechargeType, bool hireCrew)
 		return;
 
 	if(hireCrew)
-		crew = min<int>(max(crew, RequiredCrew()), attributes.Get("bunks"));
+		crew = min<int>(max(crew, RequiredCrew()), attributes.Get(Attribute("bunks")));
 	pilotError = 0;
 	pilotOkay = 0;
 
-	if((rechargeType & Port::RechargeType::Shields) || attributes.Get("shield generation"))
+	if((rechargeType & Port::RechargeType::Shields) || attributes.Get(Attribute("shield generation")))
 		shields = MaxShields();
-	if((rechargeType & Port::RechargeType::Hull) || attributes.Get("hull repair rate"))
+	if((rechargeType & Port::RechargeType::Hull) || attributes.Get(Attribute("hull repair rate")))
 		hull = MaxHull();
-	if((rechargeType & Port::RechargeType::Energy) || attributes.Get("energy generation"))
-		energy = attributes.Get("energy capacity");
-	if((rechargeType & Port::RechargeType::Fuel) || attributes.Get("fuel generation"))
-		fuel = attributes.Get("fuel capacity");
+	if((rechargeType & Port::RechargeType::Energy) || attributes.Get(Attribute("energy generation")))
+		energy = attributes.Get(Attribute("energy capacity"));
+	if((rechargeType & Port::RechargeType::Fuel) || attributes.Get(Attribute("fuel generation")))
+		fuel = attributes.Get(Attribute("fuel capacity"));
 
 	heat = IdleHeat();
 	ionization = 0.;
@@ -2568,7 +2594,8 @@ bool Ship::CanRefuel(const Ship &other) const
 
 bool Ship::CanGiveEnergy(const Ship &other) const
 {
-	double toGive = min(other.attributes.Get("energy capacity"), max(200., other.attributes.Get("energy capacity") * 0.2));
+	double toGive = min(other.attributes.Get(Attribute("energy capacity")),
+		max(200., other.attributes.Get(Attribute("energy capacity")) * 0.2));
 	return energy >= 2 * toGive;
 }
 
@@ -2576,10 +2603,10 @@ bool Ship::CanGiveEnergy(const Ship &other) const
 
 double Ship::TransferFuel(double amount, Ship *to)
 {
-	amount = max(fuel - attributes.Get("fuel capacity"), amount);
+	amount = max(fuel - attributes.Get(Attribute("fuel capacity")), amount);
 	if(to)
 	{
-		amount = min(to->attributes.Get("fuel capacity") - to->fuel, amount);
+		amount = min(to->attributes.Get(Attribute("fuel capacity")) - to->fuel, amount);
 		to->fuel += amount;
 	}
 	fuel -= amount;
@@ -2590,10 +2617,10 @@ double Ship::TransferFuel(double amount, Ship *to)
 
 double Ship::TransferEnergy(double amount, Ship *to)
 {
-	amount = max(energy - attributes.Get("energy capacity"), amount);
+	amount = max(energy - attributes.Get(Attribute("energy capacity")), amount);
 	if(to)
 	{
-		amount = min(to->attributes.Get("energy capacity") - to->energy, amount);
+		amount = min(to->attributes.Get(Attribute("energy capacity")) - to->energy, amount);
 		to->energy += amount;
 	}
 	energy -= amount;
@@ -2692,7 +2719,7 @@ double Ship::Hull() const
 
 double Ship::Fuel() const
 {
-	double maximum = attributes.Get("fuel capacity");
+	double maximum = attributes.Get(Attribute("fuel capacity"));
 	return maximum ? min(1., fuel / maximum) : 0.;
 }
 
@@ -2700,7 +2727,7 @@ double Ship::Fuel() const
 
 double Ship::Energy() const
 {
-	double maximum = attributes.Get("energy capacity");
+	double maximum = attributes.Get(Attribute("energy capacity"));
 	return maximum ? min(1., energy / maximum) : (hull > 0.) ? 1. : 0.;
 }
 
@@ -2747,13 +2774,13 @@ double Ship::DisabledHull() const
 // Get the maximum shield and hull values of the ship, accounting for multipliers.
 double Ship::MaxShields() const
 {
-	return attributes.Get("shields") * (1 + attributes.Get("shield multiplier"));
+	return attributes.Get(Attribute("shields")) * (1 + attributes.Get(Attribute("shield multiplier")));
 }
 
 
 double Ship::MaxHull() const
 {
-	return attributes.Get("hull") * (1 + attributes.Get("hull multiplier"));
+	return attributes.Get(Attribute("hull")) * (1 + attributes.Get(Attribute("hull multiplier")));
 }
 
 
@@ -2835,15 +2862,15 @@ bool Ship::NeedsFuel(bool followParent) const
 	}
 	if(!jumpFuel)
 		jumpFuel = navigation.JumpFuel(targetSystem);
-	return (fuel < jumpFuel) && (attributes.Get("fuel capacity") >= jumpFuel);
+	return (fuel < jumpFuel) && (attributes.Get(Attribute("fuel capacity")) >= jumpFuel);
 }
 
 
 
 bool Ship::NeedsEnergy() const
 {
-	return attributes.Get("energy capacity") && !energy && !attributes.Get("energy generation")
-			&& !attributes.Get("fuel energy") && !attributes.Get("solar collection");
+	return attributes.Get(Attribute("energy capacity")) && !energy && !attributes.Get(Attribute("energy generation"))
+			&& !attributes.Get(Attribute("fuel energy")) && !attributes.Get(Attribute("solar collection"));
 }
 
 
@@ -2853,7 +2880,7 @@ double Ship::JumpFuelMissing() const
 	// Used for smart refueling: transfer only as much as really needed
 	// includes checking if fuel cap is high enough at all
 	double jumpFuel = navigation.JumpFuel(targetSystem);
-	if(!jumpFuel || fuel > jumpFuel || jumpFuel > attributes.Get("fuel capacity"))
+	if(!jumpFuel || fuel > jumpFuel || jumpFuel > attributes.Get(Attribute("fuel capacity")))
 		return 0.;
 
 	return jumpFuel - fuel;
@@ -2866,14 +2893,14 @@ double Ship::IdleHeat() const
 {
 	// This ship's cooling ability:
 	double coolingEfficiency = CoolingEfficiency();
-	double cooling = coolingEfficiency * attributes.Get("cooling");
-	double activeCooling = coolingEfficiency * attributes.Get("active cooling");
+	double cooling = coolingEfficiency * attributes.Get(Attribute("cooling"));
+	double activeCooling = coolingEfficiency * attributes.Get(Attribute("active cooling"));
 
 	// Idle heat is the heat level where:
 	// heat = heat - heat * diss + heatGen - cool - activeCool * heat / maxHeat
 	// heat = heat - heat * (diss + activeCool / maxHeat) + (heatGen - cool)
 	// heat * (diss + activeCool / maxHeat) = (heatGen - cool)
-	double production = max(0., attributes.Get("heat generation") - cooling);
+	double production = max(0., attributes.Get(Attribute("heat generation")) - cooling);
 	double dissipation = HeatDissipation() + activeCooling / MaximumHeat();
 	if(!dissipation) return production ? numeric_limits<double>::max() : 0;
 	return production / dissipation;
@@ -2884,7 +2911,7 @@ double Ship::IdleHeat() const
 // Get the heat dissipation, in heat units per heat unit per frame.
 double Ship::HeatDissipation() const
 {
-	return .001 * attributes.Get("heat dissipation");
+	return .001 * attributes.Get(Attribute("heat dissipation"));
 }
 
 
@@ -2892,7 +2919,7 @@ double Ship::HeatDissipation() const
 // Get the maximum heat level, in heat units (not temperature).
 double Ship::MaximumHeat() const
 {
-	return MAXIMUM_TEMPERATURE * (cargo.Used() + attributes.Mass() + attributes.Get("heat capacity"));
+	return MAXIMUM_TEMPERATURE * (cargo.Used() + attributes.Mass() + attributes.Get(Attribute("heat capacity")));
 }
 
 
@@ -2906,7 +2933,7 @@ bool Ship::IsCloaked() const
 
 double Ship::CloakingSpeed() const
 {
-	return attributes.Get("cloak") + attributes.Get("cloak by mass") * 1000. / Mass();
+	return attributes.Get(Attribute("cloak")) + attributes.Get(Attribute("cloak by mass")) * 1000. / Mass();
 }
 
 
@@ -2914,18 +2941,18 @@ double Ship::CloakingSpeed() const
 bool Ship::Phases(Projectile &projectile) const
 {
 	// No Phasing if we are not cloaked, or not having cloak phasing.
-	if(!IsCloaked() || attributes.Get("cloak phasing") == 0)
+	if(!IsCloaked() || attributes.Get(Attribute("cloak phasing")) == 0)
 		return false;
 
 	// Check for full phasing first, to avoid more expensive lookups.
-	if(attributes.Get("cloak phasing") >= 1 || projectile.Phases(*this))
+	if(attributes.Get(Attribute("cloak phasing")) >= 1 || projectile.Phases(*this))
 		return true;
 
 	// Perform the most expensive checks last.
 	// If multiple ships with partial phasing are stacked on top of each other, then the chance of collision increases
 	// significantly, because each ship in the firing-line resets the SetPhase of the previous one. But such stacks
 	// are rare, so we are not going to do anything special for this.
-	if(attributes.Get("cloak phasing") >= Random::Real())
+	if(attributes.Get(Attribute("cloak phasing")) >= Random::Real())
 	{
 		projectile.SetPhases(this);
 		return true;
@@ -2942,7 +2969,7 @@ double Ship::CoolingEfficiency() const
 	// This is an S-curve where the efficiency is 100% if you have no outfits
 	// that create "cooling inefficiency", and as that value increases the
 	// efficiency stays high for a while, then drops off, then approaches 0.
-	double x = attributes.Get("cooling inefficiency");
+	double x = attributes.Get(Attribute("cooling inefficiency"));
 	return 2. + 2. / (1. + exp(x / -2.)) - 4. / (1. + exp(x / -4.));
 }
 
@@ -2958,9 +2985,8 @@ int Ship::Crew() const
 // Calculate the drag on this ship. The drag can be no greater than the mass.
 double Ship::Drag() const
 {
-	double drag = attributes.Get("drag") / (1. + attributes.Get("drag reduction"));
 	double mass = InertialMass();
-	return drag >= mass ? mass : drag;
+	return derived.drag >= mass ? mass : derived.drag;
 }
 
 
@@ -2969,28 +2995,27 @@ double Ship::Drag() const
 // divided by the mass, up to a value of 1.
 double Ship::DragForce() const
 {
-	double drag = attributes.Get("drag") / (1. + attributes.Get("drag reduction"));
 	double mass = InertialMass();
-	return drag >= mass ? 1. : drag / mass;
+	return derived.drag >= mass ? 1. : derived.drag / mass;
 }
 
 
 
 int Ship::RequiredCrew() const
 {
-	if(attributes.Get("automaton"))
+	if(attributes.Get(Attribute("automaton")))
 		return 0;
 
 	// Drones do not need crew, but all other ships need at least one.
-	return max<int>(1, attributes.Get("required crew"));
+	return max<int>(1, attributes.Get(Attribute("required crew")));
 }
 
 
 
 int Ship::CrewValue() const
 {
-	int crewEquivalent = attributes.Get("crew equivalent");
-	if(attributes.Get("use crew equivalent as crew"))
+	int crewEquivalent = attributes.Get(Attribute("crew equivalent"));
+	if(attributes.Get(Attribute("use crew equivalent as crew")))
 		return crewEquivalent;
 	return max(Crew(), RequiredCrew()) + crewEquivalent;
 }
@@ -2999,7 +3024,7 @@ int Ship::CrewValue() const
 
 void Ship::AddCrew(int count)
 {
-	crew = min<int>(crew + count, attributes.Get("bunks"));
+	crew = min<int>(crew + count, attributes.Get(Attribute("bunks")));
 }
 
 
@@ -3022,24 +3047,22 @@ double Ship::Mass() const
 // Account for inertia reduction, which affects movement but has no effect on the ship's heat capacity.
 double Ship::InertialMass() const
 {
-	return Mass() / (1. + attributes.Get("inertia reduction"));
+	return Mass() / derived.inertiaFactor;
 }
 
 
 
 double Ship::TurnRate() const
 {
-	return attributes.Get("turn") / InertialMass()
-		* (1. + attributes.Get("turn multiplier"));
+	return derived.turn / InertialMass() * derived.turnFactor;
 }
 
 
 
 double Ship::Acceleration() const
 {
-	double thrust = attributes.Get("thrust");
-	return (thrust ? thrust : attributes.Get("afterburner thrust")) / InertialMass()
-		* (1. + attributes.Get("acceleration multiplier"));
+	return (derived.thrust ? derived.thrust : derived.afterburnerThrust) / InertialMass()
+		* derived.accelerationFactor;
 }
 
 
@@ -3049,8 +3072,8 @@ double Ship::MaxVelocity(bool withAfterburner) const
 	// v * drag / mass == thrust / mass
 	// v * drag == thrust
 	// v = thrust / drag
-	double thrust = attributes.Get("thrust");
-	double afterburnerThrust = attributes.Get("afterburner thrust");
+	double thrust = derived.thrust;
+	double afterburnerThrust = derived.afterburnerThrust;
 	return (thrust ? thrust + afterburnerThrust * withAfterburner : afterburnerThrust) / Drag();
 }
 
@@ -3058,15 +3081,14 @@ double Ship::MaxVelocity(bool withAfterburner) const
 
 double Ship::ReverseAcceleration() const
 {
-	return attributes.Get("reverse thrust") / InertialMass()
-		* (1. + attributes.Get("acceleration multiplier"));
+	return derived.reverseThrust / InertialMass() * derived.accelerationFactor;
 }
 
 
 
 double Ship::MaxReverseVelocity() const
 {
-	return attributes.Get("reverse thrust") / Drag();
+	return derived.reverseThrust / Drag();
 }
 
 
@@ -3085,13 +3107,13 @@ int Ship::TakeDamage(vector<Visual> &visuals, const DamageDealt &damage, const G
 	shields -= damage.Shield();
 	if(damage.Shield() && !isDisabled)
 	{
-		int disabledDelay = attributes.Get("depleted shield delay");
+		int disabledDelay = attributes.Get(Attribute("depleted shield delay"));
 		shieldDelay = max<int>(shieldDelay, (shields <= 0. && disabledDelay)
-			? disabledDelay : attributes.Get("shield delay"));
+			? disabledDelay : attributes.Get(Attribute("shield delay")));
 	}
 	hull -= damage.Hull();
 	if(damage.Hull() && !isDisabled)
-		hullDelay = max(hullDelay, static_cast<int>(attributes.Get("repair delay")));
+		hullDelay = max(hullDelay, static_cast<int>(attributes.Get(Attribute("repair delay"))));
 
 	energy -= damage.Energy();
 	heat += damage.Heat();
@@ -3128,7 +3150,7 @@ int Ship::TakeDamage(vector<Visual> &visuals, const DamageDealt &damage, const G
 	if(!wasDisabled && isDisabled)
 	{
 		type |= ShipEvent::DISABLE;
-		hullDelay = max(hullDelay, static_cast<int>(attributes.Get("disabled repair delay")));
+		hullDelay = max(hullDelay, static_cast<int>(attributes.Get(Attribute("disabled repair delay"))));
 	}
 	if(!wasDestroyed && IsDestroyed())
 	{
@@ -3473,6 +3495,7 @@ void Ship::AddOutfit(const Outfit *outfit, int count)
 		}
 		int after = outfits.count(outfit);
 		attributes.Add(*outfit, count);
+		UpdateDerivedStats();
 		if(outfit->IsWeapon())
 		{
 			armament.Add(outfit, count);
@@ -3481,19 +3504,19 @@ void Ship::AddOutfit(const Outfit *outfit, int count)
 				deterrence = CalculateDeterrence();
 		}
 
-		if(outfit->Get("cargo space"))
+		if(outfit->Get(Attribute("cargo space")))
 		{
-			cargo.SetSize(attributes.Get("cargo space"));
+			cargo.SetSize(attributes.Get(Attribute("cargo space")));
 			// Only the player's ships make use of attraction and deterrence.
 			if(isYours)
 				attraction = CalculateAttraction();
 		}
-		if(outfit->Get("hull"))
-			hull += outfit->Get("hull") * count;
+		if(outfit->Get(Attribute("hull")))
+			hull += outfit->Get(Attribute("hull")) * count;
 		// If the added or removed outfit is a hyperdrive or jump drive, recalculate this
 		// ship's jump navigation. Hyperdrives and jump drives of the same type don't stack,
 		// so only do this if the outfit is either completely new or has been completely removed.
-		if((outfit->Get("hyperdrive") || outfit->Get("jump drive")) && (!before || !after))
+		if((outfit->Get(Attribute("hyperdrive")) || outfit->Get(Attribute("jump drive"))) && (!before || !after))
 			navigation.Calibrate(*this);
 		// Navigation may still need to be recalibrated depending on the drives a ship has.
 		// Only do this for player ships as to display correct information on the map.
@@ -3534,9 +3557,9 @@ bool Ship::CanFire(const Weapon *weapon) const
 			return false;
 	}
 
-	if(energy < weapon->FiringEnergy() + weapon->RelativeFiringEnergy() * attributes.Get("energy capacity"))
+	if(energy < weapon->FiringEnergy() + weapon->RelativeFiringEnergy() * attributes.Get(Attribute("energy capacity")))
 		return false;
-	if(fuel < weapon->FiringFuel() + weapon->RelativeFiringFuel() * attributes.Get("fuel capacity"))
+	if(fuel < weapon->FiringFuel() + weapon->RelativeFiringFuel() * attributes.Get(Attribute("fuel capacity")))
 		return false;
 	// We do check hull, but we don't check shields. Ships can survive with all shields depleted.
 	// Ships should not disable themselves, so we check if we stay above minimumHull.
@@ -3568,8 +3591,8 @@ void Ship::ExpendAmmo(const Weapon &weapon)
 {
 	// Compute this ship's initial capacities, in case the consumption of the ammunition outfit(s)
 	// modifies them, so that relative costs are calculated based on the pre-firing state of the ship.
-	const double relativeEnergyChange = weapon.RelativeFiringEnergy() * attributes.Get("energy capacity");
-	const double relativeFuelChange = weapon.RelativeFiringFuel() * attributes.Get("fuel capacity");
+	const double relativeEnergyChange = weapon.RelativeFiringEnergy() * attributes.Get(Attribute("energy capacity"));
+	const double relativeFuelChange = weapon.RelativeFiringFuel() * attributes.Get(Attribute("fuel capacity"));
 	const double relativeHeatChange = !weapon.RelativeFiringHeat() ? 0. : weapon.RelativeFiringHeat() * MaximumHeat();
 	const double relativeHullChange = weapon.RelativeFiringHull() * MaxHull();
 	const double relativeShieldChange = weapon.RelativeFiringShields() * MaxShields();
@@ -3851,7 +3874,7 @@ int Ship::StepDestroyed(vector<Visual> &visuals, list<shared_ptr<Flotsam>> &flot
 			// Ammunition has a default 5% chance to survive as flotsam.
 			for(const auto &it : outfits)
 			{
-				double flotsamChance = it.first->Get("flotsam chance");
+				double flotsamChance = it.first->Get(Attribute("flotsam chance"));
 				if(flotsamChance > 0.)
 					Jettison(it.first, Random::Binomial(it.second, flotsamChance));
 				// 0 valued 'flotsamChance' means default, which is 5% for ammunition.
@@ -3920,6 +3943,10 @@ int Ship::StepDestroyed(vector<Visual> &visuals, list<shared_ptr<Flotsam>> &flot
 // Generate energy, heat, etc. (This is called by Move().)
 void Ship::DoGeneration()
 {
+	// In debug builds, catch any change to this ship's attributes that did not
+	// also update the stats that are derived from them.
+	assert(derived.Matches(DerivedStats(attributes)) && "derived stats must be updated with the attributes");
+
 	// First, allow any carried ships to do their own generation.
 	for(const Bay &bay : bays)
 		if(bay.ship)
@@ -3936,34 +3963,20 @@ void Ship::DoGeneration()
 		// 4. Shields of carried fighters
 		// 5. Transfer of excess energy and fuel to carried fighters.
 
-		const double hullAvailable = (attributes.Get("hull repair rate")
-			+ (hullDelay ? 0 : attributes.Get("delayed hull repair rate")))
-			* (1. + attributes.Get("hull repair multiplier"));
-		const double hullEnergy = (attributes.Get("hull energy")
-			+ (hullDelay ? 0 : attributes.Get("delayed hull energy")))
-			* (1. + attributes.Get("hull energy multiplier")) / hullAvailable;
-		const double hullFuel = (attributes.Get("hull fuel")
-			+ (hullDelay ? 0 : attributes.Get("delayed hull fuel")))
-			* (1. + attributes.Get("hull fuel multiplier")) / hullAvailable;
-		const double hullHeat = (attributes.Get("hull heat")
-			+ (hullDelay ? 0 : attributes.Get("delayed hull heat")))
-			* (1. + attributes.Get("hull heat multiplier")) / hullAvailable;
+		const DerivedStats::Repair &hullRepair = derived.hullRepair[hullDelay ? 1 : 0];
+		const double hullAvailable = hullRepair.available;
+		const double hullEnergy = hullRepair.energy;
+		const double hullFuel = hullRepair.fuel;
+		const double hullHeat = hullRepair.heat;
 		double hullRemaining = hullAvailable;
 		DoRepair(hull, hullRemaining, MaxHull(),
 			energy, hullEnergy, fuel, hullFuel, heat, hullHeat);
 
-		const double shieldsAvailable = (attributes.Get("shield generation")
-			+ (shieldDelay ? 0 : attributes.Get("delayed shield generation")))
-			* (1. + attributes.Get("shield generation multiplier"));
-		const double shieldsEnergy = (attributes.Get("shield energy")
-			+ (shieldDelay ? 0 : attributes.Get("delayed shield energy")))
-			* (1. + attributes.Get("shield energy multiplier")) / shieldsAvailable;
-		const double shieldsFuel = (attributes.Get("shield fuel")
-			+ (shieldDelay ? 0 : attributes.Get("delayed shield fuel")))
-			* (1. + attributes.Get("shield fuel multiplier")) / shieldsAvailable;
-		const double shieldsHeat = (attributes.Get("shield heat")
-			+ (shieldDelay ? 0 : attributes.Get("delayed shield heat")))
-			* (1. + attributes.Get("shield heat multiplier")) / shieldsAvailable;
+		const DerivedStats::Repair &shieldRepair = derived.shieldRepair[shieldDelay ? 1 : 0];
+		const double shieldsAvailable = shieldRepair.available;
+		const double shieldsEnergy = shieldRepair.energy;
+		const double shieldsFuel = shieldRepair.fuel;
+		const double shieldsHeat = shieldRepair.heat;
 		double shieldsRemaining = shieldsAvailable;
 		DoRepair(shields, shieldsRemaining, MaxShields(),
 			energy, shieldsEnergy, fuel, shieldsFuel, heat, shieldsHeat);
@@ -3999,15 +4012,15 @@ void Ship::DoGeneration()
 
 			// Now that there is no more need to use energy for hull and shield
 			// repair, if there is still excess energy, transfer it.
-			double energyRemaining = energy - attributes.Get("energy capacity");
-			double fuelRemaining = fuel - attributes.Get("fuel capacity");
+			double energyRemaining = energy - attributes.Get(Attribute("energy capacity"));
+			double fuelRemaining = fuel - attributes.Get(Attribute("fuel capacity"));
 			for(const pair<double, Ship *> &it : carried)
 			{
 				Ship &ship = *it.second;
 				if(energyRemaining > 0.)
-					DoRepair(ship.energy, energyRemaining, ship.attributes.Get("energy capacity"));
+					DoRepair(ship.energy, energyRemaining, ship.attributes.Get(Attribute("energy capacity")));
 				if(fuelRemaining > 0.)
-					DoRepair(ship.fuel, fuelRemaining, ship.attributes.Get("fuel capacity"));
+					DoRepair(ship.fuel, fuelRemaining, ship.attributes.Get(Attribute("fuel capacity")));
 			}
 
 			// Carried ships can recharge energy from their parent's batteries,
@@ -4016,7 +4029,7 @@ void Ship::DoGeneration()
 			{
 				Ship &ship = *it.second;
 				if(ship.HasDeployOrder())
-					DoRepair(ship.energy, energy, ship.attributes.Get("energy capacity"));
+					DoRepair(ship.energy, energy, ship.attributes.Get(Attribute("energy capacity")));
 			}
 		}
 		// Decrease the shield and hull delays by 1 now that shield generation
@@ -4025,28 +4038,28 @@ void Ship::DoGeneration()
 		hullDelay = max(0, hullDelay - 1);
 	}
 	// Let the ship repair itself when disabled if it has the appropriate attribute.
-	if(isDisabled && attributes.Get("disabled recovery time"))
+	if(isDisabled && attributes.Get(Attribute("disabled recovery time")))
 	{
 		disabledRecoveryCounter += 1;
-		double disabledRepairEnergy = attributes.Get("disabled recovery energy");
-		double disabledRepairFuel = attributes.Get("disabled recovery fuel");
+		double disabledRepairEnergy = attributes.Get(Attribute("disabled recovery energy"));
+		double disabledRepairFuel = attributes.Get(Attribute("disabled recovery fuel"));
 
 		// Repair only if the counter has reached the limit and if the ship can meet the energy and fuel costs.
-		if(disabledRecoveryCounter >= attributes.Get("disabled recovery time")
+		if(disabledRecoveryCounter >= attributes.Get(Attribute("disabled recovery time"))
 			&& energy >= disabledRepairEnergy && fuel >= disabledRepairFuel)
 		{
 			energy -= disabledRepairEnergy;
 			fuel -= disabledRepairFuel;
 
-			heat += attributes.Get("disabled recovery heat");
-			ionization += attributes.Get("disabled recovery ionization");
-			scrambling += attributes.Get("disabled recovery scrambling");
-			disruption += attributes.Get("disabled recovery disruption");
-			slowness += attributes.Get("disabled recovery slowing");
-			discharge += attributes.Get("disabled recovery discharge");
-			corrosion += attributes.Get("disabled recovery corrosion");
-			leakage += attributes.Get("disabled recovery leak");
-			burning += attributes.Get("disabled recovery burning");
+			heat += attributes.Get(Attribute("disabled recovery heat"));
+			ionization += attributes.Get(Attribute("disabled recovery ionization"));
+			scrambling += attributes.Get(Attribute("disabled recovery scrambling"));
+			disruption += attributes.Get(Attribute("disabled recovery disruption"));
+			slowness += attributes.Get(Attribute("disabled recovery slowing"));
+			discharge += attributes.Get(Attribute("disabled recovery discharge"));
+			corrosion += attributes.Get(Attribute("disabled recovery corrosion"));
+			leakage += attributes.Get(Attribute("disabled recovery leak"));
+			burning += attributes.Get(Attribute("disabled recovery burning"));
 
 			disabledRecoveryCounter = 0;
 			hull = min(max(hull, MinimumHull() * 1.5), MaxHull());
@@ -4064,80 +4077,80 @@ void Ship::DoGeneration()
 	// TODO: Mothership gives status resistance to carried ships?
 	if(ionization)
 	{
-		double ionResistance = attributes.Get("ion resistance");
-		double ionEnergy = attributes.Get("ion resistance energy") / ionResistance;
-		double ionFuel = attributes.Get("ion resistance fuel") / ionResistance;
-		double ionHeat = attributes.Get("ion resistance heat") / ionResistance;
+		double ionResistance = attributes.Get(Attribute("ion resistance"));
+		double ionEnergy = attributes.Get(Attribute("ion resistance energy")) / ionResistance;
+		double ionFuel = attributes.Get(Attribute("ion resistance fuel")) / ionResistance;
+		double ionHeat = attributes.Get(Attribute("ion resistance heat")) / ionResistance;
 		DoStatusEffect(isDisabled, ionization, ionResistance,
 			energy, ionEnergy, fuel, ionFuel, heat, ionHeat);
 	}
 
 	if(scrambling)
 	{
-		double scramblingResistance = attributes.Get("scramble resistance");
-		double scramblingEnergy = attributes.Get("scramble resistance energy") / scramblingResistance;
-		double scramblingFuel = attributes.Get("scramble resistance fuel") / scramblingResistance;
-		double scramblingHeat = attributes.Get("scramble resistance heat") / scramblingResistance;
+		double scramblingResistance = attributes.Get(Attribute("scramble resistance"));
+		double scramblingEnergy = attributes.Get(Attribute("scramble resistance energy")) / scramblingResistance;
+		double scramblingFuel = attributes.Get(Attribute("scramble resistance fuel")) / scramblingResistance;
+		double scramblingHeat = attributes.Get(Attribute("scramble resistance heat")) / scramblingResistance;
 		DoStatusEffect(isDisabled, scrambling, scramblingResistance,
 			energy, scramblingEnergy, fuel, scramblingFuel, heat, scramblingHeat);
 	}
 
 	if(disruption)
 	{
-		double disruptionResistance = attributes.Get("disruption resistance");
-		double disruptionEnergy = attributes.Get("disruption resistance energy") / disruptionResistance;
-		double disruptionFuel = attributes.Get("disruption resistance fuel") / disruptionResistance;
-		double disruptionHeat = attributes.Get("disruption resistance heat") / disruptionResistance;
+		double disruptionResistance = attributes.Get(Attribute("disruption resistance"));
+		double disruptionEnergy = attributes.Get(Attribute("disruption resistance energy")) / disruptionResistance;
+		double disruptionFuel = attributes.Get(Attribute("disruption resistance fuel")) / disruptionResistance;
+		double disruptionHeat = attributes.Get(Attribute("disruption resistance heat")) / disruptionResistance;
 		DoStatusEffect(isDisabled, disruption, disruptionResistance,
 			energy, disruptionEnergy, fuel, disruptionFuel, heat, disruptionHeat);
 	}
 
 	if(slowness)
 	{
-		double slowingResistance = attributes.Get("slowing resistance");
-		double slowingEnergy = attributes.Get("slowing resistance energy") / slowingResistance;
-		double slowingFuel = attributes.Get("slowing resistance fuel") / slowingResistance;
-		double slowingHeat = attributes.Get("slowing resistance heat") / slowingResistance;
+		double slowingResistance = attributes.Get(Attribute("slowing resistance"));
+		double slowingEnergy = attributes.Get(Attribute("slowing resistance energy")) / slowingResistance;
+		double slowingFuel = attributes.Get(Attribute("slowing resistance fuel")) / slowingResistance;
+		double slowingHeat = attributes.Get(Attribute("slowing resistance heat")) / slowingResistance;
 		DoStatusEffect(isDisabled, slowness, slowingResistance,
 			energy, slowingEnergy, fuel, slowingFuel, heat, slowingHeat);
 	}
 
 	if(discharge)
 	{
-		double dischargeResistance = attributes.Get("discharge resistance");
-		double dischargeEnergy = attributes.Get("discharge resistance energy") / dischargeResistance;
-		double dischargeFuel = attributes.Get("discharge resistance fuel") / dischargeResistance;
-		double dischargeHeat = attributes.Get("discharge resistance heat") / dischargeResistance;
+		double dischargeResistance = attributes.Get(Attribute("discharge resistance"));
+		double dischargeEnergy = attributes.Get(Attribute("discharge resistance energy")) / dischargeResistance;
+		double dischargeFuel = attributes.Get(Attribute("discharge resistance fuel")) / dischargeResistance;
+		double dischargeHeat = attributes.Get(Attribute("discharge resistance heat")) / dischargeResistance;
 		DoStatusEffect(isDisabled, discharge, dischargeResistance,
 			energy, dischargeEnergy, fuel, dischargeFuel, heat, dischargeHeat);
 	}
 
 	if(corrosion)
 	{
-		double corrosionResistance = attributes.Get("corrosion resistance");
-		double corrosionEnergy = attributes.Get("corrosion resistance energy") / corrosionResistance;
-		double corrosionFuel = attributes.Get("corrosion resistance fuel") / corrosionResistance;
-		double corrosionHeat = attributes.Get("corrosion resistance heat") / corrosionResistance;
+		double corrosionResistance = attributes.Get(Attribute("corrosion resistance"));
+		double corrosionEnergy = attributes.Get(Attribute("corrosion resistance energy")) / corrosionResistance;
+		double corrosionFuel = attributes.Get(Attribute("corrosion resistance fuel")) / corrosionResistance;
+		double corrosionHeat = attributes.Get(Attribute("corrosion resistance heat")) / corrosionResistance;
 		DoStatusEffect(isDisabled, corrosion, corrosionResistance,
 			energy, corrosionEnergy, fuel, corrosionFuel, heat, corrosionHeat);
 	}
 
 	if(leakage)
 	{
-		double leakResistance = attributes.Get("leak resistance");
-		double leakEnergy = attributes.Get("leak resistance energy") / leakResistance;
-		double leakFuel = attributes.Get("leak resistance fuel") / leakResistance;
-		double leakHeat = attributes.Get("leak resistance heat") / leakResistance;
+		double leakResistance = attributes.Get(Attribute("leak resistance"));
+		double leakEnergy = attributes.Get(Attribute("leak resistance energy")) / leakResistance;
+		double leakFuel = attributes.Get(Attribute("leak resistance fuel")) / leakResistance;
+		double leakHeat = attributes.Get(Attribute("leak resistance heat")) / leakResistance;
 		DoStatusEffect(isDisabled, leakage, leakResistance,
 			energy, leakEnergy, fuel, leakFuel, heat, leakHeat);
 	}
 
 	if(burning)
 	{
-		double burnResistance = attributes.Get("burn resistance");
-		double burnEnergy = attributes.Get("burn resistance energy") / burnResistance;
-		double burnFuel = attributes.Get("burn resistance fuel") / burnResistance;
-		double burnHeat = attributes.Get("burn resistance heat") / burnResistance;
+		double burnResistance = attributes.Get(Attribute("burn resistance"));
+		double burnEnergy = attributes.Get(Attribute("burn resistance energy")) / burnResistance;
+		double burnFuel = attributes.Get(Attribute("burn resistance fuel")) / burnResistance;
+		double burnHeat = attributes.Get(Attribute("burn resistance heat")) / burnResistance;
 		DoStatusEffect(isDisabled, burning, burnResistance,
 			energy, burnEnergy, fuel, burnFuel, heat, burnHeat);
 	}
@@ -4146,16 +4159,16 @@ void Ship::DoGeneration()
 	// maximum capacity for the rest of the turn, but must be clamped to the
 	// maximum here before they gain more. This is so that, for example, a ship
 	// with no batteries but a good generator can still move.
-	energy = min(energy, attributes.Get("energy capacity"));
-	fuel = min(fuel, attributes.Get("fuel capacity"));
+	energy = min(energy, attributes.Get(Attribute("energy capacity")));
+	fuel = min(fuel, attributes.Get(Attribute("fuel capacity")));
 
 	heat -= heat * HeatDissipation();
 	if(heat > MaximumHeat())
 	{
 		isOverheated = true;
-		double heatRatio = Heat() / (1. + attributes.Get("overheat damage threshold"));
+		double heatRatio = Heat() / (1. + attributes.Get(Attribute("overheat damage threshold")));
 		if(heatRatio > 1.)
-			hull -= attributes.Get("overheat damage rate") * heatRatio;
+			hull -= attributes.Get(Attribute("overheat damage rate")) * heatRatio;
 	}
 	else if(heat < .9 * MaximumHeat())
 		isOverheated = false;
@@ -4177,35 +4190,35 @@ void Ship::DoGeneration()
 		if(currentSystem)
 		{
 			double scale = .2 + 1.8 / (.001 * position.Length() + 1);
-			fuel += currentSystem->RamscoopFuel(attributes.Get("ramscoop"), scale);
+			fuel += currentSystem->RamscoopFuel(attributes.Get(Attribute("ramscoop")), scale);
 
 			double solarScaling = currentSystem->SolarPower() * scale;
-			energy += solarScaling * attributes.Get("solar collection");
-			heat += solarScaling * attributes.Get("solar heat");
+			energy += solarScaling * attributes.Get(Attribute("solar collection"));
+			heat += solarScaling * attributes.Get(Attribute("solar heat"));
 		}
 
 		double coolingEfficiency = CoolingEfficiency();
-		energy += attributes.Get("energy generation") - attributes.Get("energy consumption");
-		fuel += attributes.Get("fuel generation");
-		heat += attributes.Get("heat generation");
-		heat -= coolingEfficiency * attributes.Get("cooling");
+		energy += attributes.Get(Attribute("energy generation")) - attributes.Get(Attribute("energy consumption"));
+		fuel += attributes.Get(Attribute("fuel generation"));
+		heat += attributes.Get(Attribute("heat generation"));
+		heat -= coolingEfficiency * attributes.Get(Attribute("cooling"));
 
 		// Convert fuel into energy and heat only when the required amount of fuel is available.
-		if(attributes.Get("fuel consumption") <= fuel)
+		if(attributes.Get(Attribute("fuel consumption")) <= fuel)
 		{
-			fuel -= attributes.Get("fuel consumption");
-			energy += attributes.Get("fuel energy");
-			heat += attributes.Get("fuel heat");
+			fuel -= attributes.Get(Attribute("fuel consumption"));
+			energy += attributes.Get(Attribute("fuel energy"));
+			heat += attributes.Get(Attribute("fuel heat"));
 		}
 
 		// Apply active cooling. The fraction of full cooling to apply equals
 		// your ship's current fraction of its maximum temperature.
-		double activeCooling = coolingEfficiency * attributes.Get("active cooling");
+		double activeCooling = coolingEfficiency * attributes.Get(Attribute("active cooling"));
 		if(activeCooling > 0. && heat > 0. && energy >= 0.)
 		{
 			// Handle the case where "active cooling"
 			// does not require any energy.
-			double coolingEnergy = attributes.Get("cooling energy");
+			double coolingEnergy = attributes.Get(Attribute("cooling energy"));
 			if(coolingEnergy)
 			{
 				double spentEnergy = min(energy, coolingEnergy * min(1., Heat()));
@@ -4275,15 +4288,15 @@ void Ship::DoCloakDecision()
 
 	// Attempting to cloak when the cloaking device can no longer operate (because of hull damage)
 	// will result in it being uncloaked.
-	const double minimalHullForCloak = attributes.Get("cloak hull threshold");
-	if(minimalHullForCloak && (hull / attributes.Get("hull") < minimalHullForCloak))
+	const double minimalHullForCloak = attributes.Get(Attribute("cloak hull threshold"));
+	if(minimalHullForCloak && (hull / attributes.Get(Attribute("hull")) < minimalHullForCloak))
 		cloakDisruption = 1.;
 
 	const double cloakingSpeed = CloakingSpeed();
-	const double cloakingFuel = attributes.Get("cloaking fuel");
-	const double cloakingEnergy = attributes.Get("cloaking energy");
-	const double cloakingHull = attributes.Get("cloaking hull");
-	const double cloakingShield = attributes.Get("cloaking shields");
+	const double cloakingFuel = attributes.Get(Attribute("cloaking fuel"));
+	const double cloakingEnergy = attributes.Get(Attribute("cloaking energy"));
+	const double cloakingHull = attributes.Get(Attribute("cloaking hull"));
+	const double cloakingShield = attributes.Get(Attribute("cloaking shields"));
 	bool canCloak = (!isDisabled && cloakingSpeed > 0. && !cloakDisruption
 		&& fuel >= cloakingFuel && energy >= cloakingEnergy
 		&& MinimumHull() < hull - cloakingHull && shields >= cloakingShield);
@@ -4294,9 +4307,9 @@ void Ship::DoCloakDecision()
 		energy -= cloakingEnergy;
 		shields -= cloakingShield;
 		hull -= cloakingHull;
-		heat += attributes.Get("cloaking heat");
-		double cloakingShieldDelay = attributes.Get("cloaking shield delay");
-		double cloakingHullDelay = attributes.Get("cloaking repair delay");
+		heat += attributes.Get(Attribute("cloaking heat"));
+		double cloakingShieldDelay = attributes.Get(Attribute("cloaking shield delay"));
+		double cloakingHullDelay = attributes.Get(Attribute("cloaking repair delay"));
 		cloakingShieldDelay = (cloakingShieldDelay < 1.) ?
 			(Random::Real() <= cloakingShieldDelay) : cloakingShieldDelay;
 		cloakingHullDelay = (cloakingHullDelay < 1.) ?
@@ -4475,7 +4488,7 @@ bool Ship::DoLandingLogic()
 	if(isDisabled)
 		landingPlanet = nullptr;
 
-	float landingSpeed = attributes.Get("landing speed");
+	float landingSpeed = attributes.Get(Attribute("landing speed"));
 	landingSpeed = landingSpeed > 0 ? landingSpeed : .02f;
 	// Special ships do not disappear forever when they land; they
 	// just slowly refuel.
@@ -4510,7 +4523,7 @@ bool Ship::DoLandingLogic()
 		}
 	}
 	// Only refuel if this planet has a spaceport.
-	else if(fuel >= attributes.Get("fuel capacity")
+	else if(fuel >= attributes.Get(Attribute("fuel capacity"))
 			|| !landingPlanet || !landingPlanet->GetPort().CanRecharge(Port::RechargeType::Fuel))
 	{
 		zoom = min(1.f, zoom + landingSpeed);
@@ -4518,7 +4531,7 @@ bool Ship::DoLandingLogic()
 		landingPlanet = nullptr;
 	}
 	else
-		fuel = min(fuel + 1., attributes.Get("fuel capacity"));
+		fuel = min(fuel + 1., attributes.Get(Attribute("fuel capacity")));
 
 	// Move the ship at the velocity it had when it began landing, but
 	// scaled based on how small it is now.
@@ -4597,23 +4610,23 @@ void Ship::DoMovement(bool &isUsingAfterburner)
 		if(commands.Turn())
 		{
 			// Check if we are able to turn.
-			double cost = attributes.Get("turning energy");
+			double cost = attributes.Get(Attribute("turning energy"));
 			if(cost > 0. && energy < cost * fabs(commands.Turn()))
 				commands.SetTurn(copysign(energy / cost, commands.Turn()));
 
-			cost = attributes.Get("turning shields");
+			cost = attributes.Get(Attribute("turning shields"));
 			if(cost > 0. && shields < cost * fabs(commands.Turn()))
 				commands.SetTurn(copysign(shields / cost, commands.Turn()));
 
-			cost = attributes.Get("turning hull");
+			cost = attributes.Get(Attribute("turning hull"));
 			if(cost > 0. && hull < cost * fabs(commands.Turn()))
 				commands.SetTurn(copysign(hull / cost, commands.Turn()));
 
-			cost = attributes.Get("turning fuel");
+			cost = attributes.Get(Attribute("turning fuel"));
 			if(cost > 0. && fuel < cost * fabs(commands.Turn()))
 				commands.SetTurn(copysign(fuel / cost, commands.Turn()));
 
-			cost = -attributes.Get("turning heat");
+			cost = -attributes.Get(Attribute("turning heat"));
 			if(cost > 0. && heat < cost * fabs(commands.Turn()))
 				commands.SetTurn(copysign(heat / cost, commands.Turn()));
 
@@ -4626,19 +4639,19 @@ void Ship::DoMovement(bool &isUsingAfterburner)
 				// of the turning energy and produce a fraction of the heat.
 				double scale = fabs(commands.Turn());
 
-				shields -= scale * attributes.Get("turning shields");
-				hull -= scale * attributes.Get("turning hull");
-				energy -= scale * attributes.Get("turning energy");
-				fuel -= scale * attributes.Get("turning fuel");
-				heat += scale * attributes.Get("turning heat");
-				discharge += scale * attributes.Get("turning discharge");
-				corrosion += scale * attributes.Get("turning corrosion");
-				ionization += scale * attributes.Get("turning ion");
-				scrambling += scale * attributes.Get("turning scramble");
-				leakage += scale * attributes.Get("turning leakage");
-				burning += scale * attributes.Get("turning burn");
-				slowness += scale * attributes.Get("turning slowing");
-				disruption += scale * attributes.Get("turning disruption");
+				shields -= scale * attributes.Get(Attribute("turning shields"));
+				hull -= scale * attributes.Get(Attribute("turning hull"));
+				energy -= scale * attributes.Get(Attribute("turning energy"));
+				fuel -= scale * attributes.Get(Attribute("turning fuel"));
+				heat += scale * attributes.Get(Attribute("turning heat"));
+				discharge += scale * attributes.Get(Attribute("turning discharge"));
+				corrosion += scale * attributes.Get(Attribute("turning corrosion"));
+				ionization += scale * attributes.Get(Attribute("turning ion"));
+				scrambling += scale * attributes.Get(Attribute("turning scramble"));
+				leakage += scale * attributes.Get(Attribute("turning leakage"));
+				burning += scale * attributes.Get(Attribute("turning burn"));
+				slowness += scale * attributes.Get(Attribute("turning slowing"));
+				disruption += scale * attributes.Get(Attribute("turning disruption"));
 
 				Turn(commands.Turn() * TurnRate() * slowMultiplier);
 			}
@@ -4678,7 +4691,7 @@ void Ship::DoMovement(bool &isUsingAfterburner)
 				// If a reverse thrust is commanded and the capability does not
 				// exist, ignore it (do not even slow under drag).
 				isThrusting = (thrustCommand > 0.);
-				isReversing = !isThrusting && attributes.Get("reverse thrust");
+				isReversing = !isThrusting && attributes.Get(Attribute("reverse thrust"));
 				thrust = attributes.Get(isThrusting ? "thrust" : "reverse thrust");
 				if(thrust)
 				{
@@ -4707,22 +4720,22 @@ void Ship::DoMovement(bool &isUsingAfterburner)
 				&& !CannotAct(Ship::ActionType::AFTERBURNER);
 		if(applyAfterburner)
 		{
-			thrust = attributes.Get("afterburner thrust");
-			double shieldCost = attributes.Get("afterburner shields");
-			double hullCost = attributes.Get("afterburner hull");
-			double energyCost = attributes.Get("afterburner energy");
-			double fuelCost = attributes.Get("afterburner fuel");
-			double heatCost = -attributes.Get("afterburner heat");
-
-			double dischargeCost = attributes.Get("afterburner discharge");
-			double corrosionCost = attributes.Get("afterburner corrosion");
-			double ionCost = attributes.Get("afterburner ion");
-			double scramblingCost = attributes.Get("afterburner scramble");
-			double leakageCost = attributes.Get("afterburner leakage");
-			double burningCost = attributes.Get("afterburner burn");
-
-			double slownessCost = attributes.Get("afterburner slowing");
-			double disruptionCost = attributes.Get("afterburner disruption");
+			thrust = attributes.Get(Attribute("afterburner thrust"));
+			double shieldCost = attributes.Get(Attribute("afterburner shields"));
+			double hullCost = attributes.Get(Attribute("afterburner hull"));
+			double energyCost = attributes.Get(Attribute("afterburner energy"));
+			double fuelCost = attributes.Get(Attribute("afterburner fuel"));
+			double heatCost = -attributes.Get(Attribute("afterburner heat"));
+
+			double dischargeCost = attributes.Get(Attribute("afterburner discharge"));
+			double corrosionCost = attributes.Get(Attribute("afterburner corrosion"));
+			double ionCost = attributes.Get(Attribute("afterburner ion"));
+			double scramblingCost = attributes.Get(Attribute("afterburner scramble"));
+			double leakageCost = attributes.Get(Attribute("afterburner leakage"));
+			double burningCost = attributes.Get(Attribute("afterburner burn"));
+
+			double slownessCost = attributes.Get(Attribute("afterburner slowing"));
+			double disruptionCost = attributes.Get(Attribute("afterburner disruption"));
 
 			if(thrust && shields >= shieldCost && hull >= hullCost
 				&& energy >= energyCost && fuel >= fuelCost && heat >= heatCost)
@@ -4743,7 +4756,7 @@ void Ship::DoMovement(bool &isUsingAfterburner)
 				slowness += slownessCost;
 				disruption += disruptionCost;
 
-				acceleration += angle.Unit() * (1. + attributes.Get("acceleration multiplier")) * thrust / mass;
+				acceleration += angle.Unit() * (1. + attributes.Get(Attribute("acceleration multiplier"))) * thrust / mass;
 
 				// Only create the afterburner effects if the ship is in the player's system.
 				isUsingAfterburner = !forget;
@@ -4754,7 +4767,8 @@ void Ship::DoMovement(bool &isUsingAfterburner)
 	{
 		acceleration *= slowMultiplier;
 		// Acceleration multiplier needs to modify effective drag, otherwise it changes top speeds.
-		Point dragAcceleration = acceleration - velocity * dragForce * (1. + attributes.Get("acceleration multiplier"));
+		Point dragAcceleration = acceleration
+			- velocity * dragForce * (1. + attributes.Get(Attribute("acceleration multiplier")));
 		// Make sure dragAcceleration has nonzero length, to avoid divide by zero.
 		if(dragAcceleration)
 		{
@@ -4829,7 +4843,7 @@ void Ship::StepTargeting()
 
 			if(distance < 10. && speed < 1. && ((CanBeCarried() && government == target->government) || !turn))
 			{
-				if(cloak && !attributes.Get("cloaked boarding"))
+				if(cloak && !attributes.Get(Attribute("cloaked boarding")))
 				{
 					// Allow the player to get all the way to the end of the
 					// boarding sequence (including locking on to the ship) but
@@ -4841,7 +4855,7 @@ void Ship::StepTargeting()
 				{
 					isBoarding = false;
 					bool isEnemy = government->IsEnemy(target->government);
-					if(isEnemy && Random::Real() < target->Attributes().Get("self destruct"))
+					if(isEnemy && Random::Real() < target->Attributes().Get(Attribute("self destruct")))
 					{
 						Messages::Add("The " + target->DisplayModelName() + " \"" + target->Name()
 							+ "\" has activated its self-destruct mechanism.", Messages::Importance::High);
@@ -4915,16 +4929,16 @@ double Ship::MinimumHull() const
 		return 0.;
 
 	double maximumHull = MaxHull();
-	double absoluteThreshold = attributes.Get("absolute threshold");
+	double absoluteThreshold = attributes.Get(Attribute("absolute threshold"));
 	if(absoluteThreshold > 0.)
 		return absoluteThreshold;
 
-	double thresholdPercent = attributes.Get("threshold percentage");
+	double thresholdPercent = attributes.Get(Attribute("threshold percentage"));
 	double transition = 1 / (1 + 0.0005 * maximumHull);
 	double minimumHull = maximumHull * (thresholdPercent > 0.
 		? min(thresholdPercent, 1.) : 0.1 * (1. - transition) + 0.5 * transition);
 
-	return max(0., floor(minimumHull + attributes.Get("hull threshold")));
+	return max(0., floor(minimumHull + attributes.Get(Attribute("hull threshold"))));
 }
 
 
@@ -5000,7 +5014,7 @@ void Ship::CreateSparks(vector<Visual> &visuals, const Effect *effect, double am
 
 double Ship::CalculateAttraction() const
 {
-	return max(0., .4 * sqrt(attributes.Get("cargo space")) - 1.8);
+	return max(0., .4 * sqrt(attributes.Get(Attribute("cargo space"))) - 1.8);
 }
 
 
@@ -5033,13 +5047,13 @@ double Ship::CalculateDeterrence() const
 			// Other damage types don't outright destroy ships, so they aren't considered
 			// as heavily in the strength of a weapon.
 			double energyFactor = weapon->EnergyDamage()
-					+ weapon->RelativeEnergyDamage() * attributes.Get("energy capacity")
+					+ weapon->RelativeEnergyDamage() * attributes.Get(Attribute("energy capacity"))
 					+ weapon->IonDamage() * 100.;
 			double heatFactor = weapon->HeatDamage()
 					+ weapon->RelativeHeatDamage() * MaximumHeat()
 					+ weapon->BurnDamage() * 100.;
 			double fuelFactor = weapon->FuelDamage()
-					+ weapon->RelativeFuelDamage() * attributes.Get("fuel capacity")
+					+ weapon->RelativeFuelDamage() * attributes.Get(Attribute("fuel capacity"))
 					+ weapon->LeakDamage() * 100.;
 			double scramblingFactor = weapon->ScramblingDamage() * 100.;
 			double slowingFactor = weapon->SlowingDamage() * 100.;
@@ -5053,3 +5067,76 @@ double Ship::CalculateDeterrence() const
 		}
 	return tempDeterrence;
 }
+
+
+
+void Ship::UpdateDerivedStats()
+{
+	derived = DerivedStats(attributes);
+}
+
+
+
+Ship::DerivedStats::DerivedStats(const Outfit &attributes)
+	: drag(attributes.Get(Attribute("drag")) / (1. + attributes.Get(Attribute("drag reduction")))),
+	inertiaFactor(1. + attributes.Get(Attribute("inertia reduction"))),
+	turn(attributes.Get(Attribute("turn"))),
+	turnFactor(1. + attributes.Get(Attribute("turn multiplier"))),
+	thrust(attributes.Get(Attribute("thrust"))),
+	afterburnerThrust(attributes.Get(Attribute("afterburner thrust"))),
+	reverseThrust(attributes.Get(Attribute("reverse thrust"))),
+	accelerationFactor(1. + attributes.Get(Attribute("acceleration multiplier")))
+{
+	// The first entry is used once the repair delay has run out, so it also
+	// includes the "delayed" repair attributes. The second is used during the delay.
+	for(int isDelayed = 0; isDelayed < 2; ++isDelayed)
+	{
+		Repair &hull = hullRepair[isDelayed];
+		hull.available = (attributes.Get(Attribute("hull repair rate"))
+			+ (isDelayed ? 0 : attributes.Get(Attribute("delayed hull repair rate"))))
+			* (1. + attributes.Get(Attribute("hull repair multiplier")));
+		hull.energy = (attributes.Get(Attribute("hull energy"))
+			+ (isDelayed ? 0 : attributes.Get(Attribute("delayed hull energy"))))
+			* (1. + attributes.Get(Attribute("hull energy multiplier"))) / hull.available;
+		hull.fuel = (attributes.Get(Attribute("hull fuel"))
+			+ (isDelayed ? 0 : attributes.Get(Attribute("delayed hull fuel"))))
+			* (1. + attributes.Get(Attribute("hull fuel multiplier"))) / hull.available;
+		hull.heat = (attributes.Get(Attribute("hull heat"))
+			+ (isDelayed ? 0 : attributes.Get(Attribute("delayed hull heat"))))
+			* (1. + attributes.Get(Attribute("hull heat multiplier"))) / hull.available;
+
+		Repair &shields = shieldRepair[isDelayed];
+		shields.available = (attributes.Get(Attribute("shield generation"))
+			+ (isDelayed ? 0 : attributes.Get(Attribute("delayed shield generation"))))
+			* (1. + attributes.Get(Attribute("shield generation multiplier")));
+		shields.energy = (attributes.Get(Attribute("shield energy"))
+			+ (isDelayed ? 0 : attributes.Get(Attribute("delayed shield energy"))))
+			* (1. + attributes.Get(Attribute("shield energy multiplier"))) / shields.available;
+		shields.fuel = (attributes.Get(Attribute("shield fuel"))
+			+ (isDelayed ? 0 : attributes.Get(Attribute("delayed shield fuel"))))
+			* (1. + attributes.Get(Attribute("shield fuel multiplier"))) / shields.available;
+		shields.heat = (attributes.Get(Attribute("shield heat"))
+			+ (isDelayed ? 0 : attributes.Get(Attribute("delayed shield heat"))))
+			* (1. + attributes.Get(Attribute("shield heat multiplier"))) / shields.available;
+	}
+}
+
+
+
+bool Ship::DerivedStats::Matches(const DerivedStats &other) const
+{
+	// A repair cost is NaN if there is no repair rate, so treat NaNs as equal.
+	auto same = [](double a, double b) { return a == b || (isnan(a) && isnan(b)); };
+	auto sameRepair = [&same](const Repair &a, const Repair &b)
+	{
+		return same(a.available, b.available) && same(a.energy, b.energy)
+			&& same(a.fuel, b.fuel) && same(a.heat, b.heat);
+	};
+	for(int i = 0; i < 2; ++i)
+		if(!sameRepair(hullRepair[i], other.hullRepair[i]) || !sameRepair(shieldRepair[i], other.shieldRepair[i]))
+			return false;
+	return same(drag, other.drag) && same(inertiaFactor, other.inertiaFactor) && same(turn, other.turn)
+		&& same(turnFactor, other.turnFactor) && same(thrust, other.thrust)
+		&& same(afterburnerThrust, other.afterburnerThrust) && same(reverseThrust, other.reverseThrust)
+		&& same(accelerationFactor, other.accelerationFactor);
+}
@@ -215,6 +215,15 @@ public:
 	// Move this ship. A ship may create effects as it moves, in particular if
 	// it is in the process of blowing up.
 	void Move(std::vector<Visual> &visuals, std::list<std::shared_ptr<Flotsam>> &flotsam);
+	// Move() split into two halves, so that the first half can be run for many
+	// ships in parallel. MoveSelf() only modifies this ship and the ships it is
+	// carrying, and returns false if the ship is done moving for this step.
+	// Otherwise, FinishMove() must be called afterwards; it handles boarding,
+	// which may read or modify the ship being boarded.
+	// Ships that are entering or exiting hyperspace look at their parent ship's
+	// position, so they must not call MoveSelf() while their parent is moving.
+	bool MoveSelf(std::vector<Visual> &visuals, std::list<std::shared_ptr<Flotsam>> &flotsam);
+	void FinishMove(std::vector<Visual> &visuals);
 
 	// Launch any ships that are ready to launch.
 	void Launch(std::list<std::shared_ptr<Ship>> &ships, std::vector<Visual> &visuals);
@@ -542,6 +551,9 @@ private:
 	// This is only useful for the player's ships.
 	double CalculateAttraction() const;
 	double CalculateDeterrence() const;
+	// Recalculate the cached stats that depend on this ship's attributes. This
+	// must be called whenever the attributes change.
+	void UpdateDerivedStats();
 
 
 private:
@@ -585,6 +597,9 @@ private:
 	bool isReversing = false;
 	bool isSteering = false;
 	double steeringDirection = 0.;
+	// State carried over from MoveSelf() to FinishMove().
+	bool isMoveBeingDestroyed = false;
+	bool isMoveUsingAfterburner = false;
 	bool neverDisabled = false;
 	bool isCapturable = true;
 	bool isInvisible = false;
@@ -625,6 +640,44 @@ private:
 	// Cache the mass of carried ships to avoid repeatedly recomputing it.
 	double carriedMass = 0.;
 
+	// Movement and repair values that depend only on the ship's attributes.
+	// These are looked up many times per frame, so they are calculated once
+	// whenever the attributes change instead of on every query.
+	class DerivedStats {
+	public:
+		// The amount of hull or shields that can be repaired per frame, and the
+		// energy, fuel, and heat that each point of repair costs.
+		class Repair {
+		public:
+			double available = 0.;
+			double energy = 0.;
+			double fuel = 0.;
+			double heat = 0.;
+		};
+
+	public:
+		DerivedStats() = default;
+		explicit DerivedStats(const Outfit &attributes);
+
+		// Check if these stats are identical to the given ones. This is used to
+		// catch any attribute changes that do not update the cached stats.
+		bool Matches(const DerivedStats &other) const;
+
+	public:
+		double drag = 0.;
+		double inertiaFactor = 1.;
+		double turn = 0.;
+		double turnFactor = 1.;
+		double thrust = 0.;
+		double afterburnerThrust = 0.;
+		double reverseThrust = 0.;
+		double accelerationFactor = 1.;
+		// Repair rates when the repair delay has run out, and while it is active.
+		Repair hullRepair[2];
+		Repair shieldRepair[2];
+	};
+	DerivedStats derived;
+
 	std::vector<EnginePoint> enginePoints;
 	std::vector<EnginePoint> reverseEnginePoints;
 	std::vector<EnginePoint> steeringEnginePoints;
@@ -0,0 +1,108 @@
+/* ShipGrid.cpp
+Copyright (c) 2026 by the Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "ShipGrid.h"
+
+#include "Point.h"
+#include "Ship.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+
+namespace {
+	// The cells are about the size of a typical weapon range, so a turret or
+	// auto-fire search only needs to look at a few rows of cells.
+	const double CELL_SIZE = 1024.;
+	// Cell coordinates are clamped to this magnitude, so that ships very far
+	// from the system center (or with invalid positions) still get a cell.
+	const double MAX_CELL = 1 << 30;
+
+	int64_t CellCoordinate(double value)
+	{
+		double cell = floor(value / CELL_SIZE);
+		// NaN positions are placed in cell 0 rather than given an undefined cell.
+		if(std::isnan(cell))
+			return 0;
+		return static_cast<int64_t>(clamp(cell, -MAX_CELL, MAX_CELL));
+	}
+
+	// Cells are sorted by row and then by column, so a row of cells forms
+	// a contiguous range of keys.
+	uint64_t CellKey(int64_t x, int64_t y)
+	{
+		return (static_cast<uint64_t>(y + static_cast<int64_t>(MAX_CELL)) << 32)
+			| static_cast<uint64_t>(x + static_cast<int64_t>(MAX_CELL));
+	}
+}
+
+
+
+// Replace the contents of the grid with the given ships.
+void ShipGrid::Build(const vector<Ship *> &ships)
+{
+	this->ships = ships;
+	cells.clear();
+	cells.reserve(ships.size());
+	for(unsigned i = 0; i < ships.size(); ++i)
+	{
+		const Point &position = ships[i]->Position();
+		cells.emplace_back(CellKey(CellCoordinate(position.X()), CellCoordinate(position.Y())), i);
+	}
+	sort(cells.begin(), cells.end());
+}
+
+
+
+// Append to the result every ship that might be within the given range of
+// the given point, in the same order as the list the grid was built from.
+void ShipGrid::Query(const Point &center, double range, vector<Ship *> &result) const
+{
+	if(ships.empty())
+		return;
+
+	const int64_t minX = CellCoordinate(center.X() - range);
+	const int64_t maxX = CellCoordinate(center.X() + range);
+	const int64_t minY = CellCoordinate(center.Y() - range);
+	const int64_t maxY = CellCoordinate(center.Y() + range);
+	// If the range covers more rows than there are ships, or covers every
+	// cell anyway, it is quicker to return the whole list.
+	if(!(range < MAX_CELL * CELL_SIZE) || static_cast<uint64_t>(maxY - minY) >= ships.size())
+	{
+		result.insert(result.end(), ships.begin(), ships.end());
+		return;
+	}
+
+	thread_local vector<unsigned> indices;
+	indices.clear();
+	for(int64_t y = minY; y <= maxY; ++y)
+	{
+		auto first = lower_bound(cells.begin(), cells.end(), make_pair(CellKey(minX, y), 0u));
+		const uint64_t last = CellKey(maxX, y);
+		for( ; first != cells.end() && first->first <= last; ++first)
+			indices.push_back(first->second);
+	}
+	sort(indices.begin(), indices.end());
+	for(unsigned index : indices)
+		result.push_back(ships[index]);
+}
+
+
+
+bool ShipGrid::IsEmpty() const
+{
+	return ships.empty();
+}
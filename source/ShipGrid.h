@@ -0,0 +1,50 @@
+/* ShipGrid.h
+Copyright (c) 2026 by the Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+class Point;
+class Ship;
+
+
+
+// A coarse spatial index of a list of ships, such as one government's roster
+// in the player's system. It is rebuilt every step, and answers "which ships
+// might be within this range of that point" by visiting only nearby cells
+// instead of every ship in the list.
+class ShipGrid {
+public:
+	// Replace the contents of the grid with the given ships. The ships must
+	// not move until the grid is rebuilt.
+	void Build(const std::vector<Ship *> &ships);
+
+	// Append to the result every ship that might be within the given range of
+	// the given point, in the same order as the list the grid was built from.
+	// This is conservative: the caller must still check the actual distance.
+	void Query(const Point &center, double range, std::vector<Ship *> &result) const;
+
+	bool IsEmpty() const;
+
+
+private:
+	// The list the grid was built from.
+	std::vector<Ship *> ships;
+	// The cell of each ship, and its index in the list, sorted by cell.
+	std::vector<std::pair<uint64_t, unsigned>> cells;
+};
@@ -0,0 +1,199 @@
+/* Simulation.cpp
+Copyright (c) 2026 by the Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "Simulation.h"
+
+#include "Command.h"
+#include "Conversation.h"
+#include "Mission.h"
+#include "Planet.h"
+#include "PlayerInfo.h"
+#include "Recording.h"
+#include "ShipEvent.h"
+
+#include <utility>
+
+using namespace std;
+
+
+
+// Take off from the planet the player is landed on, and start the engine.
+Simulation::Simulation(PlayerInfo &player, Recording *recording)
+	: player(player), engine(player), recording(recording)
+{
+	if(!player.IsLoaded() || !player.Flagship())
+		isDone = true;
+	else if(player.GetPlanet())
+	{
+		// A saved game does not create the missions the planet offers when it
+		// is loaded, so take off and land again, as the player would.
+		player.Land(&ui);
+		ui.Reset();
+		if(player.TakeOff(&ui, true))
+			Land();
+		else
+			isDone = true;
+	}
+	else
+		TakeOff();
+}
+
+
+
+// Take off the same way as in the given recorded flight, and replay the
+// player's input from it instead of leaving the flagship to the AI.
+Simulation::Simulation(PlayerInfo &player, const Recording &recording)
+	: player(player), engine(player)
+{
+	// The recorded flight began from a saved game, which is loaded the same way
+	// the main panel loads one: without offering any new missions.
+	if(!player.IsLoaded() || !player.Flagship() || !player.GetPlanet())
+	{
+		isDone = true;
+		return;
+	}
+	player.Land(&ui);
+	ui.Reset();
+	if(!player.TakeOff(&ui, recording.DistributeCargo()))
+	{
+		isDone = true;
+		return;
+	}
+	ui.Reset();
+
+	engine.Replay(&recording);
+	Start();
+}
+
+
+
+// Run one step (1/60 second of game time) of the simulation.
+void Simulation::Step()
+{
+	if(isDone)
+		return;
+
+	engine.Wait();
+	engine.Step(true);
+	HandleEvents();
+	++steps;
+
+	if(player.IsDead())
+	{
+		isDone = true;
+		return;
+	}
+	// Whenever the flagship lands, do what the planet panel does when the
+	// player takes off again right away.
+	if(player.GetPlanet() && !player.GetPlanet()->IsWormhole())
+		Land();
+	else
+		engine.Go();
+}
+
+
+
+// Check whether the simulation cannot continue, because the player has died
+// or is unable to take off.
+bool Simulation::IsDone() const
+{
+	return isDone;
+}
+
+
+
+// Get how many steps have been run.
+int Simulation::Steps() const
+{
+	return steps;
+}
+
+
+
+// Give a command on behalf of the player, applied in the next step.
+void Simulation::GiveCommand(const Command &command)
+{
+	engine.GiveCommand(command);
+}
+
+
+
+Engine &Simulation::GetEngine()
+{
+	return engine;
+}
+
+
+
+// Pass the events of the last step on to the player's missions.
+void Simulation::HandleEvents()
+{
+	for(const ShipEvent &event : engine.Events())
+		player.HandleEvent(event, &ui);
+	engine.Events().clear();
+	ui.Reset();
+}
+
+
+
+// Land on the current planet, accept the missions it offers, and take off.
+void Simulation::Land()
+{
+	player.Land(&ui);
+	ui.Reset();
+	// A mission with no conversation or dialog is accepted as soon as it is
+	// offered. Any other mission would wait for an answer, so defer it.
+	while(Mission *mission = player.MissionToOffer(Mission::LANDING))
+	{
+		size_t accepted = player.Missions().size();
+		mission->Do(Mission::OFFER, player, &ui);
+		if(player.Missions().size() == accepted)
+			player.MissionCallback(Conversation::DEFER);
+		ui.Reset();
+	}
+	TakeOff();
+}
+
+
+
+// Take off from the current planet and place the player's ships in space.
+void Simulation::TakeOff()
+{
+	if(player.GetPlanet() && !player.TakeOff(&ui, true))
+	{
+		isDone = true;
+		return;
+	}
+	ui.Reset();
+	Start();
+}
+
+
+
+// Place the player's ships in space, and start the engine.
+void Simulation::Start()
+{
+	// A recorded flight starts with the first step after taking off.
+	if(recording)
+		engine.Record(exchange(recording, nullptr));
+	// This is the same sequence that the main panel runs after the planet
+	// panel closes.
+	engine.Place();
+	engine.Go();
+	engine.Wait();
+	engine.Step(true);
+	HandleEvents();
+	engine.Go();
+}
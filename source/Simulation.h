@@ -0,0 +1,77 @@
+/* Simulation.h
+Copyright (c) 2026 by the Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "Engine.h"
+#include "UI.h"
+
+class Command;
+class PlayerInfo;
+class Recording;
+
+
+
+// Class that runs the game engine without a window, graphics, or sound, as fast
+// as the processor allows. It does what the main panel would do each frame, but
+// rather than showing any panels, a landing is followed by an immediate take off.
+// Missions offered on landing are accepted if they have no conversation or
+// dialog; any that do are deferred, and any other panels are thrown away. This
+// makes it possible to run long simulations on machines without a display.
+class Simulation {
+public:
+	// Take off from the planet the player is landed on, and start the engine.
+	// If a recording is given, the flight is recorded to it, which also makes
+	// it play out the same way every time, as the engine reseeds the random
+	// number generators of every thread in every step of a recorded flight.
+	explicit Simulation(PlayerInfo &player, Recording *recording = nullptr);
+	// Take off the same way as in the given recorded flight, and replay the
+	// player's input from it instead of leaving the flagship to the AI.
+	Simulation(PlayerInfo &player, const Recording &recording);
+
+	// Run one step (1/60 second of game time) of the simulation.
+	void Step();
+	// Check whether the simulation cannot continue, because the player has died
+	// or is unable to take off.
+	bool IsDone() const;
+	// Get how many steps have been run.
+	int Steps() const;
+
+	// Give a command on behalf of the player, applied in the next step.
+	void GiveCommand(const Command &command);
+	Engine &GetEngine();
+
+
+private:
+	// Pass the events of the last step on to the player's missions.
+	void HandleEvents();
+	// Land on the current planet, accept the missions it offers, and take off.
+	void Land();
+	// Take off from the current planet and place the player's ships in space.
+	void TakeOff();
+	// Place the player's ships in space, and start the engine.
+	void Start();
+
+
+private:
+	PlayerInfo &player;
+	Engine engine;
+	// The recording to start once the player's ships are placed in space.
+	Recording *recording = nullptr;
+	// Panels that missions create are pushed here, and then discarded.
+	UI ui;
+	bool isDone = false;
+	int steps = 0;
+};
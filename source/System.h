@@ -158,8 +158,9 @@ public:
 	// Get the price of the given commodity in this system.
 	int Trade(const std::string &commodity) const;
 	bool HasTrade() const;
-	// Update the economy. Returns the amount of trade goods this system exports.
-	void StepEconomy();
+	// Get the base price of each commodity that is traded in this system.
+	const std::map<std::string, int> &BasePrices() const;
+	// The supply and exports of each commodity are stored in the economy.
 	void SetSupply(const std::string &commodity, double tons);
 	double Supply(const std::string &commodity) const;
 	double Exports(const std::string &commodity) const;
@@ -187,19 +188,6 @@ private:
 	void UpdateNeighbors(const Set<System> &systems, double distance);
 
 
-private:
-	class Price {
-	public:
-		void SetBase(int base);
-		void Update();
-
-		int base = 0;
-		int price = 0;
-		double supply = 0.;
-		double exports = 0.;
-	};
-
-
 private:
 	bool isDefined = false;
 	bool hasPosition = false;
@@ -267,8 +255,8 @@ private:
 	double jumpDepartureDistance = 0.;
 	double hyperDepartureDistance = 0.;
 
-	// Commodity prices.
-	std::map<std::string, Price> trade;
+	// Base commodity prices.
+	std::map<std::string, int> trade;
 
 	// Attributes, for use in location filters.
 	std::set<std::string> attributes;
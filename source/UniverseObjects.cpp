@@ -25,24 +25,78 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "TaskQueue.h"
 
 #include <algorithm>
+#include <atomic>
+#include <exception>
 #include <iterator>
 #include <map>
+#include <memory>
 #include <set>
+#include <thread>
 #include <utility>
 #include <vector>
 
 using namespace std;
 
+namespace {
+	// The maximum number of data files that may be parsed before the data in
+	// the earlier files has been applied.
+	const size_t MAX_FILES_PARSED_AHEAD = 64;
+
+	// The data files that are being parsed in parallel. Tasks that are still
+	// queued once the loading is done keep this alive until they run.
+	class ParseQueue {
+	public:
+		explicit ParseQueue(vector<string> files)
+			: files(std::move(files)), parsed(this->files.size()), state(this->files.size()) {}
+
+		// Parse the given file, unless some other thread has already started to.
+		// Returns true if this thread parsed it.
+		bool Parse(size_t index) noexcept
+		{
+			char expected = UNPARSED;
+			if(!state[index].compare_exchange_strong(expected, PARSING, memory_order_acq_rel))
+				return false;
+			try {
+				parsed[index] = make_unique<DataFile>(files[index]);
+			}
+			catch(const exception &error)
+			{
+				Logger::LogError("Failed to parse \"" + files[index] + "\": " + error.what());
+			}
+			state[index].store(PARSED, memory_order_release);
+			return true;
+		}
+
+		// Wait for another thread to finish parsing the given file.
+		void Wait(size_t index) const noexcept
+		{
+			while(state[index].load(memory_order_acquire) != PARSED)
+				this_thread::yield();
+		}
+
+	public:
+		const vector<string> files;
+		vector<unique_ptr<DataFile>> parsed;
+
+	private:
+		static constexpr char UNPARSED = 0;
+		static constexpr char PARSING = 1;
+		static constexpr char PARSED = 2;
+		vector<atomic<char>> state;
+	};
+}
+
 
 
 shared_future<void> UniverseObjects::Load(TaskQueue &queue, const vector<string> &sources, bool debugMode)
 {
-	progress = 0.;
+	stepsDone = 0;
+	totalSteps = 1;
 
 	// We need to copy any variables used for loading to avoid a race condition.
 	// 'this' is not copied, so 'this' shouldn't be accessed after calling this
-	// function (except for calling GetProgress which is safe due to the atomic).
-	return queue.Run([this, sources, debugMode]() noexcept -> void
+	// function (except for calling GetProgress which is safe due to the atomics).
+	return queue.Run([this, &queue, sources, debugMode]() noexcept -> void
 		{
 			vector<string> files;
 			for(const string &source : sources)
@@ -56,19 +110,51 @@ shared_future<void> UniverseObjects::Load(TaskQueue &queue, const vector<string>
 						make_move_iterator(list.begin()),
 						make_move_iterator(list.end()));
 			}
-
-			const double step = 1. / (static_cast<int>(files.size()) + 1);
-			for(const auto &path : files)
+			// Only text files contain definitions.
+			erase_if(files, [](const string &path) noexcept -> bool
+				{
+					return path.length() < 4 || path.compare(path.length() - 4, 4, ".txt");
+				});
+
+			// Each file is counted once when it has been parsed and once when its
+			// contents have been applied.
+			totalSteps = 2 * files.size() + 1;
+
+			// Parsing a file does not touch any game objects, so the files are parsed
+			// in parallel. Their contents are applied one at a time in the original
+			// order, so that later definitions still override earlier ones. This
+			// thread is itself one of the task queue's workers, so rather than wait
+			// for a file that no other worker has started parsing yet, it parses that
+			// file itself. Otherwise, if every worker were waiting like this, none of
+			// them would be left to do the parsing.
+			auto parsing = make_shared<ParseQueue>(std::move(files));
+			size_t nextToParse = 0;
+			for(size_t i = 0; i < parsing->files.size(); ++i)
 			{
-				LoadFile(path, debugMode);
-
-				// Increment the atomic progress by one step.
-				// We use acquire + release to prevent any reordering.
-				auto val = progress.load(memory_order_acquire);
-				progress.store(val + step, memory_order_release);
+				// Keep a limited number of files parsed ahead of the one being applied,
+				// so that the parsed data of every file does not need to be held at once.
+				while(nextToParse < parsing->files.size() && nextToParse < i + MAX_FILES_PARSED_AHEAD)
+					queue.Run([this, parsing, index = nextToParse++]() -> void
+						{
+							if(parsing->Parse(index))
+								++stepsDone;
+						});
+
+				if(parsing->Parse(i))
+					++stepsDone;
+				else
+					parsing->Wait(i);
+				if(parsing->parsed[i])
+				{
+					if(debugMode)
+						Logger::LogError("Parsing: " + parsing->files[i]);
+					LoadFile(*parsing->parsed[i], parsing->files[i]);
+					parsing->parsed[i].reset();
+				}
+				++stepsDone;
 			}
 			FinishLoading();
-			progress = 1.;
+			stepsDone = totalSteps.load();
 		});
 }
 
@@ -76,13 +162,21 @@ shared_future<void> UniverseObjects::Load(TaskQueue &queue, const vector<string>
 
 double UniverseObjects::GetProgress() const
 {
-	return progress.load(memory_order_acquire);
+	const size_t total = totalSteps.load(memory_order_acquire);
+	return min(1., static_cast<double>(stepsDone.load(memory_order_acquire)) / total);
 }
 
 
 
 void UniverseObjects::FinishLoading()
 {
+	// Now that every outfit is loaded, the weapons can total up the lifetime and
+	// damage of their submunitions.
+	for(auto &&it : outfits)
+		it.second.FinishLoading();
+	for(auto &&it : hazards)
+		it.second.FinishLoading();
+
 	for(auto &&it : planets)
 		it.second.FinishLoading(wormholes);
 
@@ -316,16 +410,8 @@ void UniverseObjects::CheckReferences()
 
 
 
-void UniverseObjects::LoadFile(const string &path, bool debugMode)
+void UniverseObjects::LoadFile(const DataFile &data, const string &path)
 {
-	// This is an ordinary file. Check to see if it is an image.
-	if(path.length() < 4 || path.compare(path.length() - 4, 4, ".txt"))
-		return;
-
-	DataFile data(path);
-	if(debugMode)
-		Logger::LogError("Parsing: " + path);
-
 	for(const DataNode &node : data)
 	{
 		const string &key = node.Token(0);
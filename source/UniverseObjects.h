@@ -56,6 +56,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include <vector>
 
 
+class DataFile;
 class Panel;
 class Sprite;
 class TaskQueue;
@@ -91,12 +92,15 @@ public:
 
 
 private:
-	void LoadFile(const std::string &path, bool debugMode = false);
+	// Apply the definitions in an already parsed data file.
+	void LoadFile(const DataFile &data, const std::string &path);
 
 
 private:
-	// A value in [0, 1] representing how many source files have been processed for content.
-	std::atomic<double> progress;
+	// How many steps of loading the source files, out of the total, are done.
+	// Each file is one step to parse and one step to apply.
+	std::atomic<size_t> stepsDone = 0;
+	std::atomic<size_t> totalSteps = 1;
 
 
 private:
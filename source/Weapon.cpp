@@ -35,6 +35,7 @@ void Weapon::LoadWeapon(const DataNode &node)
 	bool isClustered = false;
 	calculatedDamage = false;
 	doesDamage = false;
+	totalLifetime = -1.;
 	bool safeRangeOverriden = false;
 	bool disabledDamageSet = false;
 	bool minableDamageSet = false;
@@ -404,6 +405,20 @@ void Weapon::LoadWeapon(const DataNode &node)
 
 
 
+// Once every outfit is loaded, total up the lifetime and damage of this
+// weapon's submunitions.
+void Weapon::FinishLoading()
+{
+	if(!isWeapon)
+		return;
+
+	totalLifetime = -1.;
+	totalLifetime = TotalLifetime();
+	TotalDamage(0);
+}
+
+
+
 bool Weapon::IsWeapon() const
 {
 	return isWeapon;
@@ -508,14 +523,15 @@ double Weapon::TotalLifetime() const
 {
 	if(rangeOverride)
 		return rangeOverride / WeightedVelocity();
-	if(totalLifetime < 0.)
-	{
-		totalLifetime = 0.;
-		for(const auto &it : submunitions)
-			totalLifetime = max(totalLifetime, it.weapon->TotalLifetime());
-		totalLifetime += lifetime;
-	}
-	return totalLifetime;
+	if(totalLifetime >= 0.)
+		return totalLifetime;
+
+	// If this weapon has not finished loading, calculate the total without
+	// storing it.
+	double result = 0.;
+	for(const auto &it : submunitions)
+		result = max(result, it.weapon->TotalLifetime());
+	return result + lifetime;
 }
 
 
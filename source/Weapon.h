@@ -61,6 +61,10 @@ public:
 public:
 	// Load from a "weapon" node, either in an outfit, a ship (explosion), or a hazard.
 	void LoadWeapon(const DataNode &node);
+	// Once every outfit is loaded, total up the lifetime and damage of this
+	// weapon's submunitions, so that afterwards, looking those values up only
+	// reads this weapon and is safe to do from several threads at once.
+	void FinishLoading();
 	bool IsWeapon() const;
 
 	// Get assets used by this weapon.
@@ -366,7 +370,7 @@ private:
 	// Cache the calculation of these values, for faster access.
 	mutable bool calculatedDamage = true;
 	mutable bool doesDamage = false;
-	mutable double totalLifetime = -1.;
+	double totalLifetime = -1.;
 };
 
 
@@ -0,0 +1,296 @@
+/* CompressedImage.cpp
+Copyright (c) 2026 by the Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "CompressedImage.h"
+
+#include "ImageBuffer.h"
+
+#include <algorithm>
+
+using namespace std;
+
+namespace {
+	// A block of 4x4 pixels, each with red, green, blue, and alpha channels.
+	using Block = uint8_t[16][4];
+
+	// Round each channel of the given color to 5, 6, and 5 bits.
+	uint16_t Pack565(const int (&color)[3])
+	{
+		return ((color[0] * 31 + 127) / 255) << 11 | ((color[1] * 63 + 127) / 255) << 5 | (color[2] * 31 + 127) / 255;
+	}
+
+	// Expand a packed color to 8 bits per channel, the same way graphics cards do.
+	void Unpack565(uint16_t packed, int (&color)[3])
+	{
+		int red = packed >> 11;
+		int green = (packed >> 5) & 63;
+		int blue = packed & 31;
+		color[0] = (red << 3) | (red >> 2);
+		color[1] = (green << 2) | (green >> 4);
+		color[2] = (blue << 3) | (blue >> 2);
+	}
+
+	// Get the four colors a block with the given endpoints can use. The first
+	// endpoint is always greater than the second, so the block uses the two
+	// endpoints and two colors evenly spaced between them.
+	void ColorPalette(uint16_t c0, uint16_t c1, int (&palette)[4][3])
+	{
+		Unpack565(c0, palette[0]);
+		Unpack565(c1, palette[1]);
+		for(int c = 0; c < 3; ++c)
+		{
+			palette[2][c] = (2 * palette[0][c] + palette[1][c] + 1) / 3;
+			palette[3][c] = (palette[0][c] + 2 * palette[1][c] + 1) / 3;
+		}
+	}
+
+	// Get the eight alpha values a block with the given endpoints can use. The
+	// first endpoint is always greater than the second, so the block uses the two
+	// endpoints and six values evenly spaced between them.
+	void AlphaPalette(int a0, int a1, int (&palette)[8])
+	{
+		palette[0] = a0;
+		palette[1] = a1;
+		for(int i = 2; i < 8; ++i)
+			palette[i] = ((8 - i) * a0 + (i - 1) * a1 + 3) / 7;
+	}
+
+	void EncodeBlock(const Block &block, uint8_t *out)
+	{
+		int low[4] = {255, 255, 255, 255};
+		int high[4] = {0, 0, 0, 0};
+		for(const uint8_t (&pixel)[4] : block)
+			for(int c = 0; c < 4; ++c)
+			{
+				low[c] = min<int>(low[c], pixel[c]);
+				high[c] = max<int>(high[c], pixel[c]);
+			}
+
+		// The alpha channel uses the range of alpha values as its endpoints. If
+		// they are equal, every index is zero.
+		int a0 = high[3];
+		int a1 = low[3];
+		uint64_t alphaIndices = 0;
+		if(a0 != a1)
+		{
+			int palette[8];
+			AlphaPalette(a0, a1, palette);
+			for(int i = 0; i < 16; ++i)
+			{
+				int best = 0;
+				for(int j = 1; j < 8; ++j)
+					if(abs(palette[j] - block[i][3]) < abs(palette[best] - block[i][3]))
+						best = j;
+				alphaIndices |= static_cast<uint64_t>(best) << (3 * i);
+			}
+		}
+		out[0] = a0;
+		out[1] = a1;
+		for(int i = 0; i < 6; ++i)
+			out[2 + i] = alphaIndices >> (8 * i);
+
+		// The color endpoints are the corners of the bounding box of the colors.
+		// Because every channel of the first endpoint is at least as large as in
+		// the second, the packed first endpoint is never less than the second.
+		int maxColor[3] = {high[0], high[1], high[2]};
+		int minColor[3] = {low[0], low[1], low[2]};
+		uint16_t c0 = Pack565(maxColor);
+		uint16_t c1 = Pack565(minColor);
+		uint32_t colorIndices = 0;
+		if(c0 != c1)
+		{
+			int palette[4][3];
+			ColorPalette(c0, c1, palette);
+			for(int i = 0; i < 16; ++i)
+			{
+				int best = 0;
+				int bestDistance = 0;
+				for(int j = 0; j < 4; ++j)
+				{
+					int distance = 0;
+					for(int c = 0; c < 3; ++c)
+						distance += (palette[j][c] - block[i][c]) * (palette[j][c] - block[i][c]);
+					if(!j || distance < bestDistance)
+					{
+						best = j;
+						bestDistance = distance;
+					}
+				}
+				colorIndices |= static_cast<uint32_t>(best) << (2 * i);
+			}
+		}
+		out[8] = c0 & 0xFF;
+		out[9] = c0 >> 8;
+		out[10] = c1 & 0xFF;
+		out[11] = c1 >> 8;
+		for(int i = 0; i < 4; ++i)
+			out[12 + i] = colorIndices >> (8 * i);
+	}
+
+	void DecodeBlock(const uint8_t *in, Block &block)
+	{
+		int alphaPalette[8];
+		AlphaPalette(in[0], in[1], alphaPalette);
+		uint64_t alphaIndices = 0;
+		for(int i = 0; i < 6; ++i)
+			alphaIndices |= static_cast<uint64_t>(in[2 + i]) << (8 * i);
+
+		uint16_t c0 = in[8] | in[9] << 8;
+		uint16_t c1 = in[10] | in[11] << 8;
+		int colorPalette[4][3];
+		ColorPalette(c0, c1, colorPalette);
+		uint32_t colorIndices = 0;
+		for(int i = 0; i < 4; ++i)
+			colorIndices |= static_cast<uint32_t>(in[12 + i]) << (8 * i);
+
+		for(int i = 0; i < 16; ++i)
+		{
+			const int (&color)[3] = colorPalette[(colorIndices >> (2 * i)) & 3];
+			for(int c = 0; c < 3; ++c)
+				block[i][c] = color[c];
+			block[i][3] = alphaPalette[(alphaIndices >> (3 * i)) & 7];
+		}
+	}
+
+	// Get the pixel at the given location in the given image.
+	const uint8_t *Pixel(const ImageBuffer &image, int x, int y, int frame)
+	{
+		return reinterpret_cast<const uint8_t *>(image.Begin(y, frame) + x);
+	}
+}
+
+
+
+// Compress all the frames of the given image, optionally reducing them to
+// half their width and height first.
+CompressedImage::CompressedImage(const ImageBuffer &image, bool halfSize)
+{
+	if(!image.Pixels())
+		return;
+
+	width = halfSize ? image.Width() / 2 : image.Width();
+	height = halfSize ? image.Height() / 2 : image.Height();
+	frames = image.Frames();
+	if(!width || !height)
+		return;
+
+	int blocksX = (width + 3) / 4;
+	int blocksY = (height + 3) / 4;
+	data.resize(BLOCK_SIZE * blocksX * blocksY * frames);
+
+	uint8_t *out = data.data();
+	Block block;
+	for(int frame = 0; frame < frames; ++frame)
+		for(int by = 0; by < blocksY; ++by)
+			for(int bx = 0; bx < blocksX; ++bx, out += BLOCK_SIZE)
+			{
+				// Blocks that extend past the edge of the image repeat the edge pixels,
+				// so that they do not affect the colors the block can represent.
+				for(int i = 0; i < 16; ++i)
+				{
+					int x = min(4 * bx + i % 4, width - 1);
+					int y = min(4 * by + i / 4, height - 1);
+					if(!halfSize)
+						copy_n(Pixel(image, x, y, frame), 4, block[i]);
+					else
+					{
+						// Average each 2x2 square of pixels, as ImageBuffer::ShrinkToHalfSize() does.
+						const uint8_t *a = Pixel(image, 2 * x, 2 * y, frame);
+						const uint8_t *b = Pixel(image, 2 * x, 2 * y + 1, frame);
+						for(int c = 0; c < 4; ++c)
+							block[i][c] = (static_cast<unsigned>(a[c]) + static_cast<unsigned>(b[c])
+								+ static_cast<unsigned>(a[c + 4]) + static_cast<unsigned>(b[c + 4]) + 2) / 4;
+					}
+				}
+				EncodeBlock(block, out);
+			}
+}
+
+
+
+bool CompressedImage::IsEmpty() const
+{
+	return data.empty();
+}
+
+
+
+int CompressedImage::Width() const
+{
+	return width;
+}
+
+
+
+int CompressedImage::Height() const
+{
+	return height;
+}
+
+
+
+int CompressedImage::Frames() const
+{
+	return frames;
+}
+
+
+
+const vector<uint8_t> &CompressedImage::Data() const
+{
+	return data;
+}
+
+
+
+// Expand the compressed frames into the given buffer, which must not be
+// allocated yet. This is what a graphics card does when sampling the image.
+void CompressedImage::Decompress(ImageBuffer &image) const
+{
+	image.Clear(frames);
+	if(data.empty())
+		return;
+	image.Allocate(width, height);
+
+	int blocksX = (width + 3) / 4;
+	int blocksY = (height + 3) / 4;
+	const uint8_t *in = data.data();
+	Block block;
+	for(int frame = 0; frame < frames; ++frame)
+		for(int by = 0; by < blocksY; ++by)
+			for(int bx = 0; bx < blocksX; ++bx, in += BLOCK_SIZE)
+			{
+				DecodeBlock(in, block);
+				for(int i = 0; i < 16; ++i)
+				{
+					int x = 4 * bx + i % 4;
+					int y = 4 * by + i / 4;
+					if(x < width && y < height)
+						copy_n(block[i], 4, reinterpret_cast<uint8_t *>(image.Begin(y, frame) + x));
+				}
+			}
+}
+
+
+
+// Free the compressed data.
+void CompressedImage::Clear()
+{
+	data.clear();
+	data.shrink_to_fit();
+	width = 0;
+	height = 0;
+	frames = 0;
+}
@@ -0,0 +1,63 @@
+/* CompressedImage.h
+Copyright (c) 2026 by the Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class ImageBuffer;
+
+
+
+// This class stores the frames of an image in the S3TC DXT5 (also known as BC3)
+// block-compressed format, which graphics cards can sample from directly. Each
+// 4x4 block of pixels is stored in 16 bytes, a quarter of the size of the raw
+// pixel data. The encoding is done in software, so that it can happen in the
+// image-loading worker threads instead of in the graphics driver.
+class CompressedImage {
+public:
+	// The number of bytes each 4x4 block of pixels is stored in.
+	static constexpr std::size_t BLOCK_SIZE = 16;
+
+
+public:
+	CompressedImage() = default;
+	// Compress all the frames of the given image, optionally reducing them to
+	// half their width and height first.
+	explicit CompressedImage(const ImageBuffer &image, bool halfSize = false);
+
+	bool IsEmpty() const;
+	int Width() const;
+	int Height() const;
+	int Frames() const;
+	// The compressed blocks, frame by frame, with the blocks of each frame in
+	// rows from top to bottom.
+	const std::vector<uint8_t> &Data() const;
+
+	// Expand the compressed frames into the given buffer, which must not be
+	// allocated yet. This is what a graphics card does when sampling the image.
+	void Decompress(ImageBuffer &image) const;
+	// Free the compressed data.
+	void Clear();
+
+
+private:
+	int width = 0;
+	int height = 0;
+	int frames = 0;
+	std::vector<uint8_t> data;
+};
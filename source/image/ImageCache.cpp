@@ -0,0 +1,400 @@
+/* ImageCache.cpp
+Copyright (c) 2026 by the Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "ImageCache.h"
+
+#include "../Files.h"
+#include "ImageBuffer.h"
+#include "Mask.h"
+#include "../Point.h"
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <set>
+#include <system_error>
+#include <thread>
+
+using namespace std;
+
+namespace {
+	ImageCache::Mode mode = ImageCache::Mode::OFF;
+
+	// Every cache file starts with this, so that files written by a different
+	// version of the format, or on a machine with a different byte order, are
+	// never used.
+	const uint32_t MAGIC = 0x43495345;
+	const uint32_t VERSION = 1;
+	// Pixel data is aligned to this many bytes from the start of the file.
+	const size_t ALIGNMENT = 16;
+
+	// Get the directory that all the cache files are stored in.
+	filesystem::path Directory()
+	{
+		return filesystem::path(Files::Config()) / "cache" / "images";
+	}
+
+	template <class Type>
+	void Append(string &out, const Type &value)
+	{
+		out.append(reinterpret_cast<const char *>(&value), sizeof(value));
+	}
+
+	// Helper for writing a cache file, keeping track of the offset into it.
+	class Output {
+	public:
+		explicit Output(const filesystem::path &path) : out(path, ios::binary | ios::trunc) {}
+
+		explicit operator bool() const { return static_cast<bool>(out); }
+
+		void Write(const void *data, size_t size)
+		{
+			out.write(static_cast<const char *>(data), size);
+			offset += size;
+		}
+		template <class Type>
+		void Write(const Type &value)
+		{
+			Write(&value, sizeof(value));
+		}
+		void Align()
+		{
+			static const char ZEROS[ALIGNMENT] = {};
+			Write(ZEROS, (ALIGNMENT - offset % ALIGNMENT) % ALIGNMENT);
+		}
+
+	private:
+		ofstream out;
+		size_t offset = 0;
+	};
+
+	// Helper for reading a cache file, keeping track of the offset into it.
+	class Input {
+	public:
+		explicit Input(const filesystem::path &path) : in(path, ios::binary)
+		{
+			error_code error;
+			fileSize = filesystem::file_size(path, error);
+			if(error)
+				in.setstate(ios::failbit);
+		}
+
+		explicit operator bool() const { return static_cast<bool>(in); }
+
+		// Get how many bytes are left to read. Nothing read from the file can
+		// be bigger than this, however corrupt the file is.
+		uint64_t Remaining() const
+		{
+			return offset < fileSize ? fileSize - offset : 0;
+		}
+
+		bool Read(void *data, size_t size)
+		{
+			if(size > Remaining())
+				return false;
+			in.read(static_cast<char *>(data), size);
+			offset += size;
+			return static_cast<bool>(in);
+		}
+		template <class Type>
+		bool Read(Type &value)
+		{
+			return Read(&value, sizeof(value));
+		}
+		bool Align()
+		{
+			char padding[ALIGNMENT];
+			return Read(padding, (ALIGNMENT - offset % ALIGNMENT) % ALIGNMENT);
+		}
+
+	private:
+		ifstream in;
+		uint64_t fileSize = 0;
+		uint64_t offset = 0;
+	};
+
+	void WriteImages(Output &out, const string &key, const ImageBuffer (&buffers)[4], const vector<Mask> &masks)
+	{
+		out.Write(static_cast<uint64_t>(key.size()));
+		out.Write(key.data(), key.size());
+		for(const ImageBuffer &buffer : buffers)
+		{
+			int32_t width = buffer.Width();
+			int32_t height = buffer.Height();
+			int32_t frames = buffer.Frames();
+			uint32_t hasPixels = (buffer.Pixels() != nullptr);
+			out.Write(width);
+			out.Write(height);
+			out.Write(frames);
+			out.Write(hasPixels);
+			out.Align();
+			if(hasPixels)
+				out.Write(buffer.Pixels(), sizeof(uint32_t) * width * height * frames);
+		}
+		out.Write(static_cast<uint32_t>(masks.size()));
+		for(const Mask &mask : masks)
+		{
+			out.Write(static_cast<uint32_t>(mask.Outlines().size()));
+			for(const vector<Point> &outline : mask.Outlines())
+			{
+				out.Write(static_cast<uint32_t>(outline.size()));
+				for(const Point &point : outline)
+				{
+					out.Write(point.X());
+					out.Write(point.Y());
+				}
+			}
+		}
+	}
+
+	bool ReadImages(Input &in, const string &key, ImageBuffer (&buffers)[4], vector<Mask> &masks)
+	{
+		uint64_t keySize = 0;
+		if(!in.Read(keySize) || keySize != key.size())
+			return false;
+		string fileKey(keySize, '\0');
+		if(!in.Read(fileKey.data(), keySize) || fileKey != key)
+			return false;
+
+		for(ImageBuffer &buffer : buffers)
+		{
+			int32_t width = 0;
+			int32_t height = 0;
+			int32_t frames = 0;
+			uint32_t hasPixels = 0;
+			if(!in.Read(width) || !in.Read(height) || !in.Read(frames) || !in.Read(hasPixels) || !in.Align())
+				return false;
+			if(width < 0 || height < 0 || frames < 0)
+				return false;
+			// Check that the file holds all of the pixels before allocating them.
+			const uint64_t pixels = in.Remaining() / sizeof(uint32_t);
+			const uint64_t frameSize = static_cast<uint64_t>(width) * height;
+			if(hasPixels && (!frameSize || !frames || frameSize > pixels
+					|| static_cast<uint64_t>(frames) > pixels / frameSize))
+				return false;
+			buffer.Clear(frames);
+			if(!hasPixels)
+				continue;
+			buffer.Allocate(width, height);
+			if(!buffer.Pixels() || buffer.Width() != width || buffer.Height() != height)
+				return false;
+			if(!in.Read(buffer.Pixels(), sizeof(uint32_t) * width * height * frames))
+				return false;
+		}
+
+		// Each mask, outline, and point takes up some space in the file, so
+		// none of them can be more numerous than the bytes that are left.
+		uint32_t maskCount = 0;
+		if(!in.Read(maskCount) || maskCount > in.Remaining() / sizeof(uint32_t))
+			return false;
+		masks.resize(maskCount);
+		for(Mask &mask : masks)
+		{
+			uint32_t outlineCount = 0;
+			if(!in.Read(outlineCount) || outlineCount > in.Remaining() / sizeof(uint32_t))
+				return false;
+			vector<vector<Point>> outlines(outlineCount);
+			for(vector<Point> &outline : outlines)
+			{
+				uint32_t pointCount = 0;
+				if(!in.Read(pointCount) || pointCount > in.Remaining() / (2 * sizeof(double)))
+					return false;
+				outline.resize(pointCount);
+				for(Point &point : outline)
+					if(!in.Read(point.X()) || !in.Read(point.Y()))
+						return false;
+			}
+			mask.Create(std::move(outlines));
+		}
+		return true;
+	}
+
+	bool IsSame(const ImageBuffer &a, const ImageBuffer &b)
+	{
+		if(a.Frames() != b.Frames() || !a.Pixels() != !b.Pixels())
+			return false;
+		if(!a.Pixels())
+			return true;
+		return a.Width() == b.Width() && a.Height() == b.Height()
+			&& !memcmp(a.Pixels(), b.Pixels(), sizeof(uint32_t) * a.Width() * a.Height() * a.Frames());
+	}
+}
+
+
+
+void ImageCache::SetMode(Mode newMode)
+{
+	mode = newMode;
+}
+
+
+
+ImageCache::Mode ImageCache::GetMode()
+{
+	return mode;
+}
+
+
+
+bool ImageCache::ParseMode(const string &name, Mode &result)
+{
+	if(name == "on")
+		result = Mode::NORMAL;
+	else if(name == "off")
+		result = Mode::OFF;
+	else if(name == "rebuild")
+		result = Mode::REBUILD;
+	else if(name == "verify")
+		result = Mode::VERIFY;
+	else
+		return false;
+	return true;
+}
+
+
+
+// Delete the cached copy of any sprite that is not in the given list, because
+// its images were removed, along with any unfinished cache files.
+void ImageCache::Prune(const set<string> &names)
+{
+	if(mode == Mode::OFF)
+		return;
+
+	const filesystem::path root = Directory();
+	error_code error;
+	vector<filesystem::path> stale;
+	for(auto it = filesystem::recursive_directory_iterator(root, error);
+			!error && it != filesystem::recursive_directory_iterator(); it.increment(error))
+	{
+		if(!it->is_regular_file(error))
+			continue;
+		const filesystem::path &file = it->path();
+		filesystem::path name = file.lexically_relative(root);
+		if(name.extension() == ".cache")
+			name.replace_extension();
+		else
+			name.clear();
+		if(name.empty() || !names.contains(name.generic_string()))
+			stale.push_back(file);
+	}
+	for(const filesystem::path &file : stale)
+		filesystem::remove(file, error);
+}
+
+
+
+ImageCache::ImageCache(const string &name, const vector<filesystem::path> (&sources)[4])
+	: path(Directory() / (name + ".cache"))
+{
+	if(mode == Mode::OFF)
+		return;
+
+	Append(key, MAGIC);
+	Append(key, VERSION);
+	for(const vector<filesystem::path> &list : sources)
+	{
+		Append(key, static_cast<uint32_t>(list.size()));
+		for(const filesystem::path &source : list)
+		{
+			error_code error;
+			auto modified = filesystem::last_write_time(source, error);
+			uintmax_t size = error ? 0 : filesystem::file_size(source, error);
+			if(error)
+			{
+				key.clear();
+				return;
+			}
+			const string sourcePath = source.string();
+			Append(key, static_cast<uint32_t>(sourcePath.size()));
+			key += sourcePath;
+			Append(key, static_cast<int64_t>(modified.time_since_epoch().count()));
+			Append(key, static_cast<uint64_t>(size));
+		}
+	}
+}
+
+
+
+bool ImageCache::Read(ImageBuffer (&buffers)[4], vector<Mask> &masks) const
+{
+	if(key.empty())
+		return false;
+
+	Input in(path);
+	return in && ReadImages(in, key, buffers, masks);
+}
+
+
+
+void ImageCache::Write(const ImageBuffer (&buffers)[4], const vector<Mask> &masks) const
+{
+	if(key.empty())
+		return;
+
+	error_code error;
+	filesystem::create_directories(path.parent_path(), error);
+	if(error)
+		return;
+
+	// Write to a temporary file first, so that a partially written cache file
+	// is never read, even if the game is closed while writing it.
+	filesystem::path temporary = path;
+	temporary += "." + to_string(hash<thread::id>()(this_thread::get_id())) + ".tmp";
+	{
+		Output out(temporary);
+		if(!out)
+			return;
+		WriteImages(out, key, buffers, masks);
+		if(!out)
+		{
+			filesystem::remove(temporary, error);
+			return;
+		}
+	}
+	filesystem::rename(temporary, path, error);
+	if(error)
+		filesystem::remove(temporary, error);
+}
+
+
+
+bool ImageCache::Matches(const ImageBuffer (&buffers)[4], const vector<Mask> &masks) const
+{
+	ImageBuffer cached[4];
+	vector<Mask> cachedMasks;
+	if(!Read(cached, cachedMasks) || cachedMasks.size() != masks.size())
+		return false;
+
+	for(int i = 0; i < 4; ++i)
+		if(!IsSame(buffers[i], cached[i]))
+			return false;
+	for(size_t i = 0; i < masks.size(); ++i)
+	{
+		const auto &outlines = masks[i].Outlines();
+		const auto &cachedOutlines = cachedMasks[i].Outlines();
+		if(outlines.size() != cachedOutlines.size())
+			return false;
+		for(size_t j = 0; j < outlines.size(); ++j)
+		{
+			if(outlines[j].size() != cachedOutlines[j].size())
+				return false;
+			for(size_t k = 0; k < outlines[j].size(); ++k)
+				if(outlines[j][k].X() != cachedOutlines[j][k].X() || outlines[j][k].Y() != cachedOutlines[j][k].Y())
+					return false;
+		}
+	}
+	return true;
+}
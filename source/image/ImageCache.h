@@ -0,0 +1,82 @@
+/* ImageCache.h
+Copyright (c) 2026 by the Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <filesystem>
+#include <set>
+#include <string>
+#include <vector>
+
+class ImageBuffer;
+class Mask;
+
+
+
+// Decoding images and tracing their collision masks is the slowest part of
+// starting the game, so the results can be stored on disk in the user's config
+// directory. Because the decoded images take up much more space than the source
+// images, this is only done if the player turns it on. Each sprite is stored in
+// its own file, along with the path, size, and modification time of every source
+// image it was made from; if any of those change, the sprite is decoded again.
+// The pixel data in each file is aligned so that the file could be memory-mapped.
+class ImageCache {
+public:
+	enum class Mode {
+		// Use cached images that are up to date, and cache any that are not.
+		NORMAL,
+		// Never read or write the cache. This is the default.
+		OFF,
+		// Decode every image, replacing whatever is in the cache.
+		REBUILD,
+		// Decode every image, and report any cached images that do not match.
+		VERIFY
+	};
+
+
+public:
+	// Set how the cache should be used. This should be done before any images are loaded.
+	static void SetMode(Mode mode);
+	static Mode GetMode();
+	// Parse the name of a mode, as given on the command line. Returns false if
+	// the name is not recognized.
+	static bool ParseMode(const std::string &name, Mode &mode);
+	// Delete the cached copy of any sprite that is not in the given list, because
+	// its images were removed, along with any unfinished cache files.
+	static void Prune(const std::set<std::string> &names);
+
+
+public:
+	// Find the cache entry for the sprite with the given name, made from the given
+	// 1x, @2x, swizzle mask, and @2x swizzle mask images.
+	ImageCache(const std::string &name, const std::vector<std::filesystem::path> (&sources)[4]);
+
+	// Fill in the image buffers and masks from the cache. Returns false if there
+	// is no cached copy of these exact source images, in which case they must be
+	// decoded instead.
+	bool Read(ImageBuffer (&buffers)[4], std::vector<Mask> &masks) const;
+	// Store the given decoded images and masks in the cache.
+	void Write(const ImageBuffer (&buffers)[4], const std::vector<Mask> &masks) const;
+	// Check whether the cache holds exactly the given images and masks.
+	bool Matches(const ImageBuffer (&buffers)[4], const std::vector<Mask> &masks) const;
+
+
+private:
+	// The location of this sprite's cache file.
+	std::filesystem::path path;
+	// The description of the source images, which the cache file must start with.
+	// This is empty if the source images could not all be found.
+	std::string key;
+};
@@ -17,13 +17,21 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include "../GameData.h"
 #include "ImageBuffer.h"
+#include "ImageCache.h"
 #include "../Logger.h"
 #include "Mask.h"
 #include "MaskManager.h"
 #include "Sprite.h"
+#include "../TaskQueue.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
 
 using namespace std;
 
@@ -141,6 +149,68 @@ namespace {
 				+ (ignored > 1 ? " frames" : " frame") + " ignored in total).");
 		}
 	}
+
+	// Work that is shared between the thread that loads an image set and tasks
+	// on the task queue. The loading thread takes part in the work itself, so it
+	// never waits on a task that has not started yet, even if all the worker
+	// threads are busy loading other images.
+	class SharedWork {
+	public:
+		SharedWork(size_t count, function<void(size_t)> work)
+			: count(count), remaining(count), work(std::move(work)) {}
+
+		// Do units of work until there are none left to start.
+		void Help() noexcept
+		{
+			while(true)
+			{
+				size_t index = next.fetch_add(1, memory_order_relaxed);
+				if(index >= count)
+					return;
+				try {
+					work(index);
+				}
+				catch(...)
+				{
+					lock_guard<mutex> lock(errorMutex);
+					if(!error)
+						error = current_exception();
+				}
+				remaining.fetch_sub(1, memory_order_release);
+			}
+		}
+
+		// Wait for all the work to finish, and rethrow the first error, if any.
+		void Finish() noexcept(false)
+		{
+			Help();
+			while(remaining.load(memory_order_acquire))
+				this_thread::yield();
+			if(error)
+				rethrow_exception(error);
+		}
+
+	private:
+		const size_t count;
+		atomic<size_t> next = 0;
+		atomic<size_t> remaining;
+		// Once all the work has been started, this function is never called
+		// again, so it may refer to data owned by the loading thread.
+		const function<void(size_t)> work;
+		mutex errorMutex;
+		exception_ptr error;
+	};
+
+	// Call the given function once for every index in [0, count), in parallel.
+	void ForEachParallel(TaskQueue &queue, size_t count, function<void(size_t)> work) noexcept(false)
+	{
+		// Tasks that start after all the work is done still need the shared state.
+		auto shared = make_shared<SharedWork>(count, std::move(work));
+		size_t helpers = min<size_t>(count, max(1u, thread::hardware_concurrency())) - (count > 0);
+		for(size_t i = 0; i < helpers; ++i)
+			queue.Run([shared] { shared->Help(); });
+		shared->Finish();
+	}
 }
 
 
@@ -241,39 +311,13 @@ void ImageSet::ValidateFrames() noexcept(false)
 
 
 // Load all the frames. This should be called in one of the image-loading
-// worker threads. This also generates collision masks if needed.
-void ImageSet::Load() noexcept(false)
+// worker threads. This also generates collision masks if needed. The frames are
+// decoded in parallel, using tasks on the given queue, unless they can be read
+// from the image cache instead.
+void ImageSet::Load(TaskQueue &queue) noexcept(false)
 {
 	assert(framePaths[0].empty() && "should call ValidateFrames before calling Load");
 
-	// Determine how many frames there will be, total. The image buffers will
-	// not actually be allocated until the first image is loaded (at which point
-	// the sprite's dimensions will be known).
-	size_t frames = paths[0].size();
-	buffer[0].Clear(frames);
-	buffer[1].Clear(frames);
-	buffer[2].Clear(frames);
-	buffer[3].Clear(frames);
-
-	// Check whether we need to generate collision masks.
-	bool makeMasks = IsMasked(name);
-	if(makeMasks)
-		masks.resize(frames);
-
-	// Load the 1x sprites first, then the 2x sprites, because they are likely
-	// to be in separate locations on the disk. Create masks if needed.
-	for(size_t i = 0; i < frames; ++i)
-	{
-		if(!buffer[0].Read(paths[0][i], i))
-			Logger::LogError("Failed to read image data for \"" + name + "\" frame #" + to_string(i));
-		else if(makeMasks)
-		{
-			masks[i].Create(buffer[0], i);
-			if(!masks[i].IsLoaded())
-				Logger::LogError("Failed to create collision mask for \"" + name + "\" frame #" + to_string(i));
-		}
-	}
-
 	auto FillSwizzleMasks = [&](vector<filesystem::path> &toFill, unsigned int intendedSize) {
 		if(toFill.size() == 1 && intendedSize > 1)
 			for(unsigned int i = toFill.size(); i < intendedSize; i++)
@@ -284,21 +328,26 @@ void ImageSet::Load() noexcept(false)
 	FillSwizzleMasks(paths[2], paths[0].size());
 	FillSwizzleMasks(paths[3], paths[0].size());
 
+	// Check whether we need to generate collision masks.
+	bool makeMasks = IsMasked(name);
+	size_t frames = paths[0].size();
 
-	auto LoadSprites = [&](vector<filesystem::path> &toLoad, ImageBuffer &buffer, const string &specifier) {
-		for(size_t i = 0; i < frames && i < toLoad.size(); ++i)
-			if(!buffer.Read(toLoad[i], i))
-			{
-				Logger::LogError("Removing " + specifier + " frames for \"" + name + "\" due to read error");
-				buffer.Clear();
-				break;
-			}
-	};
-	// Now, load the mask and 2x sprites, if they exist. Because the number of 1x frames
-	// is definitive, don't load any frames beyond the size of the 1x list.
-	LoadSprites(paths[1], buffer[1], "@2x");
-	LoadSprites(paths[2], buffer[2], "mask");
-	LoadSprites(paths[3], buffer[3], "@2x mask");
+	ImageCache cache(name, paths);
+	ImageCache::Mode cacheMode = ImageCache::GetMode();
+	bool isCached = (cacheMode == ImageCache::Mode::NORMAL && cache.Read(buffer, masks)
+		&& static_cast<size_t>(buffer[0].Frames()) == frames && masks.size() == (makeMasks ? frames : 0));
+	// Only cache images that loaded without errors, so that the errors are
+	// reported every time the game is started until they are fixed.
+	if(!isCached && Decode(queue, makeMasks) && cacheMode != ImageCache::Mode::OFF)
+	{
+		if(cacheMode != ImageCache::Mode::VERIFY)
+			cache.Write(buffer, masks);
+		else if(!cache.Matches(buffer, masks))
+		{
+			Logger::LogError("Image cache for \"" + name + "\" was missing or out of date.");
+			cache.Write(buffer, masks);
+		}
+	}
 
 	// Warn about a "high-profile" image that will be blurry due to rendering at 50% scale.
 	bool willBlur = (buffer[0].Width() & 1) || (buffer[0].Height() & 1);
@@ -309,6 +358,88 @@ void ImageSet::Load() noexcept(false)
 	))
 		Logger::LogError("Warning: image \"" + name + "\" will be blurry since width and/or height are not even ("
 			+ to_string(buffer[0].Width()) + "x" + to_string(buffer[0].Height()) + ").");
+
+	// Compress the frames here, if possible, rather than when they are uploaded.
+	for(int i = 0; i < 4; ++i)
+		Sprite::Compress(buffer[i], compressed[i]);
+}
+
+
+
+// Decode all the frames from their image files, and trace their collision masks
+// if needed. Returns false if any errors were encountered.
+bool ImageSet::Decode(TaskQueue &queue, bool makeMasks) noexcept(false)
+{
+	// Determine how many frames there will be, total. The image buffers will
+	// not actually be allocated until the first image is loaded (at which point
+	// the sprite's dimensions will be known).
+	size_t frames = paths[0].size();
+	buffer[0].Clear(frames);
+	buffer[1].Clear(frames);
+	buffer[2].Clear(frames);
+	buffer[3].Clear(frames);
+
+	masks.clear();
+	if(makeMasks)
+		masks.resize(frames);
+
+	// Whether each frame of each buffer was read successfully. Because the number
+	// of 1x frames is definitive, don't load any frames beyond the size of the 1x list.
+	vector<char> isRead[4];
+	auto ReadFrame = [&](int index, size_t frame) {
+		isRead[index][frame] = buffer[index].Read(paths[index][frame], frame);
+		if(!index && isRead[index][frame] && makeMasks)
+			masks[frame].Create(buffer[0], frame);
+	};
+
+	// The first frame that is read determines the size of each buffer, so each
+	// buffer's frames are read one at a time until it has been allocated. Read
+	// the 1x sprites first, then the 2x sprites, because they are likely to be
+	// in separate locations on the disk.
+	vector<pair<int, size_t>> toRead;
+	for(int index = 0; index < 4; ++index)
+	{
+		size_t count = min(frames, paths[index].size());
+		isRead[index].resize(count);
+		size_t frame = 0;
+		for( ; frame < count && !buffer[index].Pixels(); ++frame)
+		{
+			ReadFrame(index, frame);
+			// Any @2x or mask frame that cannot be read means none of them are used.
+			if(index && !isRead[index][frame])
+			{
+				count = 0;
+				break;
+			}
+		}
+		for( ; frame < count; ++frame)
+			toRead.emplace_back(index, frame);
+	}
+	// Decode the rest of the frames, and trace their collision masks, in parallel.
+	// Each frame is stored in its own part of the buffer.
+	ForEachParallel(queue, toRead.size(), [&toRead, &ReadFrame](size_t i)
+		{
+			ReadFrame(toRead[i].first, toRead[i].second);
+		});
+
+	bool hasErrors = false;
+	for(size_t i = 0; i < frames; ++i)
+	{
+		hasErrors |= !isRead[0][i] || (makeMasks && !masks[i].IsLoaded());
+		if(!isRead[0][i])
+			Logger::LogError("Failed to read image data for \"" + name + "\" frame #" + to_string(i));
+		else if(makeMasks && !masks[i].IsLoaded())
+			Logger::LogError("Failed to create collision mask for \"" + name + "\" frame #" + to_string(i));
+	}
+	static const string SPECIFIERS[4] = {"", "@2x", "mask", "@2x mask"};
+	for(int index = 1; index < 4; ++index)
+		if(find(isRead[index].begin(), isRead[index].end(), false) != isRead[index].end())
+		{
+			Logger::LogError("Removing " + SPECIFIERS[index] + " frames for \"" + name + "\" due to read error");
+			buffer[index].Clear();
+			hasErrors = true;
+		}
+	return !hasErrors;
 }
 
 
@@ -320,14 +451,18 @@ void ImageSet::Upload(Sprite *sprite, bool enableUpload)
 {
 	// Clear all the buffers if we are not uploading the image data.
 	if(!enableUpload)
+	{
 		for(ImageBuffer &it : buffer)
 			it.Clear();
+		for(CompressedImage &it : compressed)
+			it.Clear();
+	}
 
 	// Load the frames (this will clear the buffers).
-	sprite->AddFrames(buffer[0], false);
-	sprite->AddFrames(buffer[1], true);
-	sprite->AddSwizzleMaskFrames(buffer[2], false);
-	sprite->AddSwizzleMaskFrames(buffer[3], true);
+	sprite->AddFrames(buffer[0], compressed[0], false);
+	sprite->AddFrames(buffer[1], compressed[1], true);
+	sprite->AddSwizzleMaskFrames(buffer[2], compressed[2], false);
+	sprite->AddSwizzleMaskFrames(buffer[3], compressed[3], true);
 
 	GameData::GetMaskManager().SetMasks(sprite, std::move(masks));
 	masks.clear();
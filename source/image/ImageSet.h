@@ -15,6 +15,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #pragma once
 
+#include "CompressedImage.h"
 #include "ImageBuffer.h"
 
 #include <filesystem>
@@ -24,6 +25,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 class Mask;
 class Sprite;
+class TaskQueue;
 
 
 
@@ -57,14 +59,22 @@ public:
 	// Reduce all given paths to frame images into a sequence of consecutive frames.
 	void ValidateFrames() noexcept(false);
 	// Load all the frames. This should be called in one of the image-loading
-	// worker threads. This also generates collision masks if needed.
-	void Load() noexcept(false);
+	// worker threads. This also generates collision masks if needed. The frames
+	// are decoded in parallel, using tasks on the given queue, unless they can be
+	// read from the image cache instead.
+	void Load(TaskQueue &queue) noexcept(false);
 	// Create the sprite and optionally upload the image data to the GPU. After this is
 	// called, the internal image buffers and mask vector will be cleared, but
 	// the paths are saved in case the sprite needs to be loaded again.
 	void Upload(Sprite *sprite, bool enableUpload);
 
 
+private:
+	// Decode all the frames from their image files, and trace their collision masks
+	// if needed. Returns false if any errors were encountered.
+	bool Decode(TaskQueue &queue, bool makeMasks) noexcept(false);
+
+
 private:
 	// Name of the sprite that will be initialized with these images.
 	std::string name;
@@ -74,5 +84,7 @@ private:
 	std::vector<std::filesystem::path> paths[4];
 	// Data loaded from the images:
 	ImageBuffer buffer[4];
+	// The same data, if it is to be uploaded in a compressed format:
+	CompressedImage compressed[4];
 	std::vector<Mask> masks;
 };
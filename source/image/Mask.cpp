@@ -310,6 +310,17 @@ void Mask::Create(const ImageBuffer &image, int frame)
 
 
 
+// Construct a mask from outlines that were previously created from an image.
+void Mask::Create(vector<vector<Point>> &&outlines)
+{
+	this->outlines = std::move(outlines);
+	radius = 0.;
+	for(const vector<Point> &outline : this->outlines)
+		radius = max(radius, ComputeRadius(outline));
+}
+
+
+
 // Check whether a mask was successfully generated from the image.
 bool Mask::IsLoaded() const
 {
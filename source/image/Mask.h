@@ -33,6 +33,8 @@ class Mask {
 public:
 	// Construct a mask from the alpha channel of an RGBA-formatted image.
 	void Create(const ImageBuffer &image, int frame = 0);
+	// Construct a mask from outlines that were previously created from an image.
+	void Create(std::vector<std::vector<Point>> &&outlines);
 
 	// Check whether a mask was successfully generated from the image.
 	bool IsLoaded() const;
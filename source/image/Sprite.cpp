@@ -15,6 +15,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include "Sprite.h"
 
+#include "CompressedImage.h"
 #include "ImageBuffer.h"
 #include "../Preferences.h"
 #include "../Screen.h"
@@ -23,14 +24,30 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include <SDL2/SDL.h>
 
 #include <algorithm>
+#include <atomic>
+
+// OpenGL ES headers do not define the S3TC formats, even if the extension is present.
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT5_EXT
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+#endif
 
 using namespace std;
 
 namespace {
-	void AddBuffer(ImageBuffer &buffer, uint32_t *target)
+	atomic<bool> useCompression = false;
+
+	// Check whether this sprite is large enough to require size reduction.
+	bool ShouldReduce(const ImageBuffer &buffer)
+	{
+		return Preferences::Has("Reduce large graphics") && buffer.Width() * buffer.Height() >= 1000000;
+	}
+
+	void AddBuffer(ImageBuffer &buffer, CompressedImage &compressed, uint32_t *target)
 	{
-		// Check whether this sprite is large enough to require size reduction.
-		if(Preferences::Has("Reduce large graphics") && buffer.Width() * buffer.Height() >= 1000000)
+		// Frames that were loaded before the OpenGL context was created could not
+		// be compressed in advance, so do it now.
+		Sprite::Compress(buffer, compressed);
+		if(compressed.IsEmpty() && ShouldReduce(buffer))
 			buffer.ShrinkToHalfSize();
 
 		// Upload the images as a single array texture.
@@ -44,20 +61,54 @@ namespace {
 		glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
 
 		// Upload the image data.
-		glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_RGBA8, // target, mipmap level, internal format,
-			buffer.Width(), buffer.Height(), buffer.Frames(), // width, height, depth,
-			0, GL_RGBA, GL_UNSIGNED_BYTE, buffer.Pixels()); // border, input format, data type, data.
+		if(!compressed.IsEmpty())
+			glCompressedTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_COMPRESSED_RGBA_S3TC_DXT5_EXT, // target, mipmap level, format,
+				compressed.Width(), compressed.Height(), compressed.Frames(), // width, height, depth,
+				0, compressed.Data().size(), compressed.Data().data()); // border, data size, data.
+		else
+			glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_RGBA8, // target, mipmap level, internal format,
+				buffer.Width(), buffer.Height(), buffer.Frames(), // width, height, depth,
+				0, GL_RGBA, GL_UNSIGNED_BYTE, buffer.Pixels()); // border, input format, data type, data.
 
 		// Unbind the texture.
 		glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
 
 		// Free the ImageBuffer memory.
 		buffer.Clear();
+		compressed.Clear();
 	}
 }
 
 
 
+void Sprite::SetCompression(bool enabled)
+{
+	useCompression = enabled;
+}
+
+
+
+bool Sprite::UseCompression()
+{
+	return useCompression;
+}
+
+
+
+// If compression is enabled, compress the given frames into the format they
+// will be uploaded in. This is safe to do in a worker thread. The buffer's
+// pixels are freed afterwards, but its dimensions are kept.
+void Sprite::Compress(ImageBuffer &buffer, CompressedImage &compressed)
+{
+	if(!useCompression || !buffer.Pixels())
+		return;
+
+	compressed = CompressedImage(buffer, ShouldReduce(buffer));
+	buffer.Clear(buffer.Frames());
+}
+
+
+
 Sprite::Sprite(const string &name)
 	: name(name)
 {
@@ -72,8 +123,10 @@ const string &Sprite::Name() const
 
 
 
-// Add the given frames, optionally uploading them. The given buffer will be cleared afterwards.
-void Sprite::AddFrames(ImageBuffer &buffer, bool is2x)
+// Add the given frames, optionally uploading them. If the frames have already
+// been compressed, the compressed copy is uploaded instead of the buffer.
+// Both will be cleared afterwards.
+void Sprite::AddFrames(ImageBuffer &buffer, CompressedImage &compressed, bool is2x)
 {
 	// If this is the 1x image, its dimensions determine the sprite's size.
 	if(!is2x)
@@ -84,20 +137,20 @@ void Sprite::AddFrames(ImageBuffer &buffer, bool is2x)
 	}
 
 	// Only non-empty buffers need to be added to the sprite.
-	if(buffer.Pixels())
-		AddBuffer(buffer, &texture[is2x]);
+	if(buffer.Pixels() || !compressed.IsEmpty())
+		AddBuffer(buffer, compressed, &texture[is2x]);
 }
 
 
 
-// Upload the given frames. The given buffer will be cleared afterwards.
-void Sprite::AddSwizzleMaskFrames(ImageBuffer &buffer, bool is2x)
+// Upload the given frames, or their compressed copy. Both will be cleared afterwards.
+void Sprite::AddSwizzleMaskFrames(ImageBuffer &buffer, CompressedImage &compressed, bool is2x)
 {
 	// Do nothing if the buffer is empty.
-	if(!buffer.Pixels())
+	if(!buffer.Pixels() && compressed.IsEmpty())
 		return;
 
-	AddBuffer(buffer, &swizzleMask[is2x]);
+	AddBuffer(buffer, compressed, &swizzleMask[is2x]);
 }
 
 
@@ -20,6 +20,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include <cstdint>
 #include <string>
 
+class CompressedImage;
 class ImageBuffer;
 
 
@@ -29,14 +30,28 @@ class ImageBuffer;
 // not be as efficient as sprite sheets, but with modern graphics cards it will
 // not matter much and it makes working with the graphics a lot simpler.
 class Sprite {
+public:
+	// Set whether sprites should be uploaded in a compressed format. This is
+	// decided once the OpenGL context has been created, because it depends on
+	// whether the graphics card supports it.
+	static void SetCompression(bool enabled);
+	static bool UseCompression();
+	// If compression is enabled, compress the given frames into the format they
+	// will be uploaded in. This is safe to do in a worker thread. The buffer's
+	// pixels are freed afterwards, but its dimensions are kept.
+	static void Compress(ImageBuffer &buffer, CompressedImage &compressed);
+
+
 public:
 	explicit Sprite(const std::string &name = "");
 
 	const std::string &Name() const;
 
-	// Add the given frames, optionally uploading them. The given buffer will be cleared afterwards.
-	void AddFrames(ImageBuffer &buffer, bool is2x);
-	void AddSwizzleMaskFrames(ImageBuffer &buffer, bool is2x);
+	// Add the given frames, optionally uploading them. If the frames have already
+	// been compressed, the compressed copy is uploaded instead of the buffer.
+	// Both will be cleared afterwards.
+	void AddFrames(ImageBuffer &buffer, CompressedImage &compressed, bool is2x);
+	void AddSwizzleMaskFrames(ImageBuffer &buffer, CompressedImage &compressed, bool is2x);
 	// Free up all textures loaded for this sprite.
 	void Unload();
 
@@ -21,37 +21,49 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "ConversationPanel.h"
 #include "DataFile.h"
 #include "DataNode.h"
+#include "DataWriter.h"
 #include "Engine.h"
+#include "File.h"
 #include "Files.h"
 #include "text/Font.h"
+#include "text/Format.h"
 #include "FrameTimer.h"
 #include "GameData.h"
 #include "GameLoadingPanel.h"
 #include "GameWindow.h"
+#include "image/ImageCache.h"
 #include "Logger.h"
 #include "MainPanel.h"
+#include "image/MaskManager.h"
 #include "MenuPanel.h"
 #include "Panel.h"
 #include "PlayerInfo.h"
 #include "Plugins.h"
 #include "Preferences.h"
 #include "PrintData.h"
+#include "Profiler.h"
+#include "Random.h"
+#include "Recording.h"
 #include "Screen.h"
+#include "Simulation.h"
 #include "image/SpriteSet.h"
 #include "SpriteShader.h"
 #include "TaskQueue.h"
 #include "test/Test.h"
 #include "test/TestContext.h"
+#include "test/TestData.h"
 #include "UI.h"
 
 #include <chrono>
 #include <iostream>
 #include <map>
+#include <sstream>
 
 #include <cassert>
 #include <future>
 #include <exception>
 #include <string>
+#include <thread>
 
 #ifdef _WIN32
 #define STRICT
@@ -69,6 +81,10 @@ void GameLoop(PlayerInfo &player, TaskQueue &queue, const Conversation &conversa
 	const string &testToRun, bool debugMode);
 Conversation LoadConversation();
 void PrintTestsTable();
+bool ConvertSave(const string &from, const string &to);
+void LoadWithoutWindow(bool debugMode);
+bool RunSimulation(const string &savePath, int steps, bool debugMode);
+bool RunReplay(const string &recordingPath, bool debugMode);
 #ifdef _WIN32
 void InitConsole();
 #endif
@@ -90,6 +106,11 @@ int main(int argc, char *argv[])
 	bool printData = false;
 	bool noTestMute = false;
 	string testToRunName;
+	string convertFrom;
+	string convertTo;
+	string simulateSave;
+	int simulateSteps = 0;
+	string replayPath;
 
 	// Whether the game has encountered errors while loading.
 	bool hasErrors = false;
@@ -126,16 +147,56 @@ int main(int argc, char *argv[])
 			printTests = true;
 		else if(arg == "--nomute")
 			noTestMute = true;
+		else if(arg == "--image-cache" && *++it)
+		{
+			ImageCache::Mode mode;
+			if(!ImageCache::ParseMode(*it, mode))
+			{
+				cerr << "Unrecognized image cache mode \"" << *it << "\"." << endl;
+				return 1;
+			}
+			ImageCache::SetMode(mode);
+		}
+		else if(arg == "--convert-save" && it[1] && it[2])
+		{
+			convertFrom = *++it;
+			convertTo = *++it;
+		}
+		else if(arg == "--simulate" && it[1] && it[2])
+		{
+			simulateSave = *++it;
+			string steps = *++it;
+			if(steps.empty() || steps.size() > 9 || steps.find_first_not_of("0123456789") != string::npos)
+			{
+				cerr << "Invalid number of steps to simulate: \"" << steps << "\"." << endl;
+				return 1;
+			}
+			simulateSteps = stoi(steps);
+		}
+		else if(arg == "--record" && *++it)
+			Recording::SetPath(*it);
+		else if(arg == "--replay" && *++it)
+			replayPath = *it;
 	}
 	printData = PrintData::IsPrintDataArgument(argv);
 	Files::Init(argv);
 
+	if(!convertFrom.empty())
+		return ConvertSave(convertFrom, convertTo) ? 0 : 1;
+
 	// Whether we are running an integration test.
 	const bool isTesting = !testToRunName.empty();
+	// Whether the game is running without a window.
+	const bool isSimulating = !simulateSave.empty() || !replayPath.empty();
 	try {
 		// Load plugin preferences before game data if any.
 		Plugins::LoadSettings();
 
+		if(!replayPath.empty())
+			return RunReplay(replayPath, debugMode) ? 0 : 1;
+		if(isSimulating)
+			return RunSimulation(simulateSave, simulateSteps, debugMode) ? 0 : 1;
+
 		TaskQueue queue;
 
 		// Begin loading the game data.
@@ -214,6 +275,8 @@ int main(int argc, char *argv[])
 
 		// This is the main loop where all the action begins.
 		GameLoop(player, queue, conversation, testToRunName, debugMode);
+		// Write out the flight that was being recorded when the game was quit.
+		Recording::End();
 	}
 	catch(Test::known_failure_tag)
 	{
@@ -222,7 +285,7 @@ int main(int argc, char *argv[])
 	catch(const exception &error)
 	{
 		Audio::Quit();
-		GameWindow::ExitWithError(error.what(), !isTesting);
+		GameWindow::ExitWithError(error.what(), !isTesting && !isSimulating);
 		return 1;
 	}
 
@@ -492,6 +555,11 @@ void PrintHelp()
 	cerr << "    --tests: print table of available tests, then exit." << endl;
 	cerr << "    --test <name>: run given test from resources directory." << endl;
 	cerr << "    --nomute: don't mute the game while running tests." << endl;
+	cerr << "    --image-cache <mode>: cache decoded images \"on\", \"off\" (default), \"rebuild\" or \"verify\"." << endl;
+	cerr << "    --convert-save <input> <output>: convert a saved game between the text and compact formats." << endl;
+	cerr << "    --simulate <save> <steps>: run a saved game for that many steps without a window." << endl;
+	cerr << "    --record <file>: record the player's input during each flight, for replaying it later." << endl;
+	cerr << "    --replay <file>: replay a recorded flight without a window, checking that it plays out the same." << endl;
 	PrintData::Help();
 	cerr << endl;
 	cerr << "Report bugs to: <https://github.com/endless-sky/endless-sky/issues>" << endl;
@@ -549,6 +617,207 @@ Conversation LoadConversation()
 
 
 
+// Convert a saved game, or any other data file, from text to the compact binary
+// encoding, or from the compact encoding back to text.
+bool ConvertSave(const string &from, const string &to)
+{
+	string data = Files::Read(from);
+	if(data.empty())
+	{
+		cerr << "Unable to read \"" << from << "\"." << endl;
+		return false;
+	}
+
+	istringstream in(data);
+	DataFile file(in);
+	// Corrupt compact data is not loaded at all, and an empty file has nothing
+	// in it to convert.
+	if(file.begin() == file.end())
+	{
+		cerr << "Unable to parse \"" << from << "\"." << endl;
+		return false;
+	}
+
+	string converted;
+	if(DataFile::IsCompact(data))
+	{
+		DataWriter out;
+		for(const DataNode &node : file)
+			out.Write(node);
+		converted = out.SaveToString();
+	}
+	else
+		converted = DataWriter::Compact(file);
+
+	File output(to, true);
+	if(!output || fwrite(converted.data(), 1, converted.size(), output) != converted.size()
+		|| !output.Close())
+	{
+		cerr << "Unable to write \"" << to << "\"." << endl;
+		return false;
+	}
+	return true;
+}
+
+
+
+// Load the game data and the preferences, without creating a window.
+void LoadWithoutWindow(bool debugMode)
+{
+	TaskQueue queue;
+	GameData::BeginLoad(queue, false, debugMode, true).wait();
+	// The sprites are still needed for their sizes and collision masks, and
+	// they are finished on this thread, as the loading panel would do.
+	while(!GameData::IsLoaded())
+	{
+		queue.ProcessSyncTasks();
+		this_thread::sleep_for(chrono::milliseconds(1));
+	}
+	GameData::GetMaskManager().ScaleMasks();
+	GameData::FinishLoading();
+
+	Preferences::Load();
+}
+
+
+
+// Load the given saved game, take off, and run the game engine for the given
+// number of steps as fast as possible, without a window, graphics, or sound.
+bool RunSimulation(const string &savePath, int steps, bool debugMode)
+{
+	LoadWithoutWindow(debugMode);
+	DataFile globalConditions(Files::Config() + "global conditions.txt");
+	for(const DataNode &node : globalConditions)
+		if(node.Token(0) == "conditions")
+			GameData::GlobalConditions().Load(node);
+
+	// Instead of a save file, the name of a "savegame" test data set can be
+	// given, such as one of the benchmark scenarios.
+	string path = savePath;
+	const TestData *testData = GameData::TestDataSets().Find(savePath);
+	if(testData)
+	{
+		if(!testData->Inject())
+		{
+			cerr << "Unable to inject the test data \"" << savePath << "\"." << endl;
+			return false;
+		}
+		path = Files::Saves() + savePath + ".txt";
+	}
+
+	PlayerInfo player;
+	player.Load(path);
+	if(!player.IsLoaded() || !player.Flagship())
+	{
+		cerr << "Unable to load a pilot with a flagship from \"" << path << "\"." << endl;
+		return false;
+	}
+	// Missions that are accepted during the simulation may try to autosave,
+	// which would overwrite the pilot's real autosave.
+	player.DisableSaving();
+	// Loading a pilot reseeds the random number generator from the clock, so
+	// seed it afterwards to make repeated runs of the same save comparable.
+	// Once the flight begins, recording it reseeds the generators of the engine
+	// and its worker threads in every step as well.
+	Random::Seed(0);
+	Recording recording;
+
+	Simulation simulation(player, &recording);
+	FrameTimer timer;
+	while(simulation.Steps() < steps && !simulation.IsDone())
+		simulation.Step();
+	simulation.GetEngine().Wait();
+	double seconds = timer.Time();
+
+	cout << "Simulated " << simulation.Steps() << " steps in " << seconds << " seconds ("
+		<< simulation.Steps() / seconds << " steps per second)." << endl;
+	if(simulation.IsDone())
+		cout << "The simulation ended early because the player " << (player.IsDead() ? "died." : "could not take off.")
+			<< endl;
+	// Runs of the same scenario should always end in the same state.
+	if(recording.Steps())
+		cout << "State after the last step: " << recording.Hash(recording.Steps() - 1) << endl;
+
+	// Break down the time spent calculating each step by the phase it was spent in.
+	const Profiler &profiler = simulation.GetEngine().GetProfiler();
+	if(profiler.Steps())
+	{
+		const double total = profiler.Time();
+		auto PrintPhase = [&profiler, total](const string &name, double time) -> void
+		{
+			cout << "    " << name << ": " << Format::Decimal(1000. * time / profiler.Steps(), 3) << " ms per step ("
+				<< Format::Decimal(100. * time / total, 1) << "%)" << endl;
+		};
+		cout << "Calculation time per step, by phase:" << endl;
+		double other = total;
+		for(int i = 0; i < static_cast<int>(Profiler::Zone::COUNT); ++i)
+		{
+			const Profiler::Zone zone = static_cast<Profiler::Zone>(i);
+			PrintPhase(Profiler::Name(zone), profiler.Time(zone));
+			other -= profiler.Time(zone);
+		}
+		PrintPhase("other", other);
+		PrintPhase("total", total);
+	}
+	return true;
+}
+
+
+
+// Replay a flight that was recorded with "--record" as fast as possible,
+// without a window, graphics, or sound, and check that every step of it plays
+// out exactly the same as it did when it was recorded.
+bool RunReplay(const string &recordingPath, bool debugMode)
+{
+	Recording recording;
+	if(!recording.Load(recordingPath))
+	{
+		cerr << "Unable to read the recording \"" << recordingPath << "\"." << endl;
+		return false;
+	}
+
+	LoadWithoutWindow(debugMode);
+	istringstream conditions(recording.GlobalConditions());
+	DataFile globalConditions(conditions);
+	for(const DataNode &node : globalConditions)
+		if(node.Token(0) == "conditions")
+			GameData::GlobalConditions().Load(node);
+
+	// A pilot can only be loaded from a file, so write the saved game that the
+	// flight started from to a temporary one.
+	const string path = Files::Config() + "replay.txt";
+	Files::Write(path, recording.SavedGame());
+	PlayerInfo player;
+	player.Load(path);
+	Files::Delete(path);
+	player.DisableSaving();
+	if(!player.IsLoaded() || !player.Flagship() || !player.GetPlanet())
+	{
+		cerr << "The recording \"" << recordingPath << "\" does not contain a landed pilot." << endl;
+		return false;
+	}
+
+	Simulation simulation(player, recording);
+	const Engine &engine = simulation.GetEngine();
+	FrameTimer timer;
+	while(engine.RecordedSteps() < recording.Steps() && !simulation.IsDone())
+		simulation.Step();
+	simulation.GetEngine().Wait();
+	double seconds = timer.Time();
+
+	cout << "Replayed " << engine.RecordedSteps() << " of " << recording.Steps() << " steps in " << seconds
+		<< " seconds (" << engine.RecordedSteps() / seconds << " steps per second)." << endl;
+	if(engine.Divergence() >= 0)
+	{
+		cout << "The replay diverged from the recording in step " << engine.Divergence() << "." << endl;
+		return false;
+	}
+	cout << "Every step matched the recording." << endl;
+	return true;
+}
+
+
+
 // This prints out the list of tests that are available and their status
 // (active/missing feature/known failure)..
 void PrintTestsTable()
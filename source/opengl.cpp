@@ -25,7 +25,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include <cstring>
 
-#if defined(ES_GLES) || defined(_WIN32)
+#if defined(ES_GLES) || defined(_WIN32) || defined(__APPLE__)
 namespace {
 	bool HasOpenGLExtension(const char *name)
 	{
@@ -62,3 +62,14 @@ bool OpenGL::HasAdaptiveVSyncSupport()
 	return GLX_EXT_swap_control_tear;
 #endif
 }
+
+
+
+bool OpenGL::HasTextureCompressionSupport()
+{
+#if defined(ES_GLES) || defined(__APPLE__)
+	return HasOpenGLExtension("GL_EXT_texture_compression_s3tc");
+#else
+	return GLEW_EXT_texture_compression_s3tc;
+#endif
+}
@@ -31,4 +31,5 @@ class OpenGL
 {
 public:
 	static bool HasAdaptiveVSyncSupport();
+	static bool HasTextureCompressionSupport();
 };
@@ -0,0 +1,53 @@
+set(BENCHMARK_CONFIG "${BENCHMARK_CONFIGS}/${scenario}")
+
+# Clean the config folder of the benchmark.
+file(REMOVE_RECURSE "${BENCHMARK_CONFIG}")
+file(COPY "${ES_CONFIG}" DESTINATION "${BENCHMARK_CONFIGS}")
+file(RENAME "${BENCHMARK_CONFIGS}/config" "${BENCHMARK_CONFIG}")
+
+# Run the scenario without a window, for the given number of steps.
+execute_process(COMMAND "${ES}" --config "${BENCHMARK_CONFIG}" --resources "${RESOURCE_PATH}"
+		--simulate "${scenario}" "${STEPS}"
+	OUTPUT_VARIABLE BENCHMARK_OUTPUT
+	ERROR_VARIABLE BENCHMARK_OUTPUT
+	RESULT_VARIABLE BENCHMARK_RESULT)
+
+string(STRIP "${BENCHMARK_OUTPUT}" BENCHMARK_OUTPUT_STRIPPED)
+if(BENCHMARK_RESULT)
+	message(FATAL_ERROR "Benchmark failed with '${BENCHMARK_RESULT}':\n${BENCHMARK_OUTPUT_STRIPPED}")
+endif()
+message("${scenario}:\n${BENCHMARK_OUTPUT_STRIPPED}")
+
+# A scenario that ends early did not measure what it was meant to.
+if(NOT BENCHMARK_OUTPUT MATCHES "Simulated ${STEPS} steps in [^ ]+ seconds \\(([0-9]+)[.0-9]* steps per second\\)")
+	message(FATAL_ERROR "The scenario did not run for all ${STEPS} steps.")
+endif()
+# Whole steps per second are precise enough to compare.
+set(SPEED "${CMAKE_MATCH_1}")
+
+# Compare the speed with the baseline of this scenario, if there is one. Speeds depend on the machine, so
+# the baselines are not part of the repository; they are given in the ES_BENCHMARK_BASELINES folder.
+if(NOT BENCHMARK_BASELINES)
+	message("Skipped: there is no baseline to compare this scenario against, "
+		"because ES_BENCHMARK_BASELINES is not set.")
+	return()
+endif()
+set(BASELINE_FILE "${BENCHMARK_BASELINES}/${scenario}.txt")
+if(BENCHMARK_UPDATE_BASELINES)
+	file(WRITE "${BASELINE_FILE}" "${SPEED}\n")
+	message("Saved ${SPEED} steps per second as the baseline of this scenario in \"${BASELINE_FILE}\".")
+	return()
+endif()
+if(NOT EXISTS "${BASELINE_FILE}")
+	message("Skipped: there is no baseline to compare this scenario against in \"${BASELINE_FILE}\".")
+	return()
+endif()
+file(STRINGS "${BASELINE_FILE}" BASELINE LIMIT_COUNT 1)
+# CMake's math() only handles integers, so compare the speeds as percentages of the baseline.
+math(EXPR SPEED_PERCENT "${SPEED} * 100")
+math(EXPR MIN_PERCENT "${BASELINE} * (100 - ${BENCHMARK_TOLERANCE})")
+if(SPEED_PERCENT LESS MIN_PERCENT)
+	message(FATAL_ERROR "The scenario ran at ${SPEED} steps per second, more than ${BENCHMARK_TOLERANCE}% "
+		"slower than the baseline of ${BASELINE} steps per second in \"${BASELINE_FILE}\".")
+endif()
+message("The baseline of this scenario is ${BASELINE} steps per second.")
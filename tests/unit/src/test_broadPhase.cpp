@@ -0,0 +1,115 @@
+/* test_broadPhase.cpp
+Copyright (c) 2026 by the Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "es-test.hpp"
+
+// Include only the tested class's header.
+#include "../../../source/BroadPhase.h"
+
+// ... and any system includes needed for the test file.
+#include <random>
+#include <vector>
+
+namespace { // test namespace
+
+// #region mock data
+
+// The packed positions and radii of the objects in one grid cell.
+class Cell {
+public:
+	Cell(unsigned count, std::mt19937 &gen)
+	{
+		std::uniform_real_distribution<float> position(-600.f, 600.f);
+		std::uniform_real_distribution<float> size(0.f, 150.f);
+		for(unsigned i = 0; i < count; ++i)
+		{
+			x.push_back(position(gen));
+			y.push_back(position(gen));
+			radius.push_back(size(gen));
+		}
+	}
+
+	unsigned Count() const { return x.size(); }
+
+	std::vector<float> x;
+	std::vector<float> y;
+	std::vector<float> radius;
+};
+
+// #endregion mock data
+
+
+
+// #region unit tests
+SCENARIO( "Finding the objects a line might touch", "[BroadPhase]" ) {
+	GIVEN( "a cell with a few objects in it" ) {
+		std::vector<float> x = {0.f, 100.f, 200.f, 300.f, 400.f};
+		std::vector<float> y = {0.f, 50.f, -20.f, 300.f, 0.f};
+		std::vector<float> radius = {10.f, 10.f, 25.f, 10.f, 10.f};
+		std::vector<unsigned> result;
+		WHEN( "a line passes through some of them" ) {
+			BroadPhase::Line(x.data(), y.data(), radius.data(), x.size(), -50.f, 0.f, 300.f, 0.f, result);
+			THEN( "only those are candidates, in order" ) {
+				CHECK( result == std::vector<unsigned>{0, 2} );
+			}
+		}
+		WHEN( "a ring passes through some of them" ) {
+			BroadPhase::Ring(x.data(), y.data(), radius.data(), x.size(), 0.f, 0.f, 390.f, 420.f, result);
+			THEN( "only those are candidates, in order" ) {
+				CHECK( result == std::vector<unsigned>{3, 4} );
+			}
+		}
+	}
+}
+
+SCENARIO( "Testing several objects at once", "[BroadPhase]" ) {
+	std::mt19937 gen(12345);
+	std::uniform_real_distribution<float> coordinate(-1000.f, 1000.f);
+	std::uniform_real_distribution<float> distance(0.f, 800.f);
+	std::vector<unsigned> vectorized;
+	std::vector<unsigned> plain;
+
+	// Use cells of every size up to a few times the number of objects that are
+	// tested at once, so that the objects left over at the end are tested too.
+	for(unsigned count = 0; count < 19; ++count)
+	{
+		const Cell cell(count, gen);
+		for(int query = 0; query < 200; ++query)
+		{
+			const float x = coordinate(gen);
+			const float y = coordinate(gen);
+			const float dx = (query % 10 ? coordinate(gen) : 0.f);
+			const float dy = (query % 10 ? coordinate(gen) : 0.f);
+			BroadPhase::Line(cell.x.data(), cell.y.data(), cell.radius.data(), cell.Count(),
+				x, y, dx, dy, vectorized);
+			BroadPhase::Line(cell.x.data(), cell.y.data(), cell.radius.data(), cell.Count(),
+				x, y, dx, dy, plain, false);
+			CHECK( vectorized == plain );
+
+			const float inner = (query % 3 ? distance(gen) : 0.f);
+			const float outer = inner + distance(gen);
+			BroadPhase::Ring(cell.x.data(), cell.y.data(), cell.radius.data(), cell.Count(),
+				x, y, inner, outer, vectorized);
+			BroadPhase::Ring(cell.x.data(), cell.y.data(), cell.radius.data(), cell.Count(),
+				x, y, inner, outer, plain, false);
+			CHECK( vectorized == plain );
+		}
+	}
+}
+// #endregion unit tests
+
+
+
+} // test namespace
@@ -0,0 +1,161 @@
+/* test_compressedImage.cpp
+Copyright (c) 2026 by the Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "es-test.hpp"
+
+// Include only the tested class's header.
+#include "../../../source/image/CompressedImage.h"
+
+// Include the class that holds uncompressed images.
+#include "../../../source/image/ImageBuffer.h"
+
+// ... and any system includes needed for the test file.
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+
+namespace { // test namespace
+
+// #region mock data
+
+// Fill an image with pixels given by a function of the position and frame.
+void Fill(ImageBuffer &image, int width, int height,
+	const std::function<void(int x, int y, int frame, uint8_t *pixel)> &color)
+{
+	image.Allocate(width, height);
+	for(int frame = 0; frame < image.Frames(); ++frame)
+		for(int y = 0; y < height; ++y)
+			for(int x = 0; x < width; ++x)
+				color(x, y, frame, reinterpret_cast<uint8_t *>(image.Begin(y, frame) + x));
+}
+
+// Find the largest difference between any channel of any pixel of two images.
+int MaxError(const ImageBuffer &a, const ImageBuffer &b)
+{
+	int error = 0;
+	for(int frame = 0; frame < a.Frames(); ++frame)
+		for(int y = 0; y < a.Height(); ++y)
+			for(int x = 0; x < a.Width(); ++x)
+			{
+				auto first = reinterpret_cast<const uint8_t *>(a.Begin(y, frame) + x);
+				auto second = reinterpret_cast<const uint8_t *>(b.Begin(y, frame) + x);
+				for(int c = 0; c < 4; ++c)
+					error = std::max(error, std::abs(first[c] - second[c]));
+			}
+	return error;
+}
+
+// #endregion mock data
+
+
+
+// #region unit tests
+SCENARIO( "Compressing an image", "[CompressedImage]" ) {
+	GIVEN( "an empty image" ) {
+		ImageBuffer image;
+		CompressedImage compressed(image);
+		THEN( "the compressed image is empty" ) {
+			CHECK( compressed.IsEmpty() );
+			CHECK( compressed.Data().empty() );
+		}
+	}
+	GIVEN( "an image with frames of a single color each" ) {
+		ImageBuffer image(3);
+		// Each of these colors can be represented exactly with 5, 6, and 5 bits.
+		const uint8_t COLORS[3][4] = {{255, 0, 0, 255}, {0, 255, 255, 128}, {0, 0, 0, 0}};
+		Fill(image, 8, 8, [&COLORS](int, int, int frame, uint8_t *pixel) {
+			std::copy_n(COLORS[frame], 4, pixel);
+		});
+		CompressedImage compressed(image);
+		WHEN( "it is decompressed" ) {
+			ImageBuffer result;
+			compressed.Decompress(result);
+			THEN( "every pixel is exactly the same" ) {
+				REQUIRE( result.Width() == 8 );
+				REQUIRE( result.Height() == 8 );
+				REQUIRE( result.Frames() == 3 );
+				CHECK( MaxError(image, result) == 0 );
+			}
+		}
+	}
+	GIVEN( "an image with smooth gradients" ) {
+		ImageBuffer image(2);
+		Fill(image, 64, 32, [](int x, int y, int frame, uint8_t *pixel) {
+			pixel[0] = 4 * x;
+			pixel[1] = 8 * y;
+			pixel[2] = frame ? 255 - 4 * x : 128;
+			pixel[3] = 2 * (x + y);
+		});
+		CompressedImage compressed(image);
+		THEN( "it takes a quarter of the memory" ) {
+			CHECK( compressed.Width() == 64 );
+			CHECK( compressed.Height() == 32 );
+			CHECK( compressed.Frames() == 2 );
+			CHECK( compressed.Data().size() * 4 == sizeof(uint32_t) * 64 * 32 * 2 );
+		}
+		WHEN( "it is decompressed" ) {
+			ImageBuffer result;
+			compressed.Decompress(result);
+			THEN( "every pixel is close to the original" ) {
+				CHECK( MaxError(image, result) <= 16 );
+			}
+		}
+	}
+	GIVEN( "an image whose size is not a multiple of four" ) {
+		ImageBuffer image;
+		Fill(image, 5, 7, [](int x, int y, int, uint8_t *pixel) {
+			pixel[0] = pixel[1] = pixel[2] = pixel[3] = (x + y) % 2 ? 255 : 0;
+		});
+		CompressedImage compressed(image);
+		THEN( "the edge blocks are stored whole" ) {
+			CHECK( compressed.Data().size() == 2 * 2 * CompressedImage::BLOCK_SIZE );
+		}
+		WHEN( "it is decompressed" ) {
+			ImageBuffer result;
+			compressed.Decompress(result);
+			THEN( "it has the original size and pixels" ) {
+				REQUIRE( result.Width() == 5 );
+				REQUIRE( result.Height() == 7 );
+				CHECK( MaxError(image, result) == 0 );
+			}
+		}
+	}
+	GIVEN( "an image that is reduced to half size" ) {
+		ImageBuffer image;
+		Fill(image, 16, 8, [](int x, int, int, uint8_t *pixel) {
+			pixel[0] = pixel[1] = pixel[2] = pixel[3] = x % 2 ? 200 : 100;
+		});
+		CompressedImage compressed(image, true);
+		WHEN( "it is decompressed" ) {
+			ImageBuffer result;
+			compressed.Decompress(result);
+			THEN( "each pixel is the average of four original pixels" ) {
+				REQUIRE( result.Width() == 8 );
+				REQUIRE( result.Height() == 4 );
+				ImageBuffer expected;
+				Fill(expected, 8, 4, [](int, int, int, uint8_t *pixel) {
+					pixel[0] = pixel[1] = pixel[2] = pixel[3] = 150;
+				});
+				CHECK( MaxError(expected, result) <= 4 );
+			}
+		}
+	}
+}
+// #endregion unit tests
+
+
+
+} // test namespace
@@ -131,6 +131,31 @@ SCENARIO( "Determining if condition requirements are met", "[ConditionSet][Usage
 			}
 		}
 	}
+	GIVEN( "a set comparing arithmetic on conditions and numbers" ) {
+		std::string mathExpressions = "and\n"
+			"\t\"test: apples\" + \"test: pears\" * 2 == 11\n"
+			"\t( \"test: apples\" - 1 ) * 3 >= 12\n"
+			"\tnot \"test: oranges\"";
+		const auto mathSet = ConditionSet{AsDataNode(mathExpressions)};
+		REQUIRE_FALSE( mathSet.IsEmpty() );
+
+		AND_GIVEN( "conditions that satisfy it" ) {
+			auto store = ConditionsStore{{"test: apples", 5}, {"test: pears", 3}};
+			THEN( "the ConditionSet is satisfied" ) {
+				REQUIRE( mathSet.Test(store) );
+			}
+			AND_WHEN( "the conditions are changed" ) {
+				store.Set("test: oranges", 1);
+				THEN( "the ConditionSet is no longer satisfied" ) {
+					REQUIRE_FALSE( mathSet.Test(store) );
+					store.Erase("test: oranges");
+					REQUIRE( mathSet.Test(store) );
+					store.Set("test: pears", 4);
+					REQUIRE_FALSE( mathSet.Test(store) );
+				}
+			}
+		}
+	}
 }
 
 SCENARIO( "Applying changes to conditions", "[ConditionSet][Usage]" ) {
@@ -185,4 +210,28 @@ SCENARIO( "Applying changes to conditions", "[ConditionSet][Usage]" ) {
 
 
 
+// #region benchmarks
+#ifdef CATCH_CONFIG_ENABLE_BENCHMARKING
+TEST_CASE( "Benchmark ConditionSet::Test", "[!benchmark][conditionset]" ) {
+	// As in the game, the condition set is loaded before the player's conditions.
+	std::string expressions = "and\n"
+		"\thas \"benchmark: condition 101\"\n"
+		"\tnot \"benchmark: condition 19998\"\n"
+		"\tnot \"benchmark: missing\"\n"
+		"\t\"benchmark: condition 7\" + \"benchmark: condition 8\" * 2 < 10";
+	const auto conditionSet = ConditionSet{AsDataNode(expressions)};
+	// A store about the size of a late-game player's conditions.
+	auto store = ConditionsStore{};
+	for(int i = 0; i < 20000; ++i)
+		store.Set("benchmark: condition " + std::to_string(i), i % 3);
+
+	BENCHMARK( "ConditionSet::Test()" ) {
+		return conditionSet.Test(store);
+	};
+}
+#endif
+// #endregion benchmarks
+
+
+
 } // test namespace
@@ -21,6 +21,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 // ... and any system includes needed for the test file.
 #include <map>
 #include <string>
+#include <vector>
 
 
 
@@ -629,9 +630,182 @@ SCENARIO( "Providing multiple derived conditions", "[ConditionStore][DerivedMult
 	}
 }
 
+SCENARIO( "Setting and erasing many conditions", "[ConditionStore][ConditionSetting]" )
+{
+	GIVEN( "A store with thousands of conditions" )
+	{
+		auto store = ConditionsStore();
+		for(int i = 0; i < 5000; ++i)
+			REQUIRE( store.Set("condition " + std::to_string(i), i + 1) );
+		REQUIRE( store.PrimariesSize() == 5000 );
+		WHEN( "every other condition is erased" )
+		{
+			for(int i = 0; i < 5000; i += 2)
+				REQUIRE( store.Erase("condition " + std::to_string(i)) );
+			THEN( "only the erased conditions are gone" )
+			{
+				REQUIRE( store.PrimariesSize() == 2500 );
+				for(int i = 0; i < 5000; ++i)
+					REQUIRE( store.Get("condition " + std::to_string(i)) == (i % 2 ? i + 1 : 0) );
+			}
+		}
+	}
+}
+
+SCENARIO( "Getting conditions through handles", "[ConditionStore][Handles]" )
+{
+	GIVEN( "A handle for a condition that is not in the store yet" )
+	{
+		const auto handle = ConditionsStore::Handle("handle test: primary");
+		auto store = ConditionsStore();
+		REQUIRE( handle.Name() == "handle test: primary" );
+		REQUIRE( store.Get(handle) == 0 );
+		WHEN( "the condition is set and changed" )
+		{
+			REQUIRE( store.Set("handle test: primary", 10) );
+			THEN( "the handle finds the new value" )
+			{
+				REQUIRE( store.Get(handle) == 10 );
+				store["handle test: primary"] += 5;
+				REQUIRE( store.Get(handle) == 15 );
+			}
+		}
+		WHEN( "the condition is set and then erased" )
+		{
+			REQUIRE( store.Set("handle test: primary", 10) );
+			REQUIRE( store.Erase("handle test: primary") );
+			THEN( "the handle finds no value" )
+			{
+				REQUIRE( store.Get(handle) == 0 );
+				REQUIRE( store.Set("handle test: primary", 20) );
+				REQUIRE( store.Get(handle) == 20 );
+			}
+		}
+	}
+	GIVEN( "A store with conditions set before the handles were created" )
+	{
+		auto store = ConditionsStore{ { "handle test: early", 30 }, { "handle test: other", 40 } };
+		const auto early = ConditionsStore::Handle("handle test: early");
+		const auto missing = ConditionsStore::Handle("handle test: missing");
+		THEN( "the handles find the same values as the names" )
+		{
+			REQUIRE( store.Get(early) == 30 );
+			REQUIRE( store.Get(missing) == 0 );
+		}
+		WHEN( "the store is changed after the handles were created" )
+		{
+			REQUIRE( store.Set("handle test: other", 50) );
+			THEN( "the handles still find the same values as the names" )
+			{
+				REQUIRE( store.Get(early) == 30 );
+				REQUIRE( store.Get(missing) == 0 );
+				REQUIRE( store.Set("handle test: missing", 60) );
+				REQUIRE( store.Get(missing) == 60 );
+			}
+		}
+	}
+	GIVEN( "Handles for conditions that come from providers" )
+	{
+		const auto before = ConditionsStore::Handle("handle ships: before");
+		const auto named = ConditionsStore::Handle("handle named");
+		auto store = ConditionsStore{ { "handle test: other", 1 } };
+		auto mockProvPrefix = MockConditionsProvider();
+		mockProvPrefix.SetRWPrefixProvider(store, "handle ships: ");
+		auto mockProvNamed = MockConditionsProvider();
+		mockProvNamed.SetRWNamedProvider(store, "handle named");
+		mockProvPrefix.values["handle ships: before"] = 70;
+		mockProvPrefix.values["handle ships: after"] = 80;
+		mockProvNamed.values["handle named"] = 90;
+		const auto after = ConditionsStore::Handle("handle ships: after");
+		THEN( "the handles get their values from the providers" )
+		{
+			REQUIRE( store.Get(before) == 70 );
+			REQUIRE( store.Get(after) == 80 );
+			REQUIRE( store.Get(named) == 90 );
+			REQUIRE( store.Set("handle test: other", 2) );
+			REQUIRE( store.Get(before) == 70 );
+			REQUIRE( store.Get(after) == 80 );
+			REQUIRE( store.Get(named) == 90 );
+		}
+		THEN( "derived conditions are not counted as primary conditions" )
+		{
+			REQUIRE( store.Set("handle test: other", 2) );
+			REQUIRE( store.PrimariesSize() == 1 );
+		}
+	}
+}
+
 
 // #endregion unit tests
 
 
 
+// #region benchmarks
+#ifdef CATCH_CONFIG_ENABLE_BENCHMARKING
+// Build a set of condition names like those in a late-game save: several
+// conditions for each of thousands of missions, plus events and visited places.
+std::vector<std::string> LateGameConditionNames()
+{
+	std::vector<std::string> names;
+	for(int i = 0; i < 6000; ++i)
+	{
+		const std::string mission = "Mission " + std::to_string(i * 7919 % 6000);
+		for(const char *suffix : {": offered", ": accepted", ": done", ": failed"})
+			names.push_back(mission + suffix);
+	}
+	for(int i = 0; i < 3000; ++i)
+		names.push_back("event: happened " + std::to_string(i));
+	for(int i = 0; i < 2000; ++i)
+	{
+		names.push_back("visited planet: Planet " + std::to_string(i));
+		names.push_back("visited system: System " + std::to_string(i));
+	}
+	return names;
+}
+
+TEST_CASE( "Benchmark ConditionsStore with a late-game set of conditions", "[!benchmark][conditionsStore]" ) {
+	const std::vector<std::string> names = LateGameConditionNames();
+	std::vector<std::string> missing;
+	for(int i = 0; i < 1000; ++i)
+		missing.push_back("Mission " + std::to_string(i) + ": never offered");
+
+	auto store = ConditionsStore();
+	std::map<std::string, int64_t> values;
+	for(size_t i = 0; i < names.size(); ++i)
+	{
+		store.Set(names[i], i);
+		values[names[i]] = i;
+	}
+	auto mockProvider = MockConditionsProvider();
+	mockProvider.SetRWPrefixProvider(store, "reputation: ");
+	for(int i = 0; i < 50; ++i)
+		mockProvider.values["reputation: Government " + std::to_string(i)] = i;
+
+	BENCHMARK( "ConditionsStore::Get(), set", i ) {
+		return store.Get(names[i % names.size()]);
+	};
+	BENCHMARK( "std::map::find(), set", i ) {
+		return values.find(names[i % names.size()])->second;
+	};
+	BENCHMARK( "ConditionsStore::Get(), not set", i ) {
+		return store.Get(missing[i % missing.size()]);
+	};
+	BENCHMARK( "ConditionsStore::Get(), derived", i ) {
+		return store.Get("reputation: Government " + std::to_string(i % 50));
+	};
+	BENCHMARK( "ConditionsStore::Add(), set", i ) {
+		return store.Add(names[i % names.size()], 1);
+	};
+	BENCHMARK( "ConditionsStore::Set(), filling" ) {
+		auto filled = ConditionsStore();
+		for(const std::string &name : names)
+			filled.Set(name, 1);
+		return filled.PrimariesSize();
+	};
+}
+#endif
+// #endregion benchmarks
+
+
+
 } // test namespace
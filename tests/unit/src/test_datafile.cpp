@@ -20,6 +20,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 // Include a helper functions.
 #include "datanode-factory.h"
+#include "../../../source/DataWriter.h"
 #include "../../../source/text/Format.h"
 #include "output-capture.hpp"
 
@@ -53,6 +54,79 @@ std::vector<std::string> Split(const std::string &str)
 	return result;
 }
 
+// Write the nodes of the given file as text.
+std::string ToText(const DataFile &file)
+{
+	DataWriter out;
+	for(const DataNode &node : file)
+		out.Write(node);
+	return out.SaveToString();
+}
+
+// Load a file from the given text or compact data.
+std::string RoundTrip(const std::string &data)
+{
+	std::istringstream stream(data);
+	return ToText(DataFile(stream));
+}
+
+// Create a large saved game, with a long log, many conditions, and a big fleet.
+std::string LargeSave()
+{
+	DataWriter out;
+	out.Write("pilot", "Test", "Pilot");
+	out.Write("date", 16, 11, 3013);
+	for(int i = 0; i < 200; ++i)
+	{
+		out.Write("ship", "Bactrian");
+		out.BeginChild();
+		{
+			out.Write("name", "Test Ship " + std::to_string(i));
+			out.Write("attributes");
+			out.BeginChild();
+			{
+				out.Write("category", "Heavy Warship");
+				out.Write("hull", 17000 + i);
+				out.Write("shields", 21000.5);
+			}
+			out.EndChild();
+			out.Write("outfits");
+			out.BeginChild();
+			{
+				for(int j = 0; j < 40; ++j)
+					out.Write("Outfit " + std::to_string(j), j % 3 + 1);
+			}
+			out.EndChild();
+			out.Write("position", i * 12.25, i * -3.5);
+		}
+		out.EndChild();
+	}
+	out.Write("conditions");
+	out.BeginChild();
+	{
+		for(int i = 0; i < 5000; ++i)
+			out.Write("condition " + std::to_string(i), i);
+	}
+	out.EndChild();
+	for(int i = 0; i < 2000; ++i)
+		out.Write("visited", "System " + std::to_string(i));
+	out.Write("logbook");
+	out.BeginChild();
+	{
+		for(int i = 0; i < 1000; ++i)
+		{
+			out.Write(i % 28 + 1, i % 12 + 1, 3013 + i / 365);
+			out.BeginChild();
+			{
+				out.Write("You met someone interesting on a planet, and had a long conversation about it.");
+			}
+			out.EndChild();
+		}
+	}
+	out.EndChild();
+	return out.SaveToString();
+}
+
 // #endregion mock data
 
 
@@ -103,6 +177,32 @@ node2 hi
 	}
 }
 
+SCENARIO( "Tracing nodes in a DataFile with many siblings", "[DataFile]" ) {
+	OutputSink sink(std::cerr);
+
+	GIVEN( "A parent with many children, each with its own child" ) {
+		std::string text = "parent\n";
+		for(int i = 0; i < 100; ++i)
+			text += "\tchild " + std::to_string(i) + "\n\t\tgrand\n";
+		std::istringstream stream(text);
+		const DataFile root(stream);
+
+		THEN( "every node can trace back to the root" ) {
+			REQUIRE( std::distance(root.begin(), root.end()) == 1 );
+			const DataNode &parent = *root.begin();
+			REQUIRE( std::distance(parent.begin(), parent.end()) == 100 );
+			const DataNode &grand = *std::prev(parent.end())->begin();
+			CHECK( grand.PrintTrace() == 6 );
+
+			const auto trace = Split(sink.Flush());
+			REQUIRE( trace.size() == 3 );
+			CHECK( trace[0].find("parent") != std::string::npos );
+			CHECK( trace[1].find("child 99") != std::string::npos );
+			CHECK( trace[2].find("grand") != std::string::npos );
+		}
+	}
+}
+
 SCENARIO( "Loading a DataFile with missing quotes", "[DataFile]" ) {
 	OutputSink sink(std::cerr);
 
@@ -288,8 +388,135 @@ now with
 		}
 	}
 }
+
+SCENARIO( "Loading a DataFile from the compact encoding", "[DataFile]" ) {
+	OutputSink sink(std::cerr);
+
+	GIVEN( "A file with nested nodes, quoted tokens, and comments" ) {
+		std::istringstream stream(R"(
+# comment
+pilot Jane Doe
+"reputation with"
+	Republic 12.5
+	"Free Worlds" -3
+ship Shuttle
+	name `The "Best" Ship`
+	outfits
+		# another comment
+		"Hyperdrive"
+		Hyperdrive 2
+note "" "with space"
+)");
+		const DataFile text(stream);
+		const std::string compact = DataWriter::Compact(text);
+
+		THEN( "the compact data is recognized as such" ) {
+			CHECK( DataFile::IsCompact(compact) );
+			CHECK_FALSE( DataFile::IsCompact(ToText(text)) );
+		}
+		THEN( "loading it gives the same nodes as the text" ) {
+			std::istringstream compactStream(compact);
+			const DataFile loaded(compactStream);
+			REQUIRE( std::distance(loaded.begin(), loaded.end()) == 4 );
+			const DataNode &ship = *std::next(loaded.begin(), 2);
+			CHECK( ship.Token(1) == "Shuttle" );
+			REQUIRE( std::distance(ship.begin(), ship.end()) == 2 );
+			CHECK( ship.begin()->Token(1) == "The \"Best\" Ship" );
+			CHECK( ToText(loaded) == ToText(text) );
+			CHECK( sink.Flush().empty() );
+
+			std::next(ship.begin())->begin()->PrintTrace();
+			const auto trace = Split(sink.Flush());
+			REQUIRE( trace.size() == 3 );
+			CHECK( trace[0].find("ship Shuttle") != std::string::npos );
+			CHECK( trace[1].find("outfits") != std::string::npos );
+			CHECK( trace[2].find("Hyperdrive") != std::string::npos );
+		}
+		THEN( "text written by DataWriter round-trips exactly" ) {
+			const std::string written = ToText(text);
+			CHECK( RoundTrip(compact) == written );
+			CHECK( RoundTrip(written) == written );
+		}
+	}
+	GIVEN( "Compact data that has been cut short" ) {
+		std::istringstream stream("root\n\tchild 1 2 3\nsecond\n");
+		const std::string compact = DataWriter::Compact(DataFile(stream));
+		std::istringstream compactStream(compact.substr(0, compact.size() - 4));
+		const DataFile loaded(compactStream);
+
+		THEN( "no nodes are loaded and an error is printed" ) {
+			CHECK( loaded.begin() == loaded.end() );
+			CHECK( sink.Flush().find("Error: Compact data is corrupt:") != std::string::npos );
+		}
+	}
+	GIVEN( "Compact data with nodes nested far too deeply" ) {
+		// One root node named "a", then each node has one child that is also named "a".
+		std::string compact(DataFile::COMPACT_SIGNATURE);
+		compact += std::string("\x01\x01\x00\x01" "a", 5);
+		for(int i = 0; i < 100000; ++i)
+			compact += "\x01\x01\x01";
+		compact += '\0';
+		std::istringstream compactStream(compact);
+		const DataFile loaded(compactStream);
+
+		THEN( "no nodes are loaded and an error is printed" ) {
+			CHECK( loaded.begin() == loaded.end() );
+			CHECK( sink.Flush().find("Error: Compact data is corrupt:") != std::string::npos );
+		}
+	}
+	GIVEN( "Only the start of a compact file" ) {
+		std::istringstream stream("summary\n\tpilot Bobbi Bughunter\nship Shuttle\n\tname Flagship\n");
+		const std::string compact = DataWriter::Compact(DataFile(stream));
+		DataFile loaded;
+		loaded.LoadFirstNode(compact.substr(0, compact.size() - 4));
+
+		THEN( "its first node is loaded without any errors" ) {
+			REQUIRE( std::distance(loaded.begin(), loaded.end()) == 1 );
+			CHECK( loaded.begin()->Token(0) == "summary" );
+			REQUIRE( loaded.begin()->HasChildren() );
+			CHECK( loaded.begin()->begin()->Token(2) == "Bughunter" );
+			CHECK( sink.Flush().empty() );
+		}
+	}
+	GIVEN( "A large saved game" ) {
+		const std::string text = LargeSave();
+		std::istringstream stream(text);
+		const std::string compact = DataWriter::Compact(DataFile(stream));
+
+		THEN( "the compact encoding is smaller and round-trips" ) {
+			CHECK( compact.size() < text.size() * 2 / 3 );
+			CHECK( RoundTrip(compact) == text );
+		}
+	}
+}
 // #endregion unit tests
 
+// #region benchmarks
+#ifdef CATCH_CONFIG_ENABLE_BENCHMARKING
+TEST_CASE( "Benchmark loading and saving a large saved game", "[!benchmark][DataFile]" ) {
+	const std::string text = LargeSave();
+	std::istringstream textStream(text);
+	const DataFile file(textStream);
+	const std::string compact = DataWriter::Compact(file);
+
+	BENCHMARK( "Load text" ) {
+		std::istringstream stream(text);
+		return DataFile(stream);
+	};
+	BENCHMARK( "Load compact" ) {
+		std::istringstream stream(compact);
+		return DataFile(stream);
+	};
+	BENCHMARK( "Save text" ) {
+		return ToText(file);
+	};
+	BENCHMARK( "Save compact" ) {
+		return DataWriter::Compact(file);
+	};
+}
+#endif
+// #endregion benchmarks
+
 
 
 } // test namespace
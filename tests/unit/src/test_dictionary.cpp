@@ -18,6 +18,9 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 // Include only the tested class's header.
 #include "../../../source/Dictionary.h"
 
+// Include the known attribute names it can look up directly.
+#include "../../../source/Attribute.h"
+
 // ... and any system includes needed for the test file.
 #include <string>
 #include <vector>
@@ -51,6 +54,52 @@ SCENARIO( "A Dictionary instance is being used", "[dictionary]") {
 			CHECK( std::distance(dict.begin(), dict.end()) == 2 );
 		}
 	}
+	GIVEN( "a dictionary with known and unknown attributes" ) {
+		Dictionary dict;
+		dict["thrust"] = 10.;
+		dict["some data-defined attribute"] = 1.;
+		dict["shield generation"] = 2.;
+		THEN( "known attributes are found by slot" ) {
+			CHECK( dict.Get(Attribute("thrust")) == 10. );
+			CHECK( dict.Get(Attribute("shield generation")) == 2. );
+			CHECK( dict.Get(Attribute("heat dissipation")) == 0. );
+		}
+		WHEN( "keys are inserted before the known attributes" ) {
+			dict["a"] = 3.;
+			dict["heat dissipation"] = 4.;
+			dict["zzz"] = 5.;
+			THEN( "the known attributes are still found" ) {
+				CHECK( dict.Get(Attribute("thrust")) == 10. );
+				CHECK( dict.Get(Attribute("shield generation")) == 2. );
+				CHECK( dict.Get(Attribute("heat dissipation")) == 4. );
+				CHECK( dict.Get(Attribute("energy capacity")) == 0. );
+			}
+		}
+		WHEN( "the dictionary is copied" ) {
+			Dictionary copy = dict;
+			copy["thrust"] = 20.;
+			THEN( "the copy has its own values" ) {
+				CHECK( copy.Get(Attribute("thrust")) == 20. );
+				CHECK( dict.Get(Attribute("thrust")) == 10. );
+			}
+		}
+	}
+}
+
+SCENARIO( "Looking up known attributes", "[dictionary][attribute]") {
+	GIVEN( "a known attribute" ) {
+		constexpr Attribute thrust("thrust");
+		THEN( "its name and slot match" ) {
+			CHECK( std::string(thrust.Name()) == "thrust" );
+			CHECK( Attribute::Find("thrust") == thrust.Slot() );
+			CHECK( thrust.Slot() < Attribute::Count() );
+		}
+	}
+	GIVEN( "a data-defined attribute" ) {
+		THEN( "it has no slot" ) {
+			CHECK( Attribute::Find("some data-defined attribute") == Attribute::NONE );
+		}
+	}
 }
 
 // #region benchmarks
@@ -76,6 +125,20 @@ TEST_CASE( "Benchmark Dictionary::Get", "[!benchmark][dictionary]" ) {
 		return dict.Get(strings[i % SIZE]);
 	};
 }
+
+TEST_CASE( "Benchmark Dictionary::Get with a known attribute", "[!benchmark][dictionary]" ) {
+	Dictionary dict;
+	for(int i = 0; i < 100; ++i)
+		dict[std::to_string(i) + " attribute"] = i;
+	dict["thrust"] = 1.;
+
+	BENCHMARK( "Dictionary::Get(const char *)" ) {
+		return dict.Get("thrust");
+	};
+	BENCHMARK( "Dictionary::Get(const Attribute &)" ) {
+		return dict.Get(Attribute("thrust"));
+	};
+}
 #endif
 // #endregion benchmarks
 
@@ -0,0 +1,239 @@
+/* test_economy.cpp
+Copyright (c) 2026 by the Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "es-test.hpp"
+
+// Include only the tested class's header.
+#include "../../../source/Economy.h"
+
+// Include a helper for creating well-formed DataNodes.
+#include "datanode-factory.h"
+
+// ... and any system includes needed for the test file.
+#include "../../../source/Planet.h"
+#include "../../../source/Random.h"
+#include "../../../source/System.h"
+
+#include <cmath>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace { // test namespace
+
+// #region mock data
+
+std::vector<Trade::Commodity> MakeCommodities(int count)
+{
+	std::vector<Trade::Commodity> commodities;
+	for(int i = 0; i < count; ++i)
+		commodities.push_back(Trade::Commodity{"Commodity " + std::to_string(i), 100, 1000, {}});
+	return commodities;
+}
+
+// Create a rectangular galaxy in which each system is linked to its neighbors
+// and trades in every commodity.
+void MakeGalaxy(Set<System> &systems, Set<Planet> &planets, int width, int height, int commodities)
+{
+	std::vector<System *> grid;
+	for(int i = 0; i < width * height; ++i)
+	{
+		std::string text = "system \"System " + std::to_string(i) + "\"\n";
+		for(int c = 0; c < commodities; ++c)
+			text += "\ttrade \"Commodity " + std::to_string(c) + "\" " + std::to_string(100 + 10 * c + i % 7) + "\n";
+		grid.push_back(systems.Get("System " + std::to_string(i)));
+		grid.back()->Load(AsDataNode(text), planets);
+	}
+	for(int y = 0; y < height; ++y)
+		for(int x = 0; x < width; ++x)
+		{
+			if(x + 1 < width)
+				grid[y * width + x]->Link(grid[y * width + x + 1]);
+			if(y + 1 < height)
+				grid[y * width + x]->Link(grid[(y + 1) * width + x]);
+		}
+}
+
+// The economy step as it used to be done, looking up each commodity in each
+// system and its neighbors by name, to compare the Economy class against.
+class MapEconomy {
+public:
+	MapEconomy(const Set<System> &systems, const std::vector<Trade::Commodity> &commodities)
+		: systems(systems), commodities(commodities) {}
+
+	void Step()
+	{
+		for(const Trade::Commodity &commodity : commodities)
+		{
+			auto &supply = supplies[commodity.name];
+			auto &exports = exported[commodity.name];
+			for(const auto &it : systems)
+				if(it.second.BasePrices().count(commodity.name))
+				{
+					double &tons = supply[&it.second];
+					exports[&it.second] = .10 * tons;
+					tons = tons * .89 + Random::Normal() * 2000.;
+				}
+			for(const auto &it : systems)
+				if(it.second.BasePrices().count(commodity.name))
+					for(const System *neighbor : it.second.Links())
+						supply[&it.second] += exports[neighbor] / neighbor->Links().size();
+		}
+	}
+
+	double Supply(const System &system, const std::string &commodity) const
+	{
+		auto it = supplies.find(commodity);
+		if(it == supplies.end())
+			return 0.;
+		auto sit = it->second.find(&system);
+		return sit == it->second.end() ? 0. : sit->second;
+	}
+
+
+private:
+	const Set<System> &systems;
+	const std::vector<Trade::Commodity> &commodities;
+	std::map<std::string, std::map<const System *, double>> supplies;
+	std::map<std::string, std::map<const System *, double>> exported;
+};
+
+// #endregion mock data
+
+
+
+// #region unit tests
+SCENARIO( "Looking up the trade of a system", "[Economy]" ) {
+	Set<Planet> planets;
+	Set<System> systems;
+	System *first = systems.Get("First");
+	first->Load(AsDataNode("system First\n\ttrade Food 300\n\ttrade Relics 900"), planets);
+	System *second = systems.Get("Second");
+	second->Load(AsDataNode("system Second\n\ttrade Food 200"), planets);
+	const auto commodities = MakeCommodities(0);
+
+	Economy economy;
+	economy.Update(systems, commodities);
+
+	GIVEN( "no supply" ) {
+		THEN( "each system trades at its base prices" ) {
+			CHECK( economy.Price(*first, "Food") == 300 );
+			CHECK( economy.Price(*first, "Relics") == 900 );
+			CHECK( economy.Price(*second, "Food") == 200 );
+			CHECK( economy.Supply(*first, "Food") == 0. );
+		}
+		THEN( "there is no price for goods a system does not trade in" ) {
+			CHECK( economy.Price(*second, "Relics") == 0 );
+			CHECK( economy.Price(*first, "Fuel") == 0 );
+		}
+	}
+	WHEN( "the supply of a commodity is set" ) {
+		economy.SetSupply(*first, "Food", 20000.);
+		THEN( "only that price drops" ) {
+			CHECK( economy.Supply(*first, "Food") == 20000. );
+			CHECK( economy.Price(*first, "Food") == 300 + static_cast<int>(-100. * std::erf(1.)) );
+			CHECK( economy.Price(*first, "Relics") == 900 );
+			CHECK( economy.Price(*second, "Food") == 200 );
+		}
+		AND_WHEN( "the economy is reset" ) {
+			economy.Reset();
+			THEN( "the supply and price are restored" ) {
+				CHECK( economy.Supply(*first, "Food") == 0. );
+				CHECK( economy.Price(*first, "Food") == 300 );
+			}
+		}
+		AND_WHEN( "the systems change" ) {
+			second->Load(AsDataNode("system Second\n\tremove trade\n\ttrade Relics 700"), planets);
+			economy.Update(systems, commodities);
+			THEN( "the supply of what is still traded is kept" ) {
+				CHECK( economy.Supply(*first, "Food") == 20000. );
+				CHECK( economy.Price(*second, "Food") == 0 );
+				CHECK( economy.Price(*second, "Relics") == 700 );
+			}
+		}
+	}
+	WHEN( "a system does not trade in a commodity" ) {
+		economy.SetSupply(*second, "Relics", 1000.);
+		THEN( "its supply cannot be set" ) {
+			CHECK( economy.Supply(*second, "Relics") == 0. );
+		}
+	}
+}
+
+SCENARIO( "Stepping the economy", "[Economy]" ) {
+	Set<Planet> planets;
+	Set<System> systems;
+	MakeGalaxy(systems, planets, 5, 4, 3);
+	const auto commodities = MakeCommodities(3);
+
+	Economy economy;
+	economy.Update(systems, commodities);
+	MapEconomy reference(systems, commodities);
+
+	GIVEN( "the same random numbers" ) {
+		const uint64_t seed = 1234567;
+		Random::Seed(seed);
+		for(int day = 0; day < 20; ++day)
+			economy.Step();
+		Random::Seed(seed);
+		for(int day = 0; day < 20; ++day)
+			reference.Step();
+
+		THEN( "the supply matches looking up each system and commodity by name" ) {
+			for(const auto &it : systems)
+				for(const Trade::Commodity &commodity : commodities)
+					CHECK_THAT( economy.Supply(it.second, commodity.name),
+						Catch::Matchers::WithinAbs(reference.Supply(it.second, commodity.name), 1e-6) );
+		}
+	}
+}
+// #endregion unit tests
+
+// #region benchmarks
+#ifdef CATCH_CONFIG_ENABLE_BENCHMARKING
+TEST_CASE( "Benchmark a day of the galaxy's economy", "[!benchmark][Economy]" ) {
+	const auto commodities = MakeCommodities(10);
+	// About as many systems as the base game has, and a galaxy ten times that size.
+	Set<Planet> planets;
+	Set<System> galaxy;
+	MakeGalaxy(galaxy, planets, 32, 32, 10);
+	Set<System> largeGalaxy;
+	MakeGalaxy(largeGalaxy, planets, 100, 100, 10);
+
+	Economy economy;
+	economy.Update(galaxy, commodities);
+	Economy largeEconomy;
+	largeEconomy.Update(largeGalaxy, commodities);
+	MapEconomy reference(galaxy, commodities);
+
+	BENCHMARK( "Economy::Step(), 1024 systems" ) {
+		economy.Step();
+	};
+	BENCHMARK( "Lookup by name, 1024 systems" ) {
+		reference.Step();
+	};
+	BENCHMARK( "Economy::Step(), 10000 systems" ) {
+		largeEconomy.Step();
+	};
+	BENCHMARK( "Economy::Update(), 10000 systems" ) {
+		largeEconomy.Update(largeGalaxy, commodities);
+	};
+}
+#endif
+// #endregion benchmarks
+
+
+
+} // test namespace
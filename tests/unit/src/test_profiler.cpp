@@ -0,0 +1,108 @@
+/* test_profiler.cpp
+Copyright (c) 2026 by the Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "es-test.hpp"
+
+// Include only the tested class's header.
+#include "../../../source/Profiler.h"
+
+// ... and any system includes needed for the test file.
+#include <cstddef>
+#include <string>
+
+namespace { // test namespace
+
+// #region mock data
+
+// Record the given number of steps, each of which spends some time in the AI zone.
+void RecordSteps(Profiler &profiler, int count)
+{
+	for(int i = 0; i < count; ++i)
+	{
+		profiler.BeginStep();
+		{
+			Profiler::Scope scope(profiler, Profiler::Zone::AI);
+		}
+		profiler.EndStep();
+	}
+}
+
+// Count how many times the given text appears in a string.
+std::size_t Count(const std::string &text, const std::string &pattern)
+{
+	std::size_t count = 0;
+	for(std::size_t pos = text.find(pattern); pos != std::string::npos; pos = text.find(pattern, pos + 1))
+		++count;
+	return count;
+}
+
+// #endregion mock data
+
+
+
+// #region unit tests
+SCENARIO( "Profiling the steps of the engine", "[Profiler]" ) {
+	GIVEN( "a new profiler" ) {
+		Profiler profiler;
+		THEN( "nothing has been recorded" ) {
+			CHECK( profiler.Steps() == 0 );
+			CHECK( profiler.Time() == 0. );
+			CHECK( profiler.Time(Profiler::Zone::AI) == 0. );
+			CHECK( profiler.Recent().average == 0. );
+			CHECK( Count(profiler.Trace(), "\"ph\":\"X\"") == 0 );
+		}
+	}
+	GIVEN( "a profiler that has recorded a few steps" ) {
+		Profiler profiler;
+		RecordSteps(profiler, 10);
+		THEN( "the steps and the time in each zone are counted" ) {
+			CHECK( profiler.Steps() == 10 );
+			CHECK( profiler.Time(Profiler::Zone::AI) <= profiler.Time() );
+			CHECK( profiler.Time(Profiler::Zone::DRAW) == 0. );
+		}
+		THEN( "the percentiles are in order" ) {
+			Profiler::Stats stats = profiler.Recent();
+			CHECK( stats.median <= stats.p95 );
+			CHECK( stats.p95 <= stats.p99 );
+			CHECK( profiler.Recent(Profiler::Zone::AI).p99 <= stats.p99 );
+		}
+		THEN( "the trace has an event for each step and each zone" ) {
+			const std::string trace = profiler.Trace();
+			CHECK( Count(trace, "\"name\":\"step\"") == 10 );
+			CHECK( Count(trace, "\"name\":\"AI\"") == 10 );
+		}
+		WHEN( "it is reset" ) {
+			profiler.Reset();
+			THEN( "everything it recorded is discarded" ) {
+				CHECK( profiler.Steps() == 0 );
+				CHECK( profiler.Time() == 0. );
+				CHECK( Count(profiler.Trace(), "\"ph\":\"X\"") == 0 );
+			}
+		}
+	}
+	GIVEN( "a profiler that has recorded more steps than its history holds" ) {
+		Profiler profiler;
+		RecordSteps(profiler, Profiler::HISTORY_SIZE + 100);
+		THEN( "all the steps are counted, but only the most recent ones are traced" ) {
+			CHECK( profiler.Steps() == static_cast<int>(Profiler::HISTORY_SIZE + 100) );
+			CHECK( Count(profiler.Trace(), "\"name\":\"step\"") == Profiler::HISTORY_SIZE );
+		}
+	}
+}
+// #endregion unit tests
+
+
+
+} // test namespace
@@ -19,6 +19,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "../../../source/Random.h"
 
 // ... and any system includes needed for the test file.
+#include <thread>
 
 namespace { // test namespace
 
@@ -31,6 +32,33 @@ namespace { // test namespace
 TEST_CASE( "Random::Int", "[random][int]") {
 	REQUIRE( Random::Int(1) == 0 );
 }
+
+SCENARIO( "Seeding the random number generator", "[random][seed]" ) {
+	GIVEN( "a seed" ) {
+		const uint64_t seed = 123456789;
+		WHEN( "the generator is seeded with it twice" ) {
+			Random::Seed(seed);
+			// Normally distributed numbers are generated in pairs, so this
+			// leaves one over.
+			const double first = Random::Normal();
+			const uint32_t second = Random::Int();
+			Random::Seed(seed);
+			THEN( "it produces the same numbers" ) {
+				CHECK( Random::Normal() == first );
+				CHECK( Random::Int() == second );
+			}
+		}
+		WHEN( "another thread seeds its generator in between" ) {
+			Random::Seed(seed);
+			const uint32_t first = Random::Int();
+			Random::Seed(seed);
+			std::thread([] { Random::Seed(987654321); Random::Int(); }).join();
+			THEN( "this thread's numbers are not affected" ) {
+				CHECK( Random::Int() == first );
+			}
+		}
+	}
+}
 // Test code goes here. Preferably, use scenario-driven language making use of the SCENARIO, GIVEN,
 // WHEN, and THEN macros. (There will be cases where the more traditional TEST_CASE and SECTION macros
 // are better suited to declaration of the public API.)
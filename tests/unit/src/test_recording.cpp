@@ -0,0 +1,137 @@
+/* test_recording.cpp
+Copyright (c) 2026 by the Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "es-test.hpp"
+
+// Include only the tested class's header.
+#include "../../../source/Recording.h"
+
+// Include a helper for capturing & asserting on logged output.
+#include "output-capture.hpp"
+
+// ... and any system includes needed for the test file.
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+namespace { // test namespace
+
+// #region mock data
+
+// Get the input of a step in which the flagship turned toward the mouse.
+Recording::Input MouseInput(double x)
+{
+	Recording::Input input;
+	input.command = Command::PRIMARY | Command::MOUSE_TURNING_HOLD;
+	input.mouse = Point(x, -x);
+	return input;
+}
+
+// #endregion mock data
+
+
+
+// #region unit tests
+SCENARIO( "Saving and loading a recorded flight", "[Recording]" ) {
+	const std::string path = (std::filesystem::temp_directory_path() / "es-test-recording.bin").string();
+	GIVEN( "a recording of several steps" ) {
+		Recording recording;
+		recording.SetFirstStep(1234);
+		Recording::Input held;
+		held.hasKeys = true;
+		held.keys = Command::FORWARD | Command::SHIFT;
+		held.command = Command::FORWARD;
+		held.command.SetTurn(-.25);
+		for(uint32_t i = 0; i < 100; ++i)
+			recording.Add(held, i);
+		recording.Add(MouseInput(12.5), 100);
+		recording.Add(MouseInput(-3.), 101);
+		recording.Add(Recording::Input(), 102);
+		recording.Save(path);
+
+		WHEN( "it is loaded again" ) {
+			Recording loaded;
+			REQUIRE( loaded.Load(path) );
+			THEN( "every step has the same input and hash" ) {
+				CHECK( loaded.FirstStep() == 1234 );
+				REQUIRE( loaded.Steps() == 103 );
+				for(uint32_t i = 0; i < loaded.Steps(); ++i)
+					CHECK( loaded.Hash(i) == i );
+				const Recording::Input &first = loaded.GetInput(0);
+				CHECK( first.hasKeys );
+				CHECK( first.keys.Has(Command::SHIFT) );
+				CHECK( first.command.Has(Command::FORWARD) );
+				CHECK_FALSE( first.command.Has(Command::BACK) );
+				CHECK( first.command.Turn() == -.25 );
+				CHECK( loaded.GetInput(99).command.Turn() == -.25 );
+				const Recording::Input &mouse = loaded.GetInput(101);
+				CHECK_FALSE( mouse.hasKeys );
+				CHECK( mouse.command.Has(Command::MOUSE_TURNING_HOLD) );
+				CHECK( mouse.mouse.X() == -3. );
+				CHECK( mouse.mouse.Y() == 3. );
+				CHECK_FALSE( loaded.GetInput(102).command );
+			}
+		}
+		THEN( "identical steps are only stored once" ) {
+			CHECK( std::filesystem::file_size(path) < 100 * sizeof(uint64_t) );
+		}
+	}
+	GIVEN( "a file that is not a recording" ) {
+		{
+			std::ofstream out(path, std::ios::binary | std::ios::trunc);
+			out << "pilot Bobbi Bughunter\n";
+		}
+		OutputSink errors(std::cerr);
+		Recording recording;
+		THEN( "it is not loaded" ) {
+			CHECK_FALSE( recording.Load(path) );
+			CHECK( recording.Steps() == 0 );
+			CHECK_FALSE( errors.Flush().empty() );
+		}
+	}
+	GIVEN( "a recording that claims to have far more steps than it holds" ) {
+		// The step count is the last thing in the file of an empty recording.
+		Recording().Save(path);
+		std::string data;
+		{
+			std::ifstream in(path, std::ios::binary);
+			data.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+		}
+		REQUIRE( data.size() >= sizeof(uint64_t) );
+		data.replace(data.size() - sizeof(uint64_t), sizeof(uint64_t), sizeof(uint64_t), '\xFF');
+		// Add a single run of input that claims to last for billions of steps.
+		data.append(sizeof(uint32_t), '\xFF');
+		data.append(64, '\0');
+		{
+			std::ofstream out(path, std::ios::binary | std::ios::trunc);
+			out << data;
+		}
+		OutputSink errors(std::cerr);
+		Recording recording;
+		THEN( "it is not loaded" ) {
+			CHECK_FALSE( recording.Load(path) );
+			CHECK( recording.Steps() == 0 );
+			CHECK_FALSE( errors.Flush().empty() );
+		}
+	}
+	std::filesystem::remove(path);
+}
+// #endregion unit tests
+
+
+
+} // test namespace
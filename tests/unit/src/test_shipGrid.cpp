@@ -0,0 +1,110 @@
+/* test_shipGrid.cpp
+Copyright (c) 2026 by the Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "es-test.hpp"
+
+// Include only the tested class's header.
+#include "../../../source/ShipGrid.h"
+
+// Include the classes the grid works with.
+#include "../../../source/Point.h"
+#include "../../../source/Ship.h"
+
+// ... and any system includes needed for the test file.
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <vector>
+
+namespace { // test namespace
+
+// #region mock data
+
+// Create ships at the given positions, and a list of pointers to them.
+struct Fleet {
+	explicit Fleet(const std::vector<Point> &positions)
+	{
+		for(const Point &position : positions)
+		{
+			owned.emplace_back(std::make_shared<Ship>());
+			owned.back()->Place(position);
+			ships.push_back(owned.back().get());
+		}
+	}
+
+	std::vector<std::shared_ptr<Ship>> owned;
+	std::vector<Ship *> ships;
+};
+
+// #endregion mock data
+
+
+
+// #region unit tests
+SCENARIO( "Searching a ShipGrid for nearby ships", "[ShipGrid]" ) {
+	GIVEN( "an empty grid" ) {
+		ShipGrid grid;
+		THEN( "queries find nothing" ) {
+			std::vector<Ship *> result;
+			grid.Query(Point(), 1000., result);
+			CHECK( grid.IsEmpty() );
+			CHECK( result.empty() );
+		}
+	}
+	GIVEN( "ships spread across many cells" ) {
+		std::vector<Point> positions;
+		for(int y = -10; y <= 10; ++y)
+			for(int x = -10; x <= 10; ++x)
+				positions.emplace_back(x * 777. + y * 13., y * 555. - x * 17.);
+		Fleet fleet(positions);
+		ShipGrid grid;
+		grid.Build(fleet.ships);
+		REQUIRE_FALSE( grid.IsEmpty() );
+
+		WHEN( "a limited range is searched" ) {
+			const Point center(1234., -2345.);
+			const double range = 1500.;
+			std::vector<Ship *> result;
+			grid.Query(center, range, result);
+			THEN( "every ship in range is found" ) {
+				for(Ship *ship : fleet.ships)
+					if(ship->Position().Distance(center) < range)
+						CHECK( std::find(result.begin(), result.end(), ship) != result.end() );
+			}
+			THEN( "distant ships are not returned" ) {
+				CHECK( result.size() < fleet.ships.size() / 4 );
+			}
+			THEN( "the ships are in the order the grid was built from" ) {
+				auto index = [&fleet](const Ship *ship) {
+					return std::find(fleet.ships.begin(), fleet.ships.end(), ship) - fleet.ships.begin();
+				};
+				auto isBefore = [&index](const Ship *a, const Ship *b) { return index(a) < index(b); };
+				CHECK( std::is_sorted(result.begin(), result.end(), isBefore) );
+			}
+		}
+		WHEN( "an unlimited range is searched" ) {
+			std::vector<Ship *> result;
+			grid.Query(Point(), std::numeric_limits<double>::infinity(), result);
+			THEN( "every ship is returned in order" ) {
+				CHECK( result == fleet.ships );
+			}
+		}
+	}
+}
+// #endregion unit tests
+
+
+
+} // test namespace